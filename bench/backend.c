@@ -0,0 +1,221 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Stand-ins for the few backend functions the kernels call, so they can run
+ * outside of the server: allocations go to malloc (and are counted) and errors
+ * are printed before aborting, since nothing benchmarked should raise them.
+ */
+
+#include <postgres.h>
+#include <miscadmin.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "harness.h"
+#include "stat.h"
+
+MemoryContext CurrentMemoryContext = NULL;
+
+int64_t		bench_allocations = 0;
+
+static int	error_level;
+
+static void *
+allocate(Size size, bool zero)
+{
+	void	   *pointer = zero ? calloc(1, Max(size, 1)) : malloc(Max(size, 1));
+
+	if (pointer == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		abort();
+	}
+	bench_allocations++;
+	return pointer;
+}
+
+void *
+palloc(Size size)
+{
+	return allocate(size, false);
+}
+
+void *
+palloc0(Size size)
+{
+	return allocate(size, true);
+}
+
+void *
+palloc_extended(Size size, int flags)
+{
+	return allocate(size, flags & MCXT_ALLOC_ZERO);
+}
+
+void *
+MemoryContextAlloc(MemoryContext context, Size size)
+{
+	return allocate(size, false);
+}
+
+void *
+repalloc(void *pointer, Size size)
+{
+	pointer = realloc(pointer, Max(size, 1));
+	if (pointer == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		abort();
+	}
+	bench_allocations++;
+	return pointer;
+}
+
+void *
+repalloc_huge(void *pointer, Size size)
+{
+	return repalloc(pointer, size);
+}
+
+void
+pfree(void *pointer)
+{
+	free(pointer);
+}
+
+/* ereport(), reduced to printing the message */
+
+#if POSTGRESQL_VERSION_MAJOR >= 13
+bool
+errstart(int elevel, const char *domain)
+{
+	error_level = elevel;
+	return elevel >= WARNING;
+}
+
+#if POSTGRESQL_VERSION_MAJOR >= 14
+bool
+errstart_cold(int elevel, const char *domain)
+{
+	return errstart(elevel, domain);
+}
+#endif
+
+void
+errfinish(const char *filename, int lineno, const char *funcname)
+{
+	fprintf(stderr, "  at %s:%d (%s)\n", filename, lineno, funcname);
+	if (error_level >= ERROR)
+		abort();
+}
+#else
+bool
+errstart(int elevel, const char *filename, int lineno,
+		 const char *funcname, const char *domain)
+{
+	error_level = elevel;
+	if (elevel >= WARNING)
+		fprintf(stderr, "  at %s:%d (%s)\n", filename, lineno, funcname);
+	return elevel >= WARNING;
+}
+
+void
+errfinish(int dummy,...)
+{
+	if (error_level >= ERROR)
+		abort();
+}
+#endif
+
+int
+errcode(int sqlerrcode)
+{
+	return 0;
+}
+
+static void
+print(const char *label, const char *fmt, va_list args)
+{
+	fprintf(stderr, "%s: ", label);
+	vfprintf(stderr, fmt, args);
+	fputc('\n', stderr);
+}
+
+int
+errmsg(const char *fmt,...)
+{
+	va_list		args;
+
+	va_start(args, fmt);
+	print(error_level >= ERROR ? "ERROR" : "WARNING", fmt, args);
+	va_end(args);
+	return 0;
+}
+
+int
+errmsg_internal(const char *fmt,...)
+{
+	va_list		args;
+
+	va_start(args, fmt);
+	print(error_level >= ERROR ? "ERROR" : "WARNING", fmt, args);
+	va_end(args);
+	return 0;
+}
+
+int
+errdetail(const char *fmt,...)
+{
+	va_list		args;
+
+	va_start(args, fmt);
+	print("DETAIL", fmt, args);
+	va_end(args);
+	return 0;
+}
+
+int
+errhint(const char *fmt,...)
+{
+	va_list		args;
+
+	va_start(args, fmt);
+	print("HINT", fmt, args);
+	va_end(args);
+	return 0;
+}
+
+/* functions are never tracked outside of the server */
+Datum
+stat_call(H3StatFunction function, PGFunction body, FunctionCallInfo fcinfo)
+{
+	return body(fcinfo);
+}
+
+Datum
+stat_time(H3StatFunction function, PGFunction body, FunctionCallInfo fcinfo)
+{
+	return body(fcinfo);
+}
+
+/* benchmarked input is never nested deep enough to matter */
+void
+check_stack_depth(void)
+{
+}
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Kernels of the h3 extension. The operator and sort support kernels are
+ * static, so their translation units are included whole.
+ */
+
+#include "operators.c"
+#include "opclass_btree.c"
+
+#include "cell_range.h"
+#include "harness.h"
+#include "hex.h"
+#include "iterator.h"
+
+/* number of input cells, a power of two */
+#define NUM_CELLS 4096
+#define CELL(cells, i) ((cells)[(i) & (NUM_CELLS - 1)])
+
+static H3Index cells[NUM_CELLS];
+static H3Index ancestors[NUM_CELLS];
+static char strings[NUM_CELLS][H3_HEX_MAX_LENGTH + 1];
+
+static void
+setup_cells(void)
+{
+	static bool done = false;
+
+	if (done)
+		return;
+	bench_random_cells(cells, NUM_CELLS, 9);
+	for (int i = 0; i < NUM_CELLS; i++)
+	{
+		h3_assert(cellToParent(cells[i], 5, &ancestors[i]));
+		h3_to_hex(cells[i], strings[i]);
+	}
+	done = true;
+}
+
+/* operators */
+
+static void
+bench_containment_same_resolution(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += containment(CELL(cells, i), CELL(cells, i + 1));
+}
+
+static void
+bench_containment_ancestor(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += containment(CELL(ancestors, i), CELL(cells, i));
+}
+
+static void
+bench_cell_range_contains(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += cell_range_contains(CELL(ancestors, i), CELL(cells, i));
+}
+
+/* sort support, as called by tuplesort */
+
+static void
+bench_cmp_full(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += h3index_cmp_full(H3IndexGetDatum(CELL(cells, i)),
+									H3IndexGetDatum(CELL(cells, i + 1)), NULL);
+}
+
+static void
+bench_cmp_abbrev(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += h3index_cmp_abbrev(H3IndexGetDatum(CELL(cells, i)),
+									  H3IndexGetDatum(CELL(cells, i + 1)), NULL);
+}
+
+static void
+bench_abbrev_convert(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += h3index_abbrev_convert(H3IndexGetDatum(CELL(cells, i)), NULL);
+}
+
+static void
+bench_hierarchy_cmp_full(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += h3index_hierarchy_cmp_full(H3IndexGetDatum(CELL(cells, i)),
+											  H3IndexGetDatum(CELL(cells, i + 1)), NULL);
+}
+
+static void
+bench_hierarchy_abbrev_convert(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += h3index_hierarchy_abbrev_convert(H3IndexGetDatum(CELL(cells, i)), NULL);
+}
+
+/* text input and output, next to the h3 library functions they replace */
+
+static void
+bench_hex_to_h3(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+	{
+		H3Index		cell;
+
+		hex_to_h3(CELL(strings, i), &cell);
+		b->sink += cell;
+	}
+}
+
+static void
+bench_string_to_h3(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+	{
+		H3Index		cell;
+
+		stringToH3(CELL(strings, i), &cell);
+		b->sink += cell;
+	}
+}
+
+static void
+bench_h3_to_hex(Bench * b)
+{
+	char		string[H3_HEX_MAX_LENGTH + 1];
+
+	setup_cells();
+	BENCH_LOOP(b, i)
+		b->sink += h3_to_hex(CELL(cells, i), string);
+}
+
+static void
+bench_h3_to_string(Bench * b)
+{
+	char		string[H3_HEX_MAX_LENGTH + 1];
+
+	setup_cells();
+	BENCH_LOOP(b, i)
+	{
+		h3ToString(CELL(cells, i), string, sizeof(string));
+		b->sink += string[0];
+	}
+}
+
+/* set returning functions, one call producing all rows */
+
+static void
+bench_children(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+	{
+		H3ChildIterator it;
+
+		for (iterator_children_init(&it, CELL(ancestors, i), 9);
+			 it.cell;
+			 iterator_children_step(&it))
+			b->sink += it.cell;
+	}
+}
+
+static void
+bench_disk(Bench * b)
+{
+	setup_cells();
+	BENCH_LOOP(b, i)
+	{
+		H3DiskIterator it;
+		H3Index		cell;
+		int			distance;
+
+		iterator_disk_init(&it, CELL(cells, i), 10);
+		while (iterator_disk_next(&it, &cell, &distance))
+			b->sink += cell;
+		pfree(it.ring);
+		if (it.inner)
+			pfree(it.inner);
+	}
+}
+
+/* a square of side degrees with its south west corner at (lat, lng) */
+static GeoPolygon
+square(double lat, double lng, double side)
+{
+	static LatLng verts[4];
+	GeoPolygon	polygon = {.geoloop = {.numVerts = 4,.verts = verts}};
+
+	verts[0] = (LatLng) {degsToRads(lat), degsToRads(lng)};
+	verts[1] = (LatLng) {degsToRads(lat), degsToRads(lng + side)};
+	verts[2] = (LatLng) {degsToRads(lat + side), degsToRads(lng + side)};
+	verts[3] = (LatLng) {degsToRads(lat + side), degsToRads(lng)};
+	return polygon;
+}
+
+static void
+polygon_to_cells(Bench * b, const GeoPolygon *polygon, int resolution, int64_t chunkSize)
+{
+	BENCH_LOOP(b, i)
+	{
+		H3PolygonIterator it;
+		H3Index		cell;
+
+		iterator_polygon_init(&it, polygon, resolution, 0, false, chunkSize);
+		while (iterator_polygon_next(&it, &cell))
+			b->sink += cell;
+		if (it.cells)
+			pfree(it.cells);
+	}
+}
+
+static void
+bench_polygon(Bench * b)
+{
+	GeoPolygon	polygon = square(55.6, 12.5, 0.05);
+
+	polygon_to_cells(b, &polygon, 9, POLYGON_TO_CELLS_CHUNK_SIZE);
+}
+
+static void
+bench_polygon_banded(Bench * b)
+{
+	GeoPolygon	polygon = square(55.0, 12.0, 1.0);
+
+	/* over a thousand cells, filled in bands of at most a thousand */
+	polygon_to_cells(b, &polygon, 7, 1000);
+}
+
+const BenchCase bench_h3_cases[] = {
+	{"containment/same_resolution", bench_containment_same_resolution},
+	{"containment/ancestor", bench_containment_ancestor},
+	{"cell_range_contains", bench_cell_range_contains},
+	{"sortsupport/cmp_full", bench_cmp_full},
+	{"sortsupport/cmp_abbrev", bench_cmp_abbrev},
+	{"sortsupport/abbrev_convert", bench_abbrev_convert},
+	{"sortsupport/hierarchy_cmp_full", bench_hierarchy_cmp_full},
+	{"sortsupport/hierarchy_abbrev_convert", bench_hierarchy_abbrev_convert},
+	{"text/hex_to_h3", bench_hex_to_h3},
+	{"text/stringToH3", bench_string_to_h3},
+	{"text/h3_to_hex", bench_h3_to_hex},
+	{"text/h3ToString", bench_h3_to_string},
+	{"srf/cell_to_children (res 5 to 9)", bench_children},
+	{"srf/grid_disk (k 10)", bench_disk},
+	{"srf/polygon_to_cells (res 9)", bench_polygon},
+	{"srf/polygon_to_cells banded (res 7)", bench_polygon_banded},
+	{NULL}
+};
@@ -0,0 +1,441 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Kernels of the h3_postgis extension. The antimeridian splitting of cell
+ * boundaries is static, so its translation unit is included whole.
+ */
+
+#include "wkb_indexing.c"
+
+#include "harness.h"
+#include "mvt.h"
+#include "wkb_flat_geo.h"
+
+/* number of input boundaries, a power of two */
+#define NUM_BOUNDARIES 1024
+#define BOUNDARY(boundaries, i) ((boundaries)[(i) & (NUM_BOUNDARIES - 1)])
+
+/* cells anywhere, and cells crossed by the antimeridian once or twice */
+static CellBoundary boundaries[NUM_BOUNDARIES];
+static CellBoundary crossing[NUM_BOUNDARIES];
+static CellBoundary polar[NUM_BOUNDARIES];
+
+/* outlines of disks of cells, one of them crossed by the antimeridian */
+static FlatGeoPolygon outline;
+static FlatGeoPolygon crossingOutline;
+
+/* a region of a million cells across the antimeridian, and its outline */
+#define REGION_K 577
+static H3Index *region;
+static int64_t regionSize;
+static FlatGeoPolygon regionOutline;
+
+static void
+setup_boundaries(void)
+{
+	static bool done = false;
+	H3Index		cells[NUM_BOUNDARIES];
+	int			numCrossing = 0;
+
+	if (done)
+		return;
+
+	bench_random_cells(cells, NUM_BOUNDARIES, 9);
+	for (int i = 0; i < NUM_BOUNDARIES; i++)
+		h3_assert(cellToBoundary(cells[i], &boundaries[i]));
+
+	/* cells on the antimeridian, at the coarser resolutions */
+	while (numCrossing < NUM_BOUNDARIES)
+	{
+		LatLng		point = {
+			.lat = (bench_random() * 2 - 1) * degsToRads(80),
+			.lng = M_PI
+		};
+		H3Index		cell;
+		CellBoundary boundary;
+
+		h3_assert(latLngToCell(&point, numCrossing % 6, &cell));
+		h3_assert(cellToBoundary(cell, &boundary));
+		if (boundary_crosses_180_num(&boundary) == 2)
+			crossing[numCrossing++] = boundary;
+	}
+
+	/* cells around either pole, at every resolution */
+	for (int i = 0; i < NUM_BOUNDARIES; i++)
+	{
+		LatLng		pole = {.lat = (i & 16) ? M_PI_2 : -M_PI_2,.lng = 0};
+		H3Index		cell;
+
+		h3_assert(latLngToCell(&pole, i % 16, &cell));
+		h3_assert(cellToBoundary(cell, &polar[i]));
+	}
+
+	{
+		LatLng		points[2] = {{degsToRads(55.7), degsToRads(12.6)},
+		{degsToRads(64.8), M_PI}};
+		FlatGeoPolygon *outlines[2] = {&outline, &crossingOutline};
+
+		for (int i = 0; i < 2; i++)
+		{
+			H3Index		cell;
+			int64_t		size;
+			H3Index    *disk;
+			LinkedGeoPolygon linked;
+
+			h3_assert(latLngToCell(&points[i], 7, &cell));
+			h3_assert(maxGridDiskSize(10, &size));
+			disk = palloc0(size * sizeof(H3Index));
+			h3_assert(gridDisk(cell, 10, disk));
+
+			/* drop the gaps left by pentagons */
+			for (int64_t j = size - 1; j >= 0; j--)
+				if (disk[j] == H3_NULL)
+					disk[j] = disk[--size];
+			h3_assert(cellsToLinkedMultiPolygon(disk, size, &linked));
+			flat_geo_from_linked(&linked, outlines[i]);
+			destroyLinkedMultiPolygon(&linked);
+			pfree(disk);
+		}
+	}
+
+	done = true;
+}
+
+static void
+bench_crosses_180(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+		b->sink += boundary_crosses_180_num(&BOUNDARY(boundaries, i));
+}
+
+static void
+bench_split_180(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		CellBoundary parts[2];
+
+		boundary_split_180(&BOUNDARY(crossing, i), &parts[0], &parts[1]);
+		b->sink += parts[0].numVerts;
+	}
+}
+
+static void
+bench_split_180_polar(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		CellBoundary split;
+
+		boundary_split_180_polar(&BOUNDARY(polar, i), &split);
+		b->sink += split.numVerts;
+	}
+}
+
+static void
+bench_boundary_to_wkb(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		bytea	   *wkb = boundary_to_wkb(&BOUNDARY(boundaries, i));
+
+		b->sink += VARSIZE(wkb);
+		pfree(wkb);
+	}
+}
+
+static void
+bench_boundary_array_to_wkb(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		CellBoundary parts[2];
+		bytea	   *wkb;
+
+		boundary_split_180(&BOUNDARY(crossing, i), &parts[0], &parts[1]);
+		wkb = boundary_array_to_wkb(parts, 2);
+		b->sink += VARSIZE(wkb);
+		pfree(wkb);
+	}
+}
+
+static void
+bench_split_flat_geo_by_180(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		FlatGeoPolygon split;
+
+		split_flat_geo_by_180(&crossingOutline, &split);
+		b->sink += split.numPolygons;
+		flat_geo_free(&split);
+	}
+}
+
+static void
+bench_flat_geo_polygon_to_wkb(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		bytea	   *wkb = flat_geo_polygon_to_wkb(&outline);
+
+		b->sink += VARSIZE(wkb);
+		pfree(wkb);
+	}
+}
+
+static void
+setup_region(void)
+{
+	LatLng		point = {degsToRads(65), M_PI};
+	H3Index		cell;
+	LinkedGeoPolygon linked;
+
+	if (region != NULL)
+		return;
+
+	h3_assert(latLngToCell(&point, 9, &cell));
+	h3_assert(maxGridDiskSize(REGION_K, &regionSize));
+	region = palloc0(regionSize * sizeof(H3Index));
+	h3_assert(gridDisk(cell, REGION_K, region));
+
+	/* drop the gaps left by pentagons */
+	for (int64_t j = regionSize - 1; j >= 0; j--)
+		if (region[j] == H3_NULL)
+			region[j] = region[--regionSize];
+
+	h3_assert(cellsToLinkedMultiPolygon(region, regionSize, &linked));
+	flat_geo_from_linked(&linked, &regionOutline);
+	destroyLinkedMultiPolygon(&linked);
+}
+
+static void
+bench_dissolve_region(Bench * b)
+{
+	setup_region();
+	BENCH_LOOP(b, i)
+	{
+		bytea	   *wkb = cells_to_multi_polygon_wkb(region, regionSize);
+
+		b->sink += VARSIZE(wkb);
+		pfree(wkb);
+	}
+}
+
+/* the dissolve after the core library has outlined the cells */
+static void
+bench_dissolve_region_outline(Bench * b)
+{
+	setup_region();
+	BENCH_LOOP(b, i)
+	{
+		FlatGeoPolygon split;
+		bytea	   *wkb;
+
+		split_flat_geo_by_180(&regionOutline, &split);
+		flat_geo_to_degs(&split);
+		wkb = flat_geo_polygon_to_wkb(&split);
+		b->sink += VARSIZE(wkb);
+		flat_geo_free(&split);
+		pfree(wkb);
+	}
+}
+
+static void
+bench_boundary_to_gserialized(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		struct varlena *geometry = boundary_array_to_gserialized(&BOUNDARY(boundaries, i), 1, NULL);
+
+		b->sink += VARSIZE(geometry);
+		pfree(geometry);
+	}
+}
+
+static void
+bench_boundary_to_gserialized_geodetic(Bench * b)
+{
+	setup_boundaries();
+	BENCH_LOOP(b, i)
+	{
+		Bbox3		bbox;
+		struct varlena *geography;
+
+		bbox3_from_boundary(&BOUNDARY(boundaries, i), &bbox);
+		geography = boundary_array_to_gserialized(&BOUNDARY(boundaries, i), 1, &bbox);
+		b->sink += VARSIZE(geography);
+		pfree(geography);
+	}
+}
+
+/* a batch of cells, as tiles and exports convert them */
+#define NUM_BATCH 100000
+
+static H3Index *
+setup_batch(void)
+{
+	static H3Index *batch = NULL;
+
+	if (batch == NULL)
+	{
+		batch = palloc(NUM_BATCH * sizeof(H3Index));
+		bench_random_cells(batch, NUM_BATCH, 9);
+	}
+	return batch;
+}
+
+static void
+bench_cell_to_boundary_batch(Bench * b)
+{
+	H3Index    *batch = setup_batch();
+
+	BENCH_LOOP(b, i)
+	{
+		for (int c = 0; c < NUM_BATCH; c++)
+		{
+			CellBoundary parts[2];
+			bool		polar;
+			int			num = cell_to_boundary_parts(batch[c], parts, &polar);
+			struct varlena *geometry;
+
+			for (int p = 0; p < num; p++)
+				boundary_to_degs(&parts[p]);
+			geometry = boundary_array_to_gserialized(parts, num, NULL);
+			b->sink += VARSIZE(geometry);
+			pfree(geometry);
+		}
+	}
+}
+
+static void
+bench_cells_to_boundaries_batch(Bench * b)
+{
+	H3Index    *batch = setup_batch();
+
+	BENCH_LOOP(b, i)
+	{
+		FlatGeoPolygon geo;
+		struct varlena *geometry;
+
+		flat_geo_init(&geo, NUM_BATCH * 6, NUM_BATCH, NUM_BATCH);
+		for (int c = 0; c < NUM_BATCH; c++)
+			flat_geo_add_cell_boundary(&geo, batch[c]);
+		geometry = flat_geo_to_gserialized(&geo);
+		b->sink += VARSIZE(geometry);
+		flat_geo_free(&geo);
+		pfree(geometry);
+	}
+}
+
+/* a disk of cells about the size of a tile at zoom 12, across its edges */
+#define TILE_Z 12
+#define TILE_K 15
+
+static void
+bench_cells_to_mvt(Bench * b)
+{
+	static H3Index *cells = NULL;
+	static int64_t numCells;
+	static int	x;
+	static int	y;
+
+	if (cells == NULL)
+	{
+		LatLng		center = {degsToRads(55.6761), degsToRads(12.5683)};
+		double		n = ldexp(1, TILE_Z);
+		H3Index		cell;
+
+		h3_assert(latLngToCell(&center, 9, &cell));
+		h3_assert(maxGridDiskSize(TILE_K, &numCells));
+		cells = palloc0(numCells * sizeof(H3Index));
+		h3_assert(gridDisk(cell, TILE_K, cells));
+
+		x = (int) ((center.lng / (2 * M_PI) + 0.5) * n);
+		y = (int) ((0.5 - log(tan(M_PI_4 + center.lat / 2)) / (2 * M_PI)) * n);
+	}
+
+	BENCH_LOOP(b, i)
+	{
+		MvtTile		tile;
+		bytea	   *mvt;
+
+		mvt_init(&tile, TILE_Z, x, y, 4096, 256);
+		for (int c = 0; c < numCells; c++)
+		{
+			double		value = c;
+
+			mvt_add_cell(&tile, cells[c], &value);
+		}
+		mvt = mvt_to_bytea(&tile, "h3");
+		b->sink += VARSIZE(mvt);
+		mvt_free(&tile);
+		pfree(mvt);
+	}
+}
+
+static void
+bench_wkb_to_polygons(Bench * b)
+{
+	bytea	   *wkb;
+
+	setup_boundaries();
+	wkb = flat_geo_polygon_to_wkb(&outline);
+	BENCH_LOOP(b, i)
+	{
+		int			num;
+		GeoPolygon *polygons = wkb_to_polygons(wkb, &num);
+
+		for (int j = 0; j < num; j++)
+		{
+			b->sink += polygons[j].geoloop.numVerts;
+			pfree(polygons[j].geoloop.verts);
+			for (int k = 0; k < polygons[j].numHoles; k++)
+				pfree(polygons[j].holes[k].verts);
+			pfree(polygons[j].holes);
+		}
+		pfree(polygons);
+	}
+	pfree(wkb);
+}
+
+const BenchCase bench_h3_postgis_cases[] = {
+	{"boundary/crosses_180_num", bench_crosses_180},
+	{"boundary/split_180", bench_split_180},
+	{"boundary/split_180_polar", bench_split_180_polar},
+	{"wkb/boundary_to_wkb", bench_boundary_to_wkb},
+	{"wkb/boundary_array_to_wkb (split)", bench_boundary_array_to_wkb},
+	{"wkb/split_flat_geo_by_180 (k 10)", bench_split_flat_geo_by_180},
+	{"wkb/flat_geo_polygon_to_wkb (k 10)", bench_flat_geo_polygon_to_wkb},
+	{"wkb/wkb_to_polygons (k 10)", bench_wkb_to_polygons},
+	{"gserialized/boundary_to_geometry", bench_boundary_to_gserialized},
+	{"gserialized/boundary_to_geography", bench_boundary_to_gserialized_geodetic},
+	{"gserialized/cell_to_boundary, one by one (10^5 cells)", bench_cell_to_boundary_batch},
+	{"gserialized/cells_to_boundaries (10^5 cells)", bench_cells_to_boundaries_batch},
+	{"mvt/cells_to_mvt (k 15 disk, z 12 tile)", bench_cells_to_mvt},
+	{"dissolve/cells_to_multi_polygon_wkb (10^6 cells, antimeridian)", bench_dissolve_region},
+	{"dissolve/split and write outline (10^6 cells, antimeridian)", bench_dissolve_region_outline},
+	{NULL}
+};
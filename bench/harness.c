@@ -0,0 +1,211 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <h3api.h>
+
+#include <math.h>	// asin
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>	// clock_gettime
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "harness.h"
+
+/* shortest run that is timed, in nanoseconds */
+#define BENCH_MIN_TIME 200000000
+#define BENCH_MAX_ITERATIONS 1000000000
+
+static uint64_t random_state = 0x9E3779B97F4A7C15;
+
+double
+bench_random(void)
+{
+	/* xorshift64* */
+	random_state ^= random_state >> 12;
+	random_state ^= random_state << 25;
+	random_state ^= random_state >> 27;
+	return (random_state * 0x2545F4914F6CDD1DULL >> 11) * 0x1.0p-53;
+}
+
+void
+bench_random_cells(H3Index * cells, int count, int resolution)
+{
+	for (int i = 0; i < count; i++)
+	{
+		/* uniform over the sphere, not over latitude */
+		LatLng		point = {
+			.lat = asin(bench_random() * 2 - 1),
+			.lng = (bench_random() * 2 - 1) * M_PI
+		};
+
+		if (latLngToCell(&point, resolution, &cells[i]))
+		{
+			fprintf(stderr, "could not index random point\n");
+			exit(1);
+		}
+	}
+}
+
+static int64_t
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* hardware cache miss counter of this thread, or -1 if unavailable */
+static int
+cache_misses_open(void)
+{
+#ifdef __linux__
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	return -1;
+#endif
+}
+
+static void
+cache_misses_start(int fd)
+{
+#ifdef __linux__
+	if (fd < 0)
+		return;
+	ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+	ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+static int64_t
+cache_misses_stop(int fd)
+{
+#ifdef __linux__
+	int64_t		count;
+
+	if (fd < 0)
+		return -1;
+	ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+	if (read(fd, &count, sizeof(count)) != sizeof(count))
+		return -1;
+	return count;
+#else
+	return -1;
+#endif
+}
+
+static bool
+matches(const char *name, int argc, char **argv)
+{
+	if (argc < 2)
+		return true;
+	for (int i = 1; i < argc; i++)
+		if (strstr(name, argv[i]))
+			return true;
+	return false;
+}
+
+static void
+run(const BenchCase * c, int fd)
+{
+	Bench		b = {.iterations = 0};
+	int64_t		elapsed;
+	int64_t		allocations;
+	int64_t		misses;
+
+	/* an untimed run without iterations lets the benchmark set up its input */
+	c->func(&b);
+	b.iterations = 1;
+
+	for (;;)
+	{
+		int64_t		start;
+
+		allocations = bench_allocations;
+		cache_misses_start(fd);
+		start = now();
+		c->func(&b);
+		elapsed = now() - start;
+		misses = cache_misses_stop(fd);
+		allocations = bench_allocations - allocations;
+
+		if (elapsed >= BENCH_MIN_TIME || b.iterations >= BENCH_MAX_ITERATIONS)
+			break;
+
+		/* aim past the minimum, growing at most a hundredfold per step */
+		if (elapsed <= 0)
+			b.iterations *= 100;
+		else
+		{
+			double		scale = 1.2 * BENCH_MIN_TIME / elapsed;
+
+			b.iterations = (int64_t) (b.iterations * (scale < 100 ? scale : 100)) + 1;
+		}
+	}
+
+	printf("%-48s %12lld %12.1f %12.2f ",
+		   c->name, (long long) b.iterations,
+		   (double) elapsed / b.iterations,
+		   (double) allocations / b.iterations);
+	if (misses < 0)
+		printf("%12s\n", "-");
+	else
+		printf("%12.2f\n", (double) misses / b.iterations);
+
+	/* keep the results alive */
+	if (b.sink == 0x5eed)
+		fputc('\n', stderr);
+}
+
+/*
+ * Runs every benchmark whose name contains one of the arguments, or all of
+ * them without arguments.
+ */
+int
+main(int argc, char **argv)
+{
+	const BenchCase *suites[] = {bench_h3_cases, bench_h3_postgis_cases};
+	int			fd = cache_misses_open();
+
+	printf("%-48s %12s %12s %12s %12s\n",
+		   "benchmark", "iterations", "ns/op", "allocs/op", "misses/op");
+
+	for (int s = 0; s < sizeof(suites) / sizeof(suites[0]); s++)
+		for (const BenchCase * c = suites[s]; c->name; c++)
+			if (matches(c->name, argc, argv))
+				run(c, fd);
+
+	if (fd >= 0)
+		close(fd);
+	return 0;
+}
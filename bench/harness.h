@@ -0,0 +1,63 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_BENCH_HARNESS_H
+#define H3_BENCH_HARNESS_H
+
+#include <h3api.h>
+
+#include <stdint.h>
+
+/*
+ * Microbenchmarks of the C kernels behind the SQL functions and operator
+ * classes, run outside of the server. Every benchmark repeats its operation
+ * b->iterations times, and the harness grows the count until a run takes long
+ * enough to time, then reports nanoseconds, backend allocations and cache
+ * misses per operation. Benchmarks are first called with zero iterations,
+ * which is the place to prepare their input.
+ */
+
+typedef struct
+{
+	int64_t		iterations;
+	uint64_t	sink;			/* fold results in, so they are not optimized
+								 * away */
+}	Bench;
+
+typedef void (*BenchFunc) (Bench * b);
+
+typedef struct
+{
+	const char *name;
+	BenchFunc	func;
+}	BenchCase;
+
+/* suites, terminated by an entry without name */
+extern const BenchCase bench_h3_cases[];
+extern const BenchCase bench_h3_postgis_cases[];
+
+/* allocations made through palloc and friends, counted by backend.c */
+extern int64_t bench_allocations;
+
+/* deterministic pseudo random numbers, in [0, 1) */
+double		bench_random(void);
+
+/* cells spread over the globe, the same for every run */
+void		bench_random_cells(H3Index * cells, int count, int resolution);
+
+#define BENCH_LOOP(b, i) for (int64_t i = 0; i < (b)->iterations; i++)
+
+#endif							/* H3_BENCH_HARNESS_H */
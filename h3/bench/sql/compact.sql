@@ -0,0 +1,49 @@
+--
+-- Compacting a table: h3_compact_cells over array_agg versus h3_compact_agg
+--
+-- Reports the time to compact the same cells collected into one array, with
+-- the aggregate in a single process, and with the aggregate in parallel.
+-- Run against a scratch database with the extension available:
+--
+--   psql -v rows=100000000 -f h3/bench/sql/compact.sql
+--
+\set ON_ERROR_STOP on
+\if :{?rows}
+\else
+\set rows 1000000
+\endif
+\if :{?resolution}
+\else
+\set resolution 9
+\endif
+
+CREATE EXTENSION IF NOT EXISTS h3;
+
+DROP TABLE IF EXISTS h3_bench_compact;
+SELECT setseed(0.42);
+CREATE TABLE h3_bench_compact AS
+    SELECT DISTINCT h3_latlng_to_cell(
+        POINT(random() * 10, random() * 10),
+        :resolution
+    ) AS hex
+    FROM generate_series(1, :rows) i;
+VACUUM ANALYZE h3_bench_compact;
+
+\timing on
+
+-- one array
+SELECT count(*) FROM h3_compact_cells(ARRAY(SELECT hex FROM h3_bench_compact));
+
+-- aggregate, single process
+SET max_parallel_workers_per_gather = 0;
+SELECT cardinality(h3_compact_agg(hex)) FROM h3_bench_compact;
+
+-- aggregate, parallel
+RESET max_parallel_workers_per_gather;
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SELECT cardinality(h3_compact_agg(hex)) FROM h3_bench_compact;
+
+\timing off
+
+DROP TABLE h3_bench_compact;
@@ -0,0 +1,80 @@
+--
+-- Batch versus per-row indexing of locations, centroids and boundaries
+--
+-- Reports the time to index the same locations one row at a time, and in
+-- arrays of batch_size locations per call, and likewise for finding the
+-- centroids and boundaries of the resulting cells.
+-- Run against a scratch database with the extension available:
+--
+--   psql -v rows=10000000 -v batch_size=10000 -f h3/bench/sql/indexing.sql
+--
+\set ON_ERROR_STOP on
+\if :{?rows}
+\else
+\set rows 1000000
+\endif
+\if :{?batch_size}
+\else
+\set batch_size 1000
+\endif
+\if :{?resolution}
+\else
+\set resolution 9
+\endif
+
+CREATE EXTENSION IF NOT EXISTS h3;
+
+DROP TABLE IF EXISTS h3_bench_indexing;
+SELECT setseed(0.42);
+CREATE TABLE h3_bench_indexing AS
+    SELECT
+        i / :batch_size AS batch,
+        degrees(asin(random() * 2 - 1)) AS lat,
+        random() * 360 - 180 AS lng
+    FROM generate_series(0, :rows - 1) i;
+VACUUM ANALYZE h3_bench_indexing;
+
+DROP TABLE IF EXISTS h3_bench_indexing_batches;
+CREATE TABLE h3_bench_indexing_batches AS
+    SELECT
+        batch,
+        array_agg(POINT(lng, lat)) AS latlngs,
+        array_agg(lat) AS lats,
+        array_agg(lng) AS lngs
+    FROM h3_bench_indexing GROUP BY batch;
+VACUUM ANALYZE h3_bench_indexing_batches;
+
+\timing on
+
+-- per row
+SELECT count(h3_latlng_to_cell(POINT(lng, lat), :resolution))
+FROM h3_bench_indexing;
+
+-- batched points
+SELECT sum(cardinality(h3_latlng_to_cells(latlngs, :resolution)))
+FROM h3_bench_indexing_batches;
+
+-- batched latitudes and longitudes
+SELECT sum(cardinality(h3_latlng_to_cells(lats, lngs, :resolution)))
+FROM h3_bench_indexing_batches;
+
+-- per row centroids and boundaries
+SELECT count(h3_cell_to_latlng(h3_latlng_to_cell(POINT(lng, lat), :resolution)))
+FROM h3_bench_indexing;
+SELECT count(h3_cell_to_boundary(h3_latlng_to_cell(POINT(lng, lat), :resolution)))
+FROM h3_bench_indexing;
+
+-- batched centroids and boundaries
+SELECT sum(cardinality(h3_cells_to_latlngs(h3_latlng_to_cells(latlngs, :resolution))))
+FROM h3_bench_indexing_batches;
+SELECT sum(cardinality((h3_cells_to_boundaries(h3_latlng_to_cells(latlngs, :resolution))).coords))
+FROM h3_bench_indexing_batches;
+
+\timing off
+
+-- both give the same cells
+SELECT bool_and(h3_latlng_to_cells(latlngs, :resolution) = h3_latlng_to_cells(lats, lngs, :resolution))
+FROM h3_bench_indexing_batches;
+
+DROP TABLE h3_bench_indexing_batches;
+DROP TABLE h3_bench_indexing;
@@ -0,0 +1,70 @@
+--
+-- SP-GiST versus B-tree on mixed-resolution data
+--
+-- Reports index build time, index size and lookup latency.
+-- Run against a scratch database with the extension available:
+--
+--   psql -v rows=100000000 -f h3/bench/sql/opclass_spgist.sql
+--
+\set ON_ERROR_STOP on
+\if :{?rows}
+\else
+\set rows 1000000
+\endif
+
+CREATE EXTENSION IF NOT EXISTS h3;
+
+DROP TABLE IF EXISTS h3_bench_spgist;
+SELECT setseed(0.42);
+CREATE TABLE h3_bench_spgist AS
+    SELECT h3_latlng_to_cell(
+        POINT(random() * 360 - 180, degrees(asin(random() * 2 - 1))),
+        (i % 16)::integer
+    ) AS hex
+    FROM generate_series(1, :rows) i;
+VACUUM ANALYZE h3_bench_spgist;
+
+\set fine '\'8a2a1072b59ffff\'::h3index'
+\set coarse 'h3_cell_to_parent(\'8a2a1072b59ffff\'::h3index, 4)'
+
+--
+-- BUILD
+--
+\timing on
+CREATE INDEX h3_bench_btree_idx ON h3_bench_spgist USING btree(hex);
+CREATE INDEX h3_bench_spgist_idx ON h3_bench_spgist USING spgist(hex);
+\timing off
+
+SELECT
+    pg_size_pretty(pg_relation_size('h3_bench_spgist')) AS "table",
+    pg_size_pretty(pg_relation_size('h3_bench_btree_idx')) AS btree,
+    pg_size_pretty(pg_relation_size('h3_bench_spgist_idx')) AS spgist;
+
+--
+-- LOOKUPS
+--
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+
+-- equality, btree
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF) SELECT count(*) FROM h3_bench_spgist WHERE hex = :fine;
+
+-- equality, spgist
+DROP INDEX h3_bench_btree_idx;
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF) SELECT count(*) FROM h3_bench_spgist WHERE hex = :fine;
+
+-- containment
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF) SELECT count(*) FROM h3_bench_spgist WHERE hex <@ :coarse;
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF) SELECT count(*) FROM h3_bench_spgist WHERE hex @> :fine;
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF) SELECT count(*) FROM h3_bench_spgist WHERE hex && :coarse;
+
+-- nearest neighbours
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF) SELECT hex FROM h3_bench_spgist ORDER BY hex <-> :fine LIMIT 10;
+
+-- containment without index, for reference
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+DROP INDEX h3_bench_spgist_idx;
+EXPLAIN (ANALYZE, BUFFERS, COSTS OFF) SELECT count(*) FROM h3_bench_spgist WHERE hex <@ :coarse;
+
+DROP TABLE h3_bench_spgist;
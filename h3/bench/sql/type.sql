@@ -0,0 +1,78 @@
+--
+-- Text input and output of h3index
+--
+-- Reports the time to COPY the same indexes to and from a text file, and to
+-- convert them to and from text in a query, next to the same values stored as
+-- bigint for reference. Run it against builds before and after a change to
+-- compare their throughput. COPY writes a server side file, so this needs
+-- a superuser (or pg_write_server_files and pg_read_server_files):
+--
+--   psql -v rows=100000000 -v file=/tmp/h3_bench_type.txt -f h3/bench/sql/type.sql
+--
+\set ON_ERROR_STOP on
+\if :{?rows}
+\else
+\set rows 10000000
+\endif
+\if :{?file}
+\else
+\set file /tmp/h3_bench_type.txt
+\endif
+\if :{?resolution}
+\else
+\set resolution 9
+\endif
+
+CREATE EXTENSION IF NOT EXISTS h3;
+
+DROP TABLE IF EXISTS h3_bench_type;
+SELECT setseed(0.42);
+CREATE TABLE h3_bench_type AS
+    SELECT h3_latlng_to_cell(
+        POINT(random() * 360 - 180, degrees(asin(random() * 2 - 1))),
+        :resolution
+    ) AS hex
+    FROM generate_series(1, :rows) i;
+VACUUM ANALYZE h3_bench_type;
+
+DROP TABLE IF EXISTS h3_bench_type_bigint;
+CREATE TABLE h3_bench_type_bigint AS
+    SELECT hex::bigint AS hex FROM h3_bench_type;
+VACUUM ANALYZE h3_bench_type_bigint;
+
+CREATE TEMPORARY TABLE h3_bench_type_in (LIKE h3_bench_type);
+CREATE TEMPORARY TABLE h3_bench_type_bigint_in (LIKE h3_bench_type_bigint);
+
+\timing on
+
+-- COPY TO, leaving the bigint values in the file
+COPY h3_bench_type TO :'file';
+COPY h3_bench_type_bigint TO :'file';
+
+-- COPY FROM
+COPY h3_bench_type_bigint_in FROM :'file';
+\timing off
+COPY h3_bench_type TO :'file';
+\timing on
+COPY h3_bench_type_in FROM :'file';
+
+-- output and input functions alone
+SELECT count(hex::text) FROM h3_bench_type;
+SELECT count(hex::text::h3index) FROM h3_bench_type;
+SELECT count(hex::text::bigint) FROM h3_bench_type_bigint;
+
+-- arrays of indexes
+SELECT count(array_agg::text) FROM (
+    SELECT array_agg(hex) FROM h3_bench_type GROUP BY hex::bigint % 1000
+) q;
+
+\timing off
+
+-- all indexes survive the round trip
+SELECT count(*) = 0 FROM (
+    SELECT hex FROM h3_bench_type
+    EXCEPT ALL SELECT hex FROM h3_bench_type_in
+) q;
+
+DROP TABLE h3_bench_type_bigint;
+DROP TABLE h3_bench_type;
@@ -0,0 +1,28 @@
+\pset tuples_only on
+--
+-- Joining regions to the points they contain
+--
+CALL h3_bench_run('containment/join cell_to_parent',
+    'SELECT count(*) FROM h3_bench_regions r JOIN h3_bench_points p ON h3_cell_to_parent(p.cell, 5) = r.cell');
+
+SET enable_seqscan = off;
+
+CREATE INDEX h3_bench_index ON h3_bench_points USING spgist (cell);
+CALL h3_bench_run('containment/join spgist',
+    'SELECT count(*) FROM h3_bench_regions r JOIN h3_bench_points p ON p.cell <@ r.cell');
+DROP INDEX h3_bench_index;
+
+CREATE INDEX h3_bench_index ON h3_bench_points USING gist (cell);
+CALL h3_bench_run('containment/join gist',
+    'SELECT count(*) FROM h3_bench_regions r JOIN h3_bench_points p ON p.cell <@ r.cell');
+DROP INDEX h3_bench_index;
+
+CREATE INDEX h3_bench_index ON h3_bench_points USING brin (cell h3index_inclusion_ops);
+CALL h3_bench_run('containment/join brin inclusion',
+    'SELECT count(*) FROM h3_bench_regions r JOIN h3_bench_points p ON p.cell <@ r.cell');
+DROP INDEX h3_bench_index;
+
+RESET enable_seqscan;
+
+-- every join finds the same points
+SELECT count(DISTINCT rows) = 1 FROM h3_bench_results WHERE scenario LIKE 'containment/%';
@@ -0,0 +1,78 @@
+\pset tuples_only on
+SELECT scale * 1000000 AS points, scale * 100 AS polygons FROM h3_bench_settings \gset
+\set cities 50
+
+--
+-- Cities, the centers of clusters of points and polygons
+--
+CREATE TABLE h3_bench_cities AS
+    SELECT
+        i AS id,
+        h3_bench_random(i, 1) * 120 - 60 AS lat,
+        h3_bench_random(i, 2) * 360 - 180 AS lng
+    FROM generate_series(1, :cities) i;
+
+--
+-- Points at resolution 9, four in five normally distributed around a city
+-- (spreading some 20 km), the rest uniform over the globe
+--
+CREATE TABLE h3_bench_points AS
+    SELECT id, h3_latlng_to_cell(POINT(lng, lat), 9) AS cell
+    FROM (
+        SELECT
+            i AS id,
+            CASE WHEN i % 5 = 0
+                THEN degrees(asin(2 * u - 1))
+                ELSE c.lat + r * sin(t)
+            END AS lat,
+            CASE WHEN i % 5 = 0
+                THEN 360 * v - 180
+                ELSE c.lng + r * cos(t) / cos(radians(c.lat))
+            END AS lng
+        FROM
+            generate_series(1, :points) i,
+            LATERAL (SELECT h3_bench_random(i, 3) AS u, h3_bench_random(i, 4) AS v) q,
+            LATERAL (SELECT sqrt(-2 * ln(1 - u)) * 0.2 AS r, 2 * pi() * v AS t) g,
+            h3_bench_cities c
+        WHERE c.id = i % :cities + 1
+    ) p;
+
+--
+-- Polygons of 32 vertices around cities, 2 to 20 km across with jagged edges
+--
+CREATE TABLE h3_bench_polygons AS
+    SELECT id, format('(%s)', string_agg(
+        format('(%s,%s)', lng + r * cos(a) / cos(radians(lat)), lat + r * sin(a)),
+        ',' ORDER BY k
+    ))::polygon AS polygon
+    FROM (
+        SELECT
+            i AS id,
+            c.lat + h3_bench_random(i, 5) - 0.5 AS lat,
+            c.lng + h3_bench_random(i, 6) - 0.5 AS lng,
+            (1 + 9 * h3_bench_random(i, 7)) / 111.0 AS radius
+        FROM generate_series(1, :polygons) i, h3_bench_cities c
+        WHERE c.id = i % :cities + 1
+    ) p,
+    LATERAL (
+        SELECT k, 2 * pi() * k / 32 AS a, radius * (0.6 + 0.4 * h3_bench_random(id * 32 + k, 8)) AS r
+        FROM generate_series(0, 31) k
+    ) v
+    GROUP BY id;
+
+--
+-- Resolution 5 regions of the first points, and origins of nearest neighbour
+-- searches
+--
+CREATE TABLE h3_bench_regions AS
+    SELECT DISTINCT h3_cell_to_parent(cell, 5) AS cell FROM h3_bench_points WHERE id <= 200;
+CREATE TABLE h3_bench_origins AS
+    SELECT cell FROM h3_bench_points WHERE id <= 1000;
+
+VACUUM ANALYZE h3_bench_points;
+VACUUM ANALYZE h3_bench_polygons;
+VACUUM ANALYZE h3_bench_regions;
+VACUUM ANALYZE h3_bench_origins;
+
+SELECT count(*) = :points FROM h3_bench_points;
+SELECT count(*) = :polygons FROM h3_bench_polygons;
@@ -0,0 +1,27 @@
+\pset tuples_only on
+--
+-- Building indexes on the points
+--
+CALL h3_bench_run('index/btree',
+    'CREATE INDEX h3_bench_index ON h3_bench_points USING btree (cell)',
+    'DROP INDEX h3_bench_index');
+CALL h3_bench_run('index/btree hierarchy',
+    'CREATE INDEX h3_bench_index ON h3_bench_points USING btree (cell h3index_hierarchy_ops)',
+    'DROP INDEX h3_bench_index');
+CALL h3_bench_run('index/hash',
+    'CREATE INDEX h3_bench_index ON h3_bench_points USING hash (cell)',
+    'DROP INDEX h3_bench_index');
+CALL h3_bench_run('index/brin minmax',
+    'CREATE INDEX h3_bench_index ON h3_bench_points USING brin (cell)',
+    'DROP INDEX h3_bench_index');
+CALL h3_bench_run('index/brin inclusion',
+    'CREATE INDEX h3_bench_index ON h3_bench_points USING brin (cell h3index_inclusion_ops)',
+    'DROP INDEX h3_bench_index');
+CALL h3_bench_run('index/spgist',
+    'CREATE INDEX h3_bench_index ON h3_bench_points USING spgist (cell)',
+    'DROP INDEX h3_bench_index');
+CALL h3_bench_run('index/gist',
+    'CREATE INDEX h3_bench_index ON h3_bench_points USING gist (cell)',
+    'DROP INDEX h3_bench_index');
+
+SELECT count(*) = 7 FROM (SELECT DISTINCT scenario FROM h3_bench_results WHERE scenario LIKE 'index/%') q;
@@ -0,0 +1,23 @@
+\pset tuples_only on
+--
+-- Finding the nearest points of origins
+--
+SET enable_seqscan = off;
+
+CREATE INDEX h3_bench_index ON h3_bench_points USING spgist (cell);
+CALL h3_bench_run('knn/spgist 10 nearest',
+    'SELECT count(*) FROM h3_bench_origins o, LATERAL (
+        SELECT cell FROM h3_bench_points p ORDER BY p.cell <-> o.cell LIMIT 10
+    ) n');
+DROP INDEX h3_bench_index;
+
+CREATE INDEX h3_bench_index ON h3_bench_points USING gist (cell);
+CALL h3_bench_run('knn/gist 10 nearest',
+    'SELECT count(*) FROM h3_bench_origins o, LATERAL (
+        SELECT cell FROM h3_bench_points p ORDER BY p.cell <-> o.cell LIMIT 10
+    ) n');
+DROP INDEX h3_bench_index;
+
+RESET enable_seqscan;
+
+SELECT count(DISTINCT rows) = 1 FROM h3_bench_results WHERE scenario LIKE 'knn/%';
@@ -0,0 +1,10 @@
+\pset tuples_only on
+--
+-- Filling polygons with cells
+--
+CALL h3_bench_run('polyfill/polygon_to_cells',
+    'SELECT count(*) FROM h3_bench_polygons, h3_polygon_to_cells(polygon, NULL, 9)');
+CALL h3_bench_run('polyfill/polygon_to_cells_experimental overlapping',
+    'SELECT count(*) FROM h3_bench_polygons, h3_polygon_to_cells_experimental(polygon, NULL, 9, ''overlapping'')');
+
+SELECT count(*) = 2 FROM (SELECT DISTINCT scenario FROM h3_bench_results WHERE scenario LIKE 'polyfill/%') q;
@@ -0,0 +1,64 @@
+\pset tuples_only on
+--
+-- Writes the results to <suite>_bench.json, and compares them to the report
+-- of the same name in the directory H3_BENCH_BASELINE, if any, writing the
+-- comparison to <suite>_bench_comparison.txt. Scenarios regress if their
+-- median time exceeds the baseline by more than H3_BENCH_TOLERANCE (a
+-- fraction, by default 0.25), or if they count different rows.
+--
+\if :{?suite}
+\else
+\set suite h3
+\endif
+\set report :suite _bench.json
+\set comparison :suite _bench_comparison.txt
+\set baseline `cat "${H3_BENCH_BASELINE:-/nonexistent}"/:'report' 2>/dev/null || echo '{}'`
+\set tolerance `echo "${H3_BENCH_TOLERANCE:-0.25}"`
+
+CREATE TABLE h3_bench_report AS
+    SELECT jsonb_build_object(
+        'suite', :'suite',
+        'extension', (SELECT extversion FROM pg_extension WHERE extname = :'suite'),
+        'postgresql', current_setting('server_version'),
+        'scale', (SELECT scale FROM h3_bench_settings),
+        'runs', (SELECT runs FROM h3_bench_settings),
+        'scenarios', (
+            SELECT jsonb_object_agg(scenario, stats) FROM (
+                SELECT scenario, jsonb_build_object(
+                    'min_ms', round(min(ms)::numeric, 3),
+                    'median_ms', round((percentile_cont(0.5) WITHIN GROUP (ORDER BY ms))::numeric, 3),
+                    'rows', max(rows)
+                ) AS stats
+                FROM h3_bench_results
+                GROUP BY scenario
+            ) q
+        )
+    ) AS report;
+
+\pset format unaligned
+\o :report
+SELECT jsonb_pretty(report) FROM h3_bench_report;
+\o
+\pset format aligned
+
+CREATE TABLE h3_bench_comparison AS
+    SELECT
+        scenario,
+        (b.value->>'median_ms')::double precision AS baseline_ms,
+        (c.value->>'median_ms')::double precision AS median_ms,
+        round(((c.value->>'median_ms')::numeric / nullif((b.value->>'median_ms')::numeric, 0)), 2) AS ratio,
+        (b.value->>'rows')::bigint AS baseline_rows,
+        (c.value->>'rows')::bigint AS rows
+    FROM h3_bench_report r
+        CROSS JOIN LATERAL jsonb_each(r.report->'scenarios') c(scenario, value)
+        LEFT JOIN jsonb_each(:'baseline'::jsonb->'scenarios') b(scenario, value) USING (scenario);
+
+\pset tuples_only off
+\o :comparison
+SELECT * FROM h3_bench_comparison ORDER BY scenario;
+\o
+\pset tuples_only on
+
+SELECT 'regressions: ' || coalesce(string_agg(scenario, ', ' ORDER BY scenario), 'none')
+FROM h3_bench_comparison
+WHERE median_ms > baseline_ms * (1 + :tolerance) OR rows <> baseline_rows;
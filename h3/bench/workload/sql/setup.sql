@@ -0,0 +1,57 @@
+\pset tuples_only on
+--
+-- Workload benchmarks: timed scenarios over synthetic datasets, reported as
+-- JSON by report.sql. The environment sets the size of the datasets, the runs
+-- of each scenario, and where to find the report of a previous run to compare
+-- against (see docs/development.md).
+--
+\set scale `echo "${H3_BENCH_SCALE:-1}"`
+\set runs `echo "${H3_BENCH_RUNS:-3}"`
+
+CREATE TABLE h3_bench_settings AS
+    SELECT :scale::integer AS scale, :runs::integer AS runs;
+
+CREATE TABLE h3_bench_results (
+    scenario text,
+    run integer,
+    ms double precision,
+    rows bigint
+);
+
+-- deterministic pseudo random number in [0, 1), for row i of a stream
+CREATE FUNCTION h3_bench_random(i bigint, stream integer) RETURNS double precision
+AS $$
+    SELECT (hashint8extended(i, stream) & 9007199254740991)::double precision / 9007199254740992;
+$$ LANGUAGE SQL IMMUTABLE STRICT PARALLEL SAFE;
+
+-- runs a query, keeping its first value (a count), or a command, keeping the
+-- number of rows it affected, cleaning up after each run
+CREATE PROCEDURE h3_bench_run(scenario text, query text, cleanup text DEFAULT NULL)
+AS $$
+DECLARE
+    num_runs CONSTANT integer := (SELECT runs FROM h3_bench_settings);
+    start timestamptz;
+    num_rows bigint;
+BEGIN
+    FOR run IN 1..num_runs LOOP
+        start := clock_timestamp();
+        IF query ~* '^\s*(SELECT|WITH)\M' THEN
+            EXECUTE query INTO num_rows;
+        ELSE
+            EXECUTE query;
+            GET DIAGNOSTICS num_rows = ROW_COUNT;
+        END IF;
+        INSERT INTO h3_bench_results VALUES (
+            scenario,
+            run,
+            extract(epoch FROM clock_timestamp() - start) * 1000,
+            num_rows
+        );
+        IF cleanup IS NOT NULL THEN
+            EXECUTE cleanup;
+        END IF;
+    END LOOP;
+END;
+$$ LANGUAGE plpgsql;
+
+SELECT scale > 0 AND runs > 0 FROM h3_bench_settings;
@@ -54,10 +54,16 @@ CREATE OR REPLACE FUNCTION
     h3index_send(h3index) RETURNS bytea
 AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3index_analyze(internal) RETURNS boolean
+AS 'h3' LANGUAGE C VOLATILE STRICT;
+
 CREATE TYPE h3index (
   INPUT          = h3index_in,
   OUTPUT         = h3index_out,
   RECEIVE        = h3index_recv,
   SEND           = h3index_send,
+  ANALYZE        = h3index_analyze,
   LIKE           = int8
 );
@@ -27,6 +27,25 @@ AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
     h3_latlng_to_cell(point, integer)
 IS 'Indexes the location at the specified resolution.';
 
+--@ availability: unreleased
+--@ ref: h3_latlng_to_cells_geometry
+CREATE OR REPLACE FUNCTION
+    h3_latlng_to_cells(latlngs point[], resolution integer) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_latlng_to_cells(point[], integer)
+IS 'Indexes an array of locations at the specified resolution, in a single call.
+
+Missing locations give missing cells.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_latlng_to_cells(lats double precision[], lngs double precision[], resolution integer) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_latlng_to_cells(double precision[], double precision[], integer)
+IS 'Indexes arrays of latitudes and longitudes at the specified resolution, in a single call.
+
+Missing locations give missing cells.';
+
 --@ availability: 4.2.3
 --@ ref: h3_cell_to_geometry, h3_cell_to_geography
 CREATE OR REPLACE FUNCTION
@@ -44,3 +63,23 @@ AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
 IS 'Finds the boundary of the index.
 
 Use `SET h3.extend_antimeridian TO true` to extend coordinates when crossing 180th meridian.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_latlngs(cells h3index[]) RETURNS double precision[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_latlngs(h3index[])
+IS 'Finds the centroids of an array of indexes, as a flat array of longitude/latitude pairs.
+
+Missing indexes give a pair of `NaN`.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_boundaries(cells h3index[], OUT coords double precision[], OUT offsets integer[]) RETURNS record
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_boundaries(h3index[])
+IS 'Finds the boundaries of an array of indexes, as a flat array of longitude/latitude pairs.
+
+The boundary of `cells[n]` consists of pairs `offsets[n]` up to (not including) `offsets[n + 1]`, where pairs are numbered from zero. Missing indexes give empty boundaries.
+
+Use `SET h3.extend_antimeridian TO true` to extend coordinates when crossing 180th meridian.';
@@ -19,24 +19,34 @@
 --| Grid traversal allows finding cells in the vicinity of an origin cell, and
 --| determining how to traverse the grid from one cell to another.
 
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_grid_disk_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_grid_ring_unsafe_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_grid_disk(origin h3index, k integer DEFAULT 1) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_grid_disk_support; COMMENT ON FUNCTION
     h3_grid_disk(h3index, integer)
 IS 'Produces indices within "k" distance of the origin index.';
 
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_grid_disk_distances(origin h3index, k integer DEFAULT 1, OUT index h3index, OUT distance int) RETURNS SETOF record
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_grid_disk_support; COMMENT ON FUNCTION
     h3_grid_disk_distances(h3index, integer)
 IS 'Produces indices within "k" distance of the origin index paired with their distance to the origin.';
 
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_grid_ring_unsafe(origin h3index, k integer DEFAULT 1) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_grid_ring_unsafe_support; COMMENT ON FUNCTION
     h3_grid_ring_unsafe(h3index, integer)
 IS 'Returns the hollow hexagonal ring centered at origin with distance "k".';
 
@@ -19,6 +19,16 @@
 --| These functions permit moving between resolutions in the H3 grid system.
 --| The functions produce parent (coarser) or children (finer) cells.
 
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cell_to_children_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_uncompact_cells_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_cell_to_parent(cell h3index, resolution integer) RETURNS h3index
@@ -29,7 +39,7 @@ IS 'Returns the parent of the given index.';
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_cell_to_children(cell h3index, resolution integer) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_cell_to_children_support; COMMENT ON FUNCTION
     h3_cell_to_children(cell h3index, resolution integer)
 IS 'Returns the set of children of the given index.';
 
@@ -47,6 +57,47 @@ AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
     h3_compact_cells(cells h3index[])
 IS 'Compacts the given array as best as possible.';
 
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_transfn(internal, h3index) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_combinefn(internal, internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_serialfn(internal) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_deserialfn(bytea, internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_finalfn(internal) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE AGGREGATE h3_compact_agg(h3index) (
+    sfunc = h3_compact_agg_transfn,
+    stype = internal,
+    finalfunc = h3_compact_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_compact_agg_combinefn,
+    serialfunc = h3_compact_agg_serialfn,
+    deserialfunc = h3_compact_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_compact_agg(h3index)
+IS 'Compacts all aggregated cells as best as possible, ignoring nulls.
+
+Unlike `h3_compact_cells`, cells may be of different resolutions and overlap, and the set is compacted incrementally (and in parallel) instead of being collected into one array first.';
+
 --@ availability: 4.1.0
 CREATE OR REPLACE FUNCTION
     h3_cell_to_child_pos(child h3index, parentRes integer) RETURNS int8
@@ -64,7 +115,7 @@ IS 'Returns the child cell at a given position within an ordered list of all chi
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_uncompact_cells(cells h3index[], resolution integer) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_uncompact_cells_support; COMMENT ON FUNCTION
     h3_uncompact_cells(cells h3index[], resolution integer)
 IS 'Uncompacts the given array at the given resolution.';
 
@@ -81,7 +132,7 @@ IS 'Returns the parent of the given index.';
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_cell_to_children(cell h3index) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_cell_to_children_support; COMMENT ON FUNCTION
     h3_cell_to_children(cell h3index)
 IS 'Returns the set of children of the given index.';
 
@@ -95,7 +146,7 @@ IS 'Returns the center child (finer) index contained by input index at next reso
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_uncompact_cells(cells h3index[]) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_uncompact_cells_support; COMMENT ON FUNCTION
     h3_uncompact_cells(cells h3index[])
 IS 'Uncompacts the given array at the resolution one higher than the highest resolution in the set.';
 
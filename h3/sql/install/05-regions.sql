@@ -17,6 +17,15 @@
 --| # Region functions
 --|
 --| These functions convert H3 indexes to and from polygonal areas.
+--|
+--| Polygons that could cover more than `h3.polygon_to_cells_chunk_size` cells
+--| (default 1048576) are filled one band of latitude at a time, so memory use
+--| follows the width of the polygon rather than its area.
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_polygon_to_cells_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 --@ availability: 4.0.0
 --@ ref: h3_polygon_to_cells_geometry, h3_polygon_to_cells_geography
@@ -24,7 +33,7 @@ CREATE OR REPLACE FUNCTION
     h3_polygon_to_cells(exterior polygon, holes polygon[], resolution integer DEFAULT 1) RETURNS SETOF h3index
 AS 'h3' LANGUAGE C IMMUTABLE
 -- intentionally NOT STRICT
-CALLED ON NULL INPUT PARALLEL SAFE; COMMENT ON FUNCTION
+CALLED ON NULL INPUT PARALLEL SAFE SUPPORT h3_polygon_to_cells_support; COMMENT ON FUNCTION
     h3_polygon_to_cells(polygon, polygon[], integer)
 IS 'Takes an exterior polygon [and a set of hole polygon] and returns the set of hexagons that best fit the structure.';
 
@@ -33,7 +42,7 @@ CREATE OR REPLACE FUNCTION
     h3_polygon_to_cells_experimental(exterior polygon, holes polygon[], resolution integer DEFAULT 1, containment_mode text DEFAULT 'center') RETURNS SETOF h3index
 AS 'h3' LANGUAGE C IMMUTABLE
 -- intentionally NOT STRICT
-CALLED ON NULL INPUT PARALLEL SAFE; COMMENT ON FUNCTION
+CALLED ON NULL INPUT PARALLEL SAFE SUPPORT h3_polygon_to_cells_support; COMMENT ON FUNCTION
     h3_polygon_to_cells_experimental(polygon, polygon[], integer, text)
 IS 'Takes an exterior polygon [and a set of hole polygon] and returns the set of hexagons that best fit the structure.';
 
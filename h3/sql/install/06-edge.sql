@@ -19,10 +19,15 @@
 --| Unidirectional edges allow encoding the directed edge from one cell to a
 --| neighboring cell.
 
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_are_neighbor_cells_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_are_neighbor_cells(origin h3index, destination h3index) RETURNS boolean
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_are_neighbor_cells_support; COMMENT ON FUNCTION
     h3_are_neighbor_cells(origin h3index, destination h3index)
 IS 'Returns true if the given indices are neighbors.';
 
@@ -64,7 +69,7 @@ IS 'Returns the pair of indices from the given edge.';
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_origin_to_directed_edges(h3index) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE ROWS 6; COMMENT ON FUNCTION
     h3_origin_to_directed_edges(h3index)
 IS 'Returns all unidirectional edges with the given index as origin.';
 
@@ -28,7 +28,7 @@ IS 'Returns a single vertex for a given cell, as an H3 index.';
 --@ availability: 4.0.0
 CREATE OR REPLACE FUNCTION
     h3_cell_to_vertexes(cell h3index) RETURNS SETOF h3index
-AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE ROWS 6; COMMENT ON FUNCTION
     h3_cell_to_vertexes(cell h3index)
 IS 'Returns all vertexes for a given cell, as H3 indexes.';
 
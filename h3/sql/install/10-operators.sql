@@ -33,8 +33,12 @@ COMMENT ON OPERATOR <-> (h3index, h3index) IS
 --| ## B-tree operators
 
 --@ internal
-CREATE OR REPLACE FUNCTION h3index_eq(h3index, h3index) RETURNS boolean
+CREATE OR REPLACE FUNCTION h3index_eq_support(internal) RETURNS internal
     AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_eq(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE
+    SUPPORT h3index_eq_support;
 --@ availability: 0.1.0
 CREATE OPERATOR = (
   LEFTARG = h3index,
@@ -122,6 +126,30 @@ CREATE OPERATOR >= (
 
 -- ---------- ---------- ---------- ---------- ---------- ---------- ----------
 --| ## R-tree Operators
+--|
+--| Besides the GiST, SP-GiST and BRIN operator classes, the containment
+--| operators can use a regular B-tree index when comparing against a constant.
+--| Ancestors are looked up directly. Descendants are contiguous in the
+--| `h3index_hierarchy_ops` operator class, where they are found by a single
+--| range scan. In the default order they are only contiguous per resolution:
+--| when such an index is the only one on the column, the comparison is
+--| rewritten into one range per resolution, found by a bitmap scan.
+--| Comparing `h3_cell_to_parent(cell, resolution)` with a constant at that
+--| resolution scans its descendants the same way, with either B-tree index.
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_contsel(internal, oid, internal, integer) RETURNS double precision
+    AS 'h3' LANGUAGE C STABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_contjoinsel(internal, oid, internal, smallint, internal) RETURNS double precision
+    AS 'h3' LANGUAGE C STABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_contains_support(internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_contained_by_support(internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
 --@ internal
 CREATE OR REPLACE FUNCTION h3index_overlaps(h3index, h3index) RETURNS boolean
@@ -131,33 +159,35 @@ CREATE OPERATOR && (
 	PROCEDURE = h3index_overlaps,
 	LEFTARG = h3index, RIGHTARG = h3index,
 	COMMUTATOR = &&,
-    RESTRICT = contsel, JOIN = contjoinsel
+    RESTRICT = h3index_contsel, JOIN = h3index_contjoinsel
 );
 COMMENT ON OPERATOR && (h3index, h3index) IS
   'Returns true if the two H3 indexes intersect.';
 
 --@ internal
 CREATE OR REPLACE FUNCTION h3index_contains(h3index, h3index) RETURNS boolean
-    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE
+    SUPPORT h3index_contains_support;
 --@ availability: 3.6.1
 CREATE OPERATOR @> (
     PROCEDURE = h3index_contains,
     LEFTARG = h3index, RIGHTARG = h3index,
     COMMUTATOR = <@,
-    RESTRICT = contsel, JOIN = contjoinsel
+    RESTRICT = h3index_contsel, JOIN = h3index_contjoinsel
 );
 COMMENT ON OPERATOR @> (h3index, h3index) IS
   'Returns true if A contains B.';
 
 --@ internal
 CREATE OR REPLACE FUNCTION h3index_contained_by(h3index, h3index) RETURNS boolean
-    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE
+    SUPPORT h3index_contained_by_support;
 --@ availability: 3.6.1
 CREATE OPERATOR <@ (
     PROCEDURE = h3index_contained_by,
     LEFTARG = h3index, RIGHTARG = h3index,
     COMMUTATOR = @>,
-    RESTRICT = contsel, JOIN = contjoinsel
+    RESTRICT = h3index_contsel, JOIN = h3index_contjoinsel
 );
 COMMENT ON OPERATOR <@ (h3index, h3index) IS
   'Returns true if A is contained by B.';
@@ -35,3 +35,90 @@ CREATE OPERATOR CLASS h3index_ops DEFAULT FOR TYPE h3index USING btree AS
     OPERATOR  5  >  ,
     FUNCTION  1  h3index_cmp(h3index, h3index),
     FUNCTION  2  h3index_sortsupport(internal);
+
+--| ## B-tree hierarchy operator class
+--|
+--| Add a B-tree index using the `h3index_hierarchy_ops` operator class to
+--| order cells by base cell, then digits, then resolution, so that each cell is
+--| directly followed by all of its descendants. A single range scan then finds
+--| a cell together with its descendants (`@>`, `<@`), and clustering on the
+--| index keeps nearby cells of all resolutions together:
+--|
+--| ```sql
+--| -- CREATE INDEX [indexname] ON [tablename] USING btree([column] h3index_hierarchy_ops);
+--| CREATE INDEX btree_idx ON h3_data USING btree(hex h3index_hierarchy_ops);
+--| CLUSTER h3_data USING btree_idx;
+--| ```
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_hierarchy_cmp(h3index, h3index) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_hierarchy_sortsupport(internal) RETURNS void
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_hierarchysel(internal, oid, internal, integer) RETURNS double precision
+    AS 'h3' LANGUAGE C STABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_hierarchy_lt(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_hierarchy_le(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_hierarchy_gt(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_hierarchy_ge(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OPERATOR ~<~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_lt,
+  COMMUTATOR = ~>~ ,
+  NEGATOR = ~>=~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalarltjoinsel
+);
+--@ internal
+CREATE OPERATOR ~<=~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_le,
+  COMMUTATOR = ~>=~ ,
+  NEGATOR = ~>~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalarltjoinsel
+);
+--@ internal
+CREATE OPERATOR ~>~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_gt,
+  COMMUTATOR = ~<~ ,
+  NEGATOR = ~<=~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalargtjoinsel
+);
+--@ internal
+CREATE OPERATOR ~>=~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_ge,
+  COMMUTATOR = ~<=~ ,
+  NEGATOR = ~<~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalargtjoinsel
+);
+
+--@ internal
+CREATE OPERATOR CLASS h3index_hierarchy_ops FOR TYPE h3index USING btree AS
+    OPERATOR  1  ~<~  ,
+    OPERATOR  2  ~<=~ ,
+    OPERATOR  3   =   ,
+    OPERATOR  4  ~>=~ ,
+    OPERATOR  5  ~>~  ,
+    FUNCTION  1  h3index_hierarchy_cmp(h3index, h3index),
+    FUNCTION  2  h3index_hierarchy_sortsupport(internal);
@@ -27,3 +27,39 @@ CREATE OPERATOR CLASS h3index_minmax_ops DEFAULT FOR TYPE h3index USING brin AS
     FUNCTION  2  brin_minmax_add_value(internal, internal, internal, internal),
     FUNCTION  3  brin_minmax_consistent(internal, internal, internal),
     FUNCTION  4  brin_minmax_union(internal, internal, internal);
+
+--| ## BRIN inclusion operator class
+--|
+--| Add a BRIN index using the `h3index_inclusion_ops` operator class to
+--| summarize each block range by the lowest common ancestor of its cells,
+--| allowing containment queries (`@>`, `<@`, `&&`) to skip block ranges.
+--| Works best on tables physically ordered by cell:
+--|
+--| ```sql
+--| -- CREATE INDEX [indexname] ON [tablename] USING brin([column] h3index_inclusion_ops);
+--| CREATE INDEX brin_idx ON h3_data USING brin(hex h3index_inclusion_ops);
+--| ```
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_brin_inclusion_merge(h3index, h3index) RETURNS h3index
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_brin_inclusion_mergeable(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OR REPLACE FUNCTION h3index_brin_inclusion_contains(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OPERATOR CLASS h3index_inclusion_ops FOR TYPE h3index USING brin AS
+    OPERATOR  3  && ,
+    OPERATOR  6   = ,
+    OPERATOR  7  @> ,
+    OPERATOR  8  <@ ,
+    FUNCTION  1  brin_inclusion_opcinfo(internal),
+    FUNCTION  2  brin_inclusion_add_value(internal, internal, internal, internal),
+    FUNCTION  3  brin_inclusion_consistent(internal, internal, internal),
+    FUNCTION  4  brin_inclusion_union(internal, internal, internal),
+    FUNCTION 11  h3index_brin_inclusion_merge(h3index, h3index),
+    FUNCTION 12  h3index_brin_inclusion_mergeable(h3index, h3index),
+    FUNCTION 13  h3index_brin_inclusion_contains(h3index, h3index);
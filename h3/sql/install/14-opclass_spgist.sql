@@ -14,15 +14,23 @@
  * limitations under the License.
  */
 
---| ## SP-GiST operator class (experimental)
+--| ## SP-GiST operator class
 --|
---| *This is still an experimental feature and may change in future versions.*
---| Add an SP-GiST index using the `h3index_ops_experimental` operator class:
+--| Add an SP-GiST index using the default `h3index_spgist_ops` operator class,
+--| supporting the containment operators (`@>`, `<@`, `&&`) as well as
+--| nearest-neighbour ordering by grid distance (`<->`):
 --|
 --| ```sql
---| -- CREATE INDEX [indexname] ON [tablename] USING spgist([column] h3index_ops_experimental);
---| CREATE INDEX spgist_idx ON h3_data USING spgist(hex h3index_ops_experimental);
+--| -- CREATE INDEX [indexname] ON [tablename] USING spgist([column]);
+--| CREATE INDEX spgist_idx ON h3_data USING spgist(hex);
+--|
+--| SELECT hex FROM h3_data ORDER BY hex <-> '831c02fffffffff' LIMIT 10;
 --| ```
+--|
+--| The former `h3index_ops_experimental` operator class is kept as an alias.
+--| Indexes created with it before version `unreleased` are rebuilt when
+--| updating the extension. Indexes the updating role does not own are
+--| reported with a warning and must be rebuilt using `REINDEX`.
 
 --@ internal
 CREATE OR REPLACE FUNCTION h3index_spgist_config(internal, internal) RETURNS void
@@ -40,14 +48,12 @@ CREATE OR REPLACE FUNCTION h3index_spgist_inner_consistent(internal, internal) R
 CREATE OR REPLACE FUNCTION h3index_spgist_leaf_consistent(internal, internal) RETURNS boolean
     AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 
--- intentionally *not* marked as DEFAULT,
--- until we are satisfied with the implementation
-CREATE OPERATOR CLASS h3index_ops_experimental
+CREATE OPERATOR CLASS h3index_spgist_ops DEFAULT
 FOR TYPE h3index USING spgist
 AS
  -- OPERATOR   1  <<  ,  -- RTLeftStrategyNumber
  -- OPERATOR   2  &<  ,  -- RTOverLeftStrategyNumber
- -- OPERATOR   3  &&  ,  -- RTOverlapStrategyNumber
+    OPERATOR   3  &&  ,  -- RTOverlapStrategyNumber
  -- OPERATOR   4  &>  ,  -- RTOverRightStrategyNumber
  -- OPERATOR   5  >>  ,  -- RTRightStrategyNumber
     OPERATOR   6   =  ,  -- RTSameStrategyNumber
@@ -57,6 +63,22 @@ AS
  -- OPERATOR  10  <<| ,  -- RTBelowStrategyNumber
  -- OPERATOR  11  |>> ,  -- RTAboveStrategyNumber
  -- OPERATOR  12  |&> ,  -- RTOverAboveStrategyNumber
+    OPERATOR  15  <-> (h3index, h3index) FOR ORDER BY integer_ops,
+    FUNCTION  1  h3index_spgist_config(internal, internal),
+    FUNCTION  2  h3index_spgist_choose(internal, internal),
+    FUNCTION  3  h3index_spgist_picksplit(internal, internal),
+    FUNCTION  4  h3index_spgist_inner_consistent(internal, internal),
+    FUNCTION  5  h3index_spgist_leaf_consistent(internal, internal);
+
+-- kept for indexes created while the operator class was experimental
+CREATE OPERATOR CLASS h3index_ops_experimental
+FOR TYPE h3index USING spgist
+AS
+    OPERATOR   3  &&  ,
+    OPERATOR   6   =  ,
+    OPERATOR   7  @>  ,
+    OPERATOR   8  <@  ,
+    OPERATOR  15  <-> (h3index, h3index) FOR ORDER BY integer_ops,
     FUNCTION  1  h3index_spgist_config(internal, internal),
     FUNCTION  2  h3index_spgist_choose(internal, internal),
     FUNCTION  3  h3index_spgist_picksplit(internal, internal),
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+--| # Cell sets
+--|
+--| A set of cells, stored compacted (mixed resolution) and sorted, using
+--| a few bytes per cell. It is written like an array of cells, for example
+--| '{8928308280fffff,8828308281fffff}'.
+--|
+--| Cells are covered by a set if it contains them or any of their ancestors,
+--| which is tested by binary search. Set algebra works on the compacted cells
+--| directly.
+--|
+--| ```sql
+--| SELECT h3set_agg(cell) AS coverage FROM cells;
+--| SELECT '8928308280fffff' <@ coverage FROM coverages;
+--| ```
+
+-- declare shell type, allowing us to reference while defining functions
+-- before finally providing the full definition of the data type
+CREATE TYPE h3set;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3set_in(cstring) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3set_out(h3set) RETURNS cstring
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3set_recv(internal) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3set_send(h3set) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE h3set (
+  INPUT          = h3set_in,
+  OUTPUT         = h3set_out,
+  RECEIVE        = h3set_recv,
+  SEND           = h3set_send,
+  INTERNALLENGTH = VARIABLE,
+  ALIGNMENT      = double,
+  STORAGE        = extended
+);
+
+-- ---------- ---------- ---------- ---------- ---------- ---------- ----------
+--| ## Cell set operators
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3set_eq(h3set, h3set) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE OPERATOR = (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel
+);
+COMMENT ON OPERATOR = (h3set, h3set) IS
+  'Returns true if two sets cover the same cells.';
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3set_ne(h3set, h3set) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ internal
+CREATE OPERATOR <> (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3set_contains(h3set, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE OPERATOR @> (
+  LEFTARG = h3set,
+  RIGHTARG = h3index,
+  PROCEDURE = h3set_contains,
+  COMMUTATOR = <@,
+  RESTRICT = contsel,
+  JOIN = contjoinsel
+);
+COMMENT ON OPERATOR @> (h3set, h3index) IS
+  'Returns true if the set covers the cell.';
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3set_contained_by(h3index, h3set) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE OPERATOR <@ (
+  LEFTARG = h3index,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_contained_by,
+  COMMUTATOR = @>,
+  RESTRICT = contsel,
+  JOIN = contjoinsel
+);
+COMMENT ON OPERATOR <@ (h3index, h3set) IS
+  'Returns true if the cell is covered by the set.';
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3set_union(h3set, h3set) RETURNS h3set
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE OPERATOR + (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_union,
+  COMMUTATOR = +
+);
+COMMENT ON OPERATOR + (h3set, h3set) IS
+  'Returns the union of two sets.';
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3set_intersection(h3set, h3set) RETURNS h3set
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE OPERATOR * (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_intersection,
+  COMMUTATOR = *
+);
+COMMENT ON OPERATOR * (h3set, h3set) IS
+  'Returns the intersection of two sets.';
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3set_difference(h3set, h3set) RETURNS h3set
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+--@ availability: unreleased
+CREATE OPERATOR - (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_difference
+);
+COMMENT ON OPERATOR - (h3set, h3set) IS
+  'Returns the cells of the first set not covered by the second, splitting cells where needed.';
+
+-- ---------- ---------- ---------- ---------- ---------- ---------- ----------
+--| ## Cell set casts
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3index_array_to_h3set(h3index[]) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE CAST (h3index[] AS h3set) WITH FUNCTION h3index_array_to_h3set(h3index[]);
+COMMENT ON CAST (h3index[] AS h3set) IS
+    'Convert array of cells to set, ignoring nulls. Cells may be of different resolutions and overlap.';
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3set_to_h3index_array(h3set) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE CAST (h3set AS h3index[]) WITH FUNCTION h3set_to_h3index_array(h3set);
+COMMENT ON CAST (h3set AS h3index[]) IS
+    'Convert set to its compacted cells, sorted with every cell before its descendants.';
+
+-- ---------- ---------- ---------- ---------- ---------- ---------- ----------
+--| ## Cell set aggregates
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3set_union_agg_transfn(internal, h3set) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3set_agg_finalfn(internal) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE AGGREGATE h3set_agg(h3index) (
+    sfunc = h3_compact_agg_transfn,
+    stype = internal,
+    finalfunc = h3set_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_compact_agg_combinefn,
+    serialfunc = h3_compact_agg_serialfn,
+    deserialfunc = h3_compact_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3set_agg(h3index)
+IS 'Collects all aggregated cells into a set, ignoring nulls.';
+
+--@ availability: unreleased
+CREATE AGGREGATE h3set_union_agg(h3set) (
+    sfunc = h3set_union_agg_transfn,
+    stype = internal,
+    finalfunc = h3set_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_compact_agg_combinefn,
+    serialfunc = h3_compact_agg_serialfn,
+    deserialfunc = h3_compact_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3set_union_agg(h3set)
+IS 'Returns the union of all aggregated sets, ignoring nulls.';
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+--| # Random data
+--|
+--| These functions generate random cells and polygons, for tests and
+--| benchmarks. The same seed always gives the same rows, and rows are
+--| generated one at a time, so millions of them take little memory.
+--|
+--| Points are distributed by one of:
+--|
+--| - `uniform`: uniformly over the globe.
+--| - `clusters`: normally around 16 centers given by the seed, spreading 50 km.
+--| - `roads`: along random walks of 1000 points, a cell edge apart.
+--| - `pentagons`: normally around the 12 pentagons, spreading a few cell edges.
+--| - `antimeridian`: normally either side of the antimeridian, spreading a few cell edges.
+--|
+--| ```sql
+--| SELECT * FROM h3_random_cells(9, 1000000, 'clusters', 42);
+--| ```
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_random_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_random_cells(resolution integer, n bigint, distribution text DEFAULT 'uniform', seed bigint DEFAULT 0) RETURNS SETOF h3index
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_random_support; COMMENT ON FUNCTION
+    h3_random_cells(integer, bigint, text, bigint)
+IS 'Returns n random cells at the given resolution, distributed by `distribution`. The same seed gives the same cells.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_random_polygons(radius double precision, n bigint, distribution text DEFAULT 'uniform', seed bigint DEFAULT 0, vertices integer DEFAULT 32) RETURNS SETOF polygon
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_random_support; COMMENT ON FUNCTION
+    h3_random_polygons(double precision, bigint, text, bigint, integer)
+IS 'Returns n random polygons with jagged edges, of vertices 0.6 to 1 times `radius` km from their centers, which are distributed by `distribution` (any but roads). The same seed gives the same polygons.';
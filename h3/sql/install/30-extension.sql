@@ -27,3 +27,32 @@ CREATE OR REPLACE FUNCTION h3_pg_migrate_pass_by_reference(h3index) RETURNS h3in
     AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
     COMMENT ON FUNCTION h3_pg_migrate_pass_by_reference(h3index) IS
 'Migrate h3index from pass-by-reference to pass-by-value.';
+
+--| ## Function statistics
+--|
+--| With `h3` in `shared_preload_libraries` and `h3.track_functions` on, calls
+--| of the functions doing the most work are counted, timed and measured,
+--| grouped as `polyfill` (`h3_polygon_to_cells`), `children`
+--| (`h3_cell_to_children`), `disk` (`h3_grid_disk`), `dissolve`
+--| (`h3_cells_to_multi_polygon` and its aggregates) and `wkb`
+--| (`h3_cell_to_boundary_wkb`). Statistics are added up at the end of each
+--| transaction.
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_stat_functions(OUT function text, OUT calls bigint, OUT total_time double precision, OUT max_time double precision, OUT rows bigint, OUT peak_memory bigint, OUT stats_reset timestamptz) RETURNS SETOF record
+AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+CREATE OR REPLACE VIEW h3_stat_functions AS
+    SELECT * FROM h3_stat_functions();
+COMMENT ON VIEW h3_stat_functions IS
+'Calls, total and longest time (ms), rows returned and peak memory of set returning calls (bytes) of each group of functions.';
+
+--@ availability: unreleased
+CREATE OR REPLACE FUNCTION
+    h3_stat_functions_reset() RETURNS void
+AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL UNSAFE; COMMENT ON FUNCTION
+    h3_stat_functions_reset()
+IS 'Resets function statistics. Only superusers may call it, unless granted.';
+REVOKE ALL ON FUNCTION h3_stat_functions_reset() FROM PUBLIC;
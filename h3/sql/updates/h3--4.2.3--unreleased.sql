@@ -16,3 +16,488 @@
 
 -- complain if script is sourced in psql, rather than via CREATE EXTENSION
 \echo Use "ALTER EXTENSION h3 UPDATE TO 'unreleased'" to load this file. \quit
+
+-- GiST operator class
+CREATE OR REPLACE FUNCTION h3index_gist_consistent(internal, h3index, smallint, oid, internal) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_gist_union(internal, internal) RETURNS h3index
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_gist_penalty(internal, internal, internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_gist_picksplit(internal, internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_gist_same(h3index, h3index, internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_gist_distance(internal, h3index, smallint, oid, internal) RETURNS double precision
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_gist_sortsupport(internal) RETURNS void
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS h3index_gist_ops DEFAULT
+FOR TYPE h3index USING gist
+AS
+    OPERATOR   3  &&  ,  -- RTOverlapStrategyNumber
+    OPERATOR   6   =  ,  -- RTSameStrategyNumber
+    OPERATOR   7  @>  ,  -- RTContainsStrategyNumber
+    OPERATOR   8  <@  ,  -- RTContainedByStrategyNumber
+    OPERATOR  15  <-> (h3index, h3index) FOR ORDER BY integer_ops,
+    FUNCTION  1  h3index_gist_consistent(internal, h3index, smallint, oid, internal),
+    FUNCTION  2  h3index_gist_union(internal, internal),
+    FUNCTION  5  h3index_gist_penalty(internal, internal, internal),
+    FUNCTION  6  h3index_gist_picksplit(internal, internal),
+    FUNCTION  7  h3index_gist_same(h3index, h3index, internal),
+    FUNCTION  8  h3index_gist_distance(internal, h3index, smallint, oid, internal);
+
+-- sorted builds (support function 11) require PostgreSQL 14
+DO $$ BEGIN
+    IF current_setting('server_version_num')::int >= 140000 THEN
+        ALTER OPERATOR FAMILY h3index_gist_ops USING gist ADD
+            FUNCTION 11 (h3index) h3index_gist_sortsupport(internal);
+    END IF;
+END $$;
+
+-- SP-GiST nearest-neighbour ordering
+ALTER OPERATOR FAMILY h3index_ops_experimental USING spgist ADD
+    OPERATOR  15  <-> (h3index, h3index) FOR ORDER BY integer_ops;
+
+-- SP-GiST operator class, no longer experimental
+-- (the tree layout changed, existing indexes are rebuilt below)
+ALTER OPERATOR FAMILY h3index_ops_experimental USING spgist ADD
+    OPERATOR   3  &&  (h3index, h3index);
+
+CREATE OPERATOR CLASS h3index_spgist_ops DEFAULT
+FOR TYPE h3index USING spgist
+AS
+    OPERATOR   3  &&  ,
+    OPERATOR   6   =  ,
+    OPERATOR   7  @>  ,
+    OPERATOR   8  <@  ,
+    OPERATOR  15  <-> (h3index, h3index) FOR ORDER BY integer_ops,
+    FUNCTION  1  h3index_spgist_config(internal, internal),
+    FUNCTION  2  h3index_spgist_choose(internal, internal),
+    FUNCTION  3  h3index_spgist_picksplit(internal, internal),
+    FUNCTION  4  h3index_spgist_inner_consistent(internal, internal),
+    FUNCTION  5  h3index_spgist_leaf_consistent(internal, internal);
+
+-- rebuild indexes laid out by the experimental support functions
+DO $$
+DECLARE
+    idx regclass;
+BEGIN
+    FOR idx IN
+        SELECT DISTINCT i.indexrelid::regclass
+        FROM pg_index i
+        JOIN pg_opclass c ON c.oid = ANY (i.indclass::oid[])
+        JOIN pg_am a ON a.oid = c.opcmethod
+        WHERE a.amname = 'spgist' AND c.opcname = 'h3index_ops_experimental'
+    LOOP
+        BEGIN
+            EXECUTE format('REINDEX INDEX %s', idx);
+        EXCEPTION WHEN insufficient_privilege THEN
+            RAISE WARNING 'SP-GiST index % must be rebuilt using REINDEX', idx;
+        END;
+    END LOOP;
+END $$;
+
+-- BRIN inclusion operator class
+CREATE OR REPLACE FUNCTION h3index_brin_inclusion_merge(h3index, h3index) RETURNS h3index
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_brin_inclusion_mergeable(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_brin_inclusion_contains(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR CLASS h3index_inclusion_ops FOR TYPE h3index USING brin AS
+    OPERATOR  3  && ,
+    OPERATOR  6   = ,
+    OPERATOR  7  @> ,
+    OPERATOR  8  <@ ,
+    FUNCTION  1  brin_inclusion_opcinfo(internal),
+    FUNCTION  2  brin_inclusion_add_value(internal, internal, internal, internal),
+    FUNCTION  3  brin_inclusion_consistent(internal, internal, internal),
+    FUNCTION  4  brin_inclusion_union(internal, internal, internal),
+    FUNCTION 11  h3index_brin_inclusion_merge(h3index, h3index),
+    FUNCTION 12  h3index_brin_inclusion_mergeable(h3index, h3index),
+    FUNCTION 13  h3index_brin_inclusion_contains(h3index, h3index);
+
+-- B-tree support function now orders like the comparison operators, so
+-- indexes sorted in reverse must be rebuilt. Rebuilding them here would lock
+-- their tables for the whole update, list them instead.
+DO $$
+DECLARE
+    idx regclass;
+BEGIN
+    FOR idx IN
+        SELECT DISTINCT i.indexrelid::regclass
+        FROM pg_index i
+        JOIN pg_opclass c ON c.oid = ANY (i.indclass::oid[])
+        JOIN pg_am a ON a.oid = c.opcmethod
+        WHERE a.amname = 'btree' AND c.opcname = 'h3index_ops'
+    LOOP
+        RAISE WARNING 'B-tree index % must be rebuilt using REINDEX', idx;
+    END LOOP;
+END $$;
+
+-- B-tree planner support for containment operators
+CREATE OR REPLACE FUNCTION h3index_contains_support(internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_contained_by_support(internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+ALTER FUNCTION h3index_contains(h3index, h3index) SUPPORT h3index_contains_support;
+ALTER FUNCTION h3index_contained_by(h3index, h3index) SUPPORT h3index_contained_by_support;
+CREATE OR REPLACE FUNCTION h3index_eq_support(internal) RETURNS internal
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+ALTER FUNCTION h3index_eq(h3index, h3index) SUPPORT h3index_eq_support;
+
+-- B-tree hierarchy operator class
+CREATE OR REPLACE FUNCTION h3index_hierarchy_cmp(h3index, h3index) RETURNS integer
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_hierarchy_sortsupport(internal) RETURNS void
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_hierarchysel(internal, oid, internal, integer) RETURNS double precision
+    AS 'h3' LANGUAGE C STABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_hierarchy_lt(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_hierarchy_le(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_hierarchy_gt(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_hierarchy_ge(h3index, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OPERATOR ~<~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_lt,
+  COMMUTATOR = ~>~ ,
+  NEGATOR = ~>=~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalarltjoinsel
+);
+CREATE OPERATOR ~<=~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_le,
+  COMMUTATOR = ~>=~ ,
+  NEGATOR = ~>~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalarltjoinsel
+);
+CREATE OPERATOR ~>~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_gt,
+  COMMUTATOR = ~<~ ,
+  NEGATOR = ~<=~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalargtjoinsel
+);
+CREATE OPERATOR ~>=~ (
+  LEFTARG = h3index,
+  RIGHTARG = h3index,
+  PROCEDURE = h3index_hierarchy_ge,
+  COMMUTATOR = ~<=~ ,
+  NEGATOR = ~<~ ,
+  RESTRICT = h3index_hierarchysel,
+  JOIN = scalargtjoinsel
+);
+
+CREATE OPERATOR CLASS h3index_hierarchy_ops FOR TYPE h3index USING btree AS
+    OPERATOR  1  ~<~  ,
+    OPERATOR  2  ~<=~ ,
+    OPERATOR  3   =   ,
+    OPERATOR  4  ~>=~ ,
+    OPERATOR  5  ~>~  ,
+    FUNCTION  1  h3index_hierarchy_cmp(h3index, h3index),
+    FUNCTION  2  h3index_hierarchy_sortsupport(internal);
+
+-- Statistics and selectivity estimation
+CREATE OR REPLACE FUNCTION
+    h3index_analyze(internal) RETURNS boolean
+AS 'h3' LANGUAGE C VOLATILE STRICT;
+ALTER TYPE h3index SET (ANALYZE = h3index_analyze);
+
+CREATE OR REPLACE FUNCTION h3index_contsel(internal, oid, internal, integer) RETURNS double precision
+    AS 'h3' LANGUAGE C STABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3index_contjoinsel(internal, oid, internal, smallint, internal) RETURNS double precision
+    AS 'h3' LANGUAGE C STABLE STRICT PARALLEL SAFE;
+ALTER OPERATOR && (h3index, h3index) SET (RESTRICT = h3index_contsel, JOIN = h3index_contjoinsel);
+ALTER OPERATOR @> (h3index, h3index) SET (RESTRICT = h3index_contsel, JOIN = h3index_contjoinsel);
+ALTER OPERATOR <@ (h3index, h3index) SET (RESTRICT = h3index_contsel, JOIN = h3index_contjoinsel);
+
+CREATE OR REPLACE FUNCTION
+    h3_are_neighbor_cells_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+ALTER FUNCTION h3_are_neighbor_cells(h3index, h3index) SUPPORT h3_are_neighbor_cells_support;
+
+-- Row estimates of set returning functions
+CREATE OR REPLACE FUNCTION
+    h3_grid_disk_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_grid_ring_unsafe_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_cell_to_children_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_uncompact_cells_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_polygon_to_cells_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+ALTER FUNCTION h3_grid_disk(h3index, integer) SUPPORT h3_grid_disk_support;
+ALTER FUNCTION h3_grid_disk_distances(h3index, integer) SUPPORT h3_grid_disk_support;
+ALTER FUNCTION h3_grid_ring_unsafe(h3index, integer) SUPPORT h3_grid_ring_unsafe_support;
+ALTER FUNCTION h3_cell_to_children(h3index, integer) SUPPORT h3_cell_to_children_support;
+ALTER FUNCTION h3_cell_to_children(h3index) SUPPORT h3_cell_to_children_support;
+ALTER FUNCTION h3_uncompact_cells(h3index[], integer) SUPPORT h3_uncompact_cells_support;
+ALTER FUNCTION h3_uncompact_cells(h3index[]) SUPPORT h3_uncompact_cells_support;
+ALTER FUNCTION h3_polygon_to_cells(polygon, polygon[], integer) SUPPORT h3_polygon_to_cells_support;
+ALTER FUNCTION h3_polygon_to_cells_experimental(polygon, polygon[], integer, text) SUPPORT h3_polygon_to_cells_support;
+ALTER FUNCTION h3_origin_to_directed_edges(h3index) ROWS 6;
+ALTER FUNCTION h3_cell_to_vertexes(h3index) ROWS 6;
+
+-- Batch indexing
+CREATE OR REPLACE FUNCTION
+    h3_latlng_to_cells(latlngs point[], resolution integer) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_latlng_to_cells(point[], integer)
+IS 'Indexes an array of locations at the specified resolution, in a single call.
+
+Missing locations give missing cells.';
+CREATE OR REPLACE FUNCTION
+    h3_latlng_to_cells(lats double precision[], lngs double precision[], resolution integer) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_latlng_to_cells(double precision[], double precision[], integer)
+IS 'Indexes arrays of latitudes and longitudes at the specified resolution, in a single call.
+
+Missing locations give missing cells.';
+
+-- Batch centroids and boundaries
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_latlngs(cells h3index[]) RETURNS double precision[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_latlngs(h3index[])
+IS 'Finds the centroids of an array of indexes, as a flat array of longitude/latitude pairs.
+
+Missing indexes give a pair of `NaN`.';
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_boundaries(cells h3index[], OUT coords double precision[], OUT offsets integer[]) RETURNS record
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE; COMMENT ON FUNCTION
+    h3_cells_to_boundaries(h3index[])
+IS 'Finds the boundaries of an array of indexes, as a flat array of longitude/latitude pairs.
+
+The boundary of `cells[n]` consists of pairs `offsets[n]` up to (not including) `offsets[n + 1]`, where pairs are numbered from zero. Missing indexes give empty boundaries.
+
+Use `SET h3.extend_antimeridian TO true` to extend coordinates when crossing 180th meridian.';
+
+-- Compact aggregate
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_transfn(internal, h3index) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_combinefn(internal, internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_serialfn(internal) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_deserialfn(bytea, internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_compact_agg_finalfn(internal) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE AGGREGATE h3_compact_agg(h3index) (
+    sfunc = h3_compact_agg_transfn,
+    stype = internal,
+    finalfunc = h3_compact_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_compact_agg_combinefn,
+    serialfunc = h3_compact_agg_serialfn,
+    deserialfunc = h3_compact_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_compact_agg(h3index)
+IS 'Compacts all aggregated cells as best as possible, ignoring nulls.
+
+Unlike `h3_compact_cells`, cells may be of different resolutions and overlap, and the set is compacted incrementally (and in parallel) instead of being collected into one array first.';
+
+-- Cell sets
+-- declare shell type, allowing us to reference while defining functions
+-- before finally providing the full definition of the data type
+CREATE TYPE h3set;
+CREATE OR REPLACE FUNCTION
+    h3set_in(cstring) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3set_out(h3set) RETURNS cstring
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3set_recv(internal) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3set_send(h3set) RETURNS bytea
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE TYPE h3set (
+  INPUT          = h3set_in,
+  OUTPUT         = h3set_out,
+  RECEIVE        = h3set_recv,
+  SEND           = h3set_send,
+  INTERNALLENGTH = VARIABLE,
+  ALIGNMENT      = double,
+  STORAGE        = extended
+);
+CREATE OR REPLACE FUNCTION h3set_eq(h3set, h3set) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR = (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_eq,
+  COMMUTATOR = =,
+  NEGATOR = <>,
+  RESTRICT = eqsel,
+  JOIN = eqjoinsel
+);
+COMMENT ON OPERATOR = (h3set, h3set) IS
+  'Returns true if two sets cover the same cells.';
+CREATE OR REPLACE FUNCTION h3set_ne(h3set, h3set) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <> (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_ne,
+  COMMUTATOR = <>,
+  NEGATOR = =,
+  RESTRICT = neqsel,
+  JOIN = neqjoinsel
+);
+CREATE OR REPLACE FUNCTION h3set_contains(h3set, h3index) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR @> (
+  LEFTARG = h3set,
+  RIGHTARG = h3index,
+  PROCEDURE = h3set_contains,
+  COMMUTATOR = <@,
+  RESTRICT = contsel,
+  JOIN = contjoinsel
+);
+COMMENT ON OPERATOR @> (h3set, h3index) IS
+  'Returns true if the set covers the cell.';
+CREATE OR REPLACE FUNCTION h3set_contained_by(h3index, h3set) RETURNS boolean
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR <@ (
+  LEFTARG = h3index,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_contained_by,
+  COMMUTATOR = @>,
+  RESTRICT = contsel,
+  JOIN = contjoinsel
+);
+COMMENT ON OPERATOR <@ (h3index, h3set) IS
+  'Returns true if the cell is covered by the set.';
+CREATE OR REPLACE FUNCTION h3set_union(h3set, h3set) RETURNS h3set
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR + (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_union,
+  COMMUTATOR = +
+);
+COMMENT ON OPERATOR + (h3set, h3set) IS
+  'Returns the union of two sets.';
+CREATE OR REPLACE FUNCTION h3set_intersection(h3set, h3set) RETURNS h3set
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR * (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_intersection,
+  COMMUTATOR = *
+);
+COMMENT ON OPERATOR * (h3set, h3set) IS
+  'Returns the intersection of two sets.';
+CREATE OR REPLACE FUNCTION h3set_difference(h3set, h3set) RETURNS h3set
+    AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OPERATOR - (
+  LEFTARG = h3set,
+  RIGHTARG = h3set,
+  PROCEDURE = h3set_difference
+);
+COMMENT ON OPERATOR - (h3set, h3set) IS
+  'Returns the cells of the first set not covered by the second, splitting cells where needed.';
+CREATE OR REPLACE FUNCTION
+    h3index_array_to_h3set(h3index[]) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE CAST (h3index[] AS h3set) WITH FUNCTION h3index_array_to_h3set(h3index[]);
+COMMENT ON CAST (h3index[] AS h3set) IS
+    'Convert array of cells to set, ignoring nulls. Cells may be of different resolutions and overlap.';
+CREATE OR REPLACE FUNCTION
+    h3set_to_h3index_array(h3set) RETURNS h3index[]
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE CAST (h3set AS h3index[]) WITH FUNCTION h3set_to_h3index_array(h3set);
+COMMENT ON CAST (h3set AS h3index[]) IS
+    'Convert set to its compacted cells, sorted with every cell before its descendants.';
+CREATE OR REPLACE FUNCTION
+    h3set_union_agg_transfn(internal, h3set) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3set_agg_finalfn(internal) RETURNS h3set
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE AGGREGATE h3set_agg(h3index) (
+    sfunc = h3_compact_agg_transfn,
+    stype = internal,
+    finalfunc = h3set_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_compact_agg_combinefn,
+    serialfunc = h3_compact_agg_serialfn,
+    deserialfunc = h3_compact_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3set_agg(h3index)
+IS 'Collects all aggregated cells into a set, ignoring nulls.';
+
+CREATE AGGREGATE h3set_union_agg(h3set) (
+    sfunc = h3set_union_agg_transfn,
+    stype = internal,
+    finalfunc = h3set_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_compact_agg_combinefn,
+    serialfunc = h3_compact_agg_serialfn,
+    deserialfunc = h3_compact_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3set_union_agg(h3set)
+IS 'Returns the union of all aggregated sets, ignoring nulls.';
+
+-- Random data
+CREATE OR REPLACE FUNCTION
+    h3_random_support(internal) RETURNS internal
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_random_cells(resolution integer, n bigint, distribution text DEFAULT 'uniform', seed bigint DEFAULT 0) RETURNS SETOF h3index
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_random_support; COMMENT ON FUNCTION
+    h3_random_cells(integer, bigint, text, bigint)
+IS 'Returns n random cells at the given resolution, distributed by `distribution`. The same seed gives the same cells.';
+CREATE OR REPLACE FUNCTION
+    h3_random_polygons(radius double precision, n bigint, distribution text DEFAULT 'uniform', seed bigint DEFAULT 0, vertices integer DEFAULT 32) RETURNS SETOF polygon
+AS 'h3' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE SUPPORT h3_random_support; COMMENT ON FUNCTION
+    h3_random_polygons(double precision, bigint, text, bigint, integer)
+IS 'Returns n random polygons with jagged edges, of vertices 0.6 to 1 times `radius` km from their centers, which are distributed by `distribution` (any but roads). The same seed gives the same polygons.';
+
+-- Function statistics
+CREATE OR REPLACE FUNCTION
+    h3_stat_functions(OUT function text, OUT calls bigint, OUT total_time double precision, OUT max_time double precision, OUT rows bigint, OUT peak_memory bigint, OUT stats_reset timestamptz) RETURNS SETOF record
+AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL SAFE;
+CREATE OR REPLACE VIEW h3_stat_functions AS
+    SELECT * FROM h3_stat_functions();
+COMMENT ON VIEW h3_stat_functions IS
+'Calls, total and longest time (ms), rows returned and peak memory of set returning calls (bytes) of each group of functions.';
+CREATE OR REPLACE FUNCTION
+    h3_stat_functions_reset() RETURNS void
+AS 'h3' LANGUAGE C VOLATILE STRICT PARALLEL UNSAFE; COMMENT ON FUNCTION
+    h3_stat_functions_reset()
+IS 'Resets function statistics. Only superusers may call it, unless granted.';
+REVOKE ALL ON FUNCTION h3_stat_functions_reset() FROM PUBLIC;
@@ -22,6 +22,8 @@
 #include <utils/array.h> // ArrayType
 
 #include "error.h"
+#include "iterator.h"
+#include "stat.h"
 #include "type.h"
 #include "srf.h"
 
@@ -46,51 +48,52 @@ h3_cell_to_parent(PG_FUNCTION_ARGS)
 	PG_RETURN_H3INDEX(parent);
 }
 
-/* Returns children indexes at given resolution (or next resolution if none given) */
-Datum
-h3_cell_to_children(PG_FUNCTION_ARGS)
+/*
+ * Returns children indexes at given resolution (or next resolution if none given)
+ *
+ * Children are produced one at a time by incrementing digits, so memory use
+ * does not depend on the number of children.
+ */
+static Datum
+h3_cell_to_children_internal(PG_FUNCTION_ARGS)
 {
-	/* stuff done only on the first call of the function */
+	FuncCallContext *funcctx;
+	H3ChildIterator *iter;
+
 	if (SRF_IS_FIRSTCALL())
 	{
+		H3Index		origin = PG_GETARG_H3INDEX(0);
+		int			resolution = PG_GETARG_OPTIONAL_RES(1, origin, 1);
 		int64_t		max;
-		int64_t		size;
-		H3Index    *children;
-
-		/* create a function context for cross-call persistence */
-		FuncCallContext *funcctx = SRF_FIRSTCALL_INIT();
-
-		/* switch to memory context appropriate for multiple function calls */
-		MemoryContext oldcontext =
-		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
 
-		/* BEGIN One-time setup code */
+		funcctx = SRF_FIRSTCALL_INIT();
 
 		/* ensure valid resolution target */
-		H3Index		origin = PG_GETARG_H3INDEX(0);
-		int			resolution = PG_GETARG_OPTIONAL_RES(1, origin, 1);
-
 		h3_assert(cellToChildrenSize(origin, resolution, &max));
 
-		size = max * sizeof(H3Index);
-		ASSERT(
-			   AllocSizeIsValid(size),
-			   ERRCODE_OUT_OF_MEMORY,
-			   "Cannot allocate necessary amount memory, try using h3_cell_to_children_slow()"
-			);
-		children = palloc(size);
-
-		h3_assert(cellToChildren(origin, resolution, children));
+		iter = MemoryContextAlloc(funcctx->multi_call_memory_ctx, sizeof(H3ChildIterator));
+		iterator_children_init(iter, origin, resolution);
+		funcctx->user_fctx = iter;
+	}
 
-		funcctx->user_fctx = children;
-		funcctx->max_calls = max;
+	funcctx = SRF_PERCALL_SETUP();
+	iter = funcctx->user_fctx;
 
-		/* END One-time setup code */
+	if (iter->cell != H3_NULL)
+	{
+		Datum		result = H3IndexGetDatum(iter->cell);
 
-		MemoryContextSwitchTo(oldcontext);
+		iterator_children_step(iter);
+		SRF_RETURN_NEXT(funcctx, result);
 	}
 
-	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
+	SRF_RETURN_DONE(funcctx);
+}
+
+Datum
+h3_cell_to_children(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_CHILDREN, h3_cell_to_children_internal, fcinfo);
 }
 
 /* Returns the center child (finer) index contained by input index at given resolution */
@@ -166,40 +169,57 @@ h3_compact_cells(PG_FUNCTION_ARGS)
 	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
 }
 
+/* state of h3_uncompact_cells between calls */
+typedef struct
+{
+	H3Index    *compactedSet;
+	int			numCompacted;
+	int			next;			/* next compacted cell to expand */
+	int			resolution;
+	H3ChildIterator children;
+}	UncompactState;
+
+/*
+ * Uncompacts the given set, expanding each compacted cell in turn so that
+ * only the input is kept in memory.
+ */
 Datum
 h3_uncompact_cells(PG_FUNCTION_ARGS)
 {
+	FuncCallContext *funcctx;
+	UncompactState *state;
+
 	if (SRF_IS_FIRSTCALL())
 	{
-		int			resolution;
 		Datum		value;
 		bool		isnull;
 		int			i = 0;
 		int64_t		max;
-		H3Index    *uncompactedSet;
 
-		FuncCallContext *funcctx = SRF_FIRSTCALL_INIT();
-		MemoryContext oldcontext =
-		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		MemoryContext oldcontext;
+		ArrayType  *array;
+		ArrayIterator iterator;
 
-		ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
 
-		int			numCompacted = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
-		ArrayIterator iterator = array_create_iterator(array, 0, NULL);
-		H3Index    *compactedSet = palloc(numCompacted * sizeof(H3Index));
+		array = PG_GETARG_ARRAYTYPE_P(0);
+		iterator = array_create_iterator(array, 0, NULL);
 
-		/*
-		 * Extract data from array into compactedSet, and wipe compactedSet
-		 * memory
-		 */
+		state = palloc(sizeof(UncompactState));
+		state->numCompacted = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+		state->compactedSet = palloc(state->numCompacted * sizeof(H3Index));
+		state->next = 0;
+
+		/* Extract data from array into compactedSet */
 		while (array_iterate(iterator, &value, &isnull))
 		{
-			compactedSet[i++] = DatumGetH3Index(value);
+			state->compactedSet[i++] = DatumGetH3Index(value);
 		}
 
 		if (PG_NARGS() == 2)
 		{
-			resolution = PG_GETARG_INT32(1);
+			state->resolution = PG_GETARG_INT32(1);
 		}
 		else
 		{
@@ -207,9 +227,9 @@ h3_uncompact_cells(PG_FUNCTION_ARGS)
 			int			highRes = 0;
 
 			/* Find highest resolution in the given set */
-			for (int i = 0; i < numCompacted; i++)
+			for (int i = 0; i < state->numCompacted; i++)
 			{
-				int			curRes = getResolution(compactedSet[i]);
+				int			curRes = getResolution(state->compactedSet[i]);
 
 				if (curRes > highRes)
 					highRes = curRes;
@@ -220,19 +240,37 @@ h3_uncompact_cells(PG_FUNCTION_ARGS)
 			 * that
 			 */
 			/* Else uncompact one step further than the highest resolution */
-			resolution = (highRes == 15 ? highRes : highRes + 1);
+			state->resolution = (highRes == 15 ? highRes : highRes + 1);
 		}
 
-		h3_assert(uncompactCellsSize(compactedSet, numCompacted, resolution, &max));
+		/* validates resolution against every cell */
+		h3_assert(uncompactCellsSize(state->compactedSet, state->numCompacted,
+									 state->resolution, &max));
 
-		uncompactedSet = palloc0(max * sizeof(H3Index));
+		state->children.cell = H3_NULL;
+		funcctx->user_fctx = state;
+		MemoryContextSwitchTo(oldcontext);
+	}
 
-		h3_assert(uncompactCells(compactedSet, numCompacted, uncompactedSet, max, resolution));
+	funcctx = SRF_PERCALL_SETUP();
+	state = funcctx->user_fctx;
 
-		funcctx->user_fctx = uncompactedSet;
-		funcctx->max_calls = max;
-		MemoryContextSwitchTo(oldcontext);
+	/* move on to the next compacted cell, skipping missing (all zeros) */
+	while (state->children.cell == H3_NULL && state->next < state->numCompacted)
+	{
+		H3Index		cell = state->compactedSet[state->next++];
+
+		if (cell != H3_NULL)
+			iterator_children_init(&state->children, cell, state->resolution);
 	}
 
-	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
+	if (state->children.cell != H3_NULL)
+	{
+		Datum		result = H3IndexGetDatum(state->children.cell);
+
+		iterator_children_step(&state->children);
+		SRF_RETURN_NEXT(funcctx, result);
+	}
+
+	SRF_RETURN_DONE(funcctx);
 }
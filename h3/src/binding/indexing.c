@@ -22,8 +22,14 @@
 
 #include <h3api.h>
 
-#include <fmgr.h>			 // PG_FUNCTION_INFO_V1
-#include <utils/geo_decls.h> // PG_GETARG_POINT_P
+#include <fmgr.h>				 // PG_FUNCTION_INFO_V1
+#include <funcapi.h>			 // get_call_result_type
+#include <access/htup_details.h> // heap_form_tuple
+#include <catalog/pg_type.h>	 // FLOAT8OID
+#include <utils/array.h>		 // array_create_iterator
+#include <utils/float.h>		 // get_float8_nan
+#include <utils/geo_decls.h>	 // PG_GETARG_POINT_P
+#include <utils/lsyscache.h>	 // get_element_type
 #include <math.h> // fabs
 
 #include "constants.h"
@@ -32,33 +38,43 @@
 #include "guc.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_latlng_to_cell);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_latlng_to_cells);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_latlng);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_boundary);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_latlngs);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_boundaries);
 
-/* Indexes the location at the specified resolution */
-Datum
-h3_latlng_to_cell(PG_FUNCTION_ARGS)
+/* Checks location is within bounds, if h3.strict is set */
+static void
+assert_valid_location(double lng, double lat)
 {
-	H3Index		cell;
-	LatLng		location;
-	Point	   *point = PG_GETARG_POINT_P(0);
-	int			resolution = PG_GETARG_INT32(1);
-
 	if (h3_guc_strict)
 	{
 		ASSERT(
-			   point->x >= -180 && point->x <= 180,
+			   lng >= -180 && lng <= 180,
 			   ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE,
 			   "Longitude must be between -180 and 180 degrees inclusive, but got %f.",
-			   point->x
+			   lng
 			);
 		ASSERT(
-			   point->y >= -90 && point->y <= 90,
+			   lat >= -90 && lat <= 90,
 			   ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE,
 		"Latitude must be between -90 and 90 degrees inclusive, but got %f.",
-			   point->y
+			   lat
 			);
 	}
+}
+
+/* Indexes the location at the specified resolution */
+Datum
+h3_latlng_to_cell(PG_FUNCTION_ARGS)
+{
+	H3Index		cell;
+	LatLng		location;
+	Point	   *point = PG_GETARG_POINT_P(0);
+	int			resolution = PG_GETARG_INT32(1);
+
+	assert_valid_location(point->x, point->y);
 
 	location.lng = degsToRads(point->x);
 	location.lat = degsToRads(point->y);
@@ -69,6 +85,108 @@ h3_latlng_to_cell(PG_FUNCTION_ARGS)
 	PG_RETURN_H3INDEX(cell);
 }
 
+/*
+ * Indexes locations given in degrees, in place of their coordinates.
+ *
+ * Validation and conversion to radians are separate passes over plain
+ * arrays, which the compiler is free to vectorize. What remains is a tight
+ * loop of latLngToCell calls, without the per-row overhead of fmgr.
+ */
+static void
+latlngs_to_cells(LatLng *locations, const bool *nulls, int count, int resolution,
+				 Datum *cells)
+{
+	H3Index		cell;
+
+	for (int i = 0; i < count; i++)
+		if (!nulls[i])
+			assert_valid_location(locations[i].lng, locations[i].lat);
+
+	for (int i = 0; i < count; i++)
+	{
+		locations[i].lng = degsToRads(locations[i].lng);
+		locations[i].lat = degsToRads(locations[i].lat);
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (nulls[i])
+			continue;
+		h3_assert(latLngToCell(&locations[i], resolution, &cell));
+		cells[i] = H3IndexGetDatum(cell);
+	}
+}
+
+/*
+ * Indexes an array of locations (or arrays of latitudes and longitudes) at
+ * the specified resolution. NULL locations give NULL cells.
+ */
+Datum
+h3_latlng_to_cells(PG_FUNCTION_ARGS)
+{
+	Oid			elmtype = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	int			resolution = PG_GETARG_INT32(PG_NARGS() - 1);
+	int16		elmlen;
+	bool		elmbyval;
+	char		elmalign;
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	int			count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	LatLng	   *locations = palloc0(count * sizeof(LatLng));
+	bool	   *nulls = palloc(count * sizeof(bool));
+	Datum	   *cells = palloc(count * sizeof(Datum));
+	int			dims[1] = {count};
+	int			lbs[1] = {1};
+	ArrayIterator iterator = array_create_iterator(array, 0, NULL);
+	Datum		value;
+	bool		isnull;
+
+	if (PG_NARGS() == 2)
+	{
+		/* point[] */
+		for (int i = 0; array_iterate(iterator, &value, &isnull); i++)
+		{
+			nulls[i] = isnull;
+			if (isnull)
+				continue;
+			locations[i].lng = DatumGetPointP(value)->x;
+			locations[i].lat = DatumGetPointP(value)->y;
+		}
+	}
+	else
+	{
+		/* latitudes and longitudes */
+		ArrayType  *lngs = PG_GETARG_ARRAYTYPE_P(1);
+		ArrayIterator lngIterator = array_create_iterator(lngs, 0, NULL);
+
+		ASSERT(
+			   count == ArrayGetNItems(ARR_NDIM(lngs), ARR_DIMS(lngs)),
+			   ERRCODE_ARRAY_SUBSCRIPT_ERROR,
+			   "Latitude and longitude arrays must have the same length."
+			);
+
+		for (int i = 0; array_iterate(iterator, &value, &isnull); i++)
+		{
+			nulls[i] = isnull;
+			if (!isnull)
+				locations[i].lat = DatumGetFloat8(value);
+
+			array_iterate(lngIterator, &value, &isnull);
+			nulls[i] = nulls[i] || isnull;
+			if (!isnull)
+				locations[i].lng = DatumGetFloat8(value);
+		}
+		array_free_iterator(lngIterator);
+	}
+	array_free_iterator(iterator);
+
+	latlngs_to_cells(locations, nulls, count, resolution, cells);
+
+	/* build the array */
+	get_typlenbyvalalign(elmtype, &elmlen, &elmbyval, &elmalign);
+	PG_RETURN_ARRAYTYPE_P(construct_md_array(cells, nulls, count > 0 ? 1 : 0, dims, lbs,
+											 elmtype, elmlen, elmbyval, elmalign));
+}
+
 /* Finds the centroid of the index */
 Datum
 h3_cell_to_latlng(PG_FUNCTION_ARGS)
@@ -85,19 +203,52 @@ h3_cell_to_latlng(PG_FUNCTION_ARGS)
 	PG_RETURN_POINT_P(point);
 }
 
+/*
+ * Writes the vertexes of boundary as x/y pairs in degrees, optionally
+ * extending longitudes across the antimeridian from the first vertex
+ */
+static void
+boundary_to_degrees(const CellBoundary *boundary, bool extend, double *out)
+{
+	double		delta,
+				firstLon,
+				lon,
+				lat;
+
+	firstLon = boundary->verts[0].lng;
+	if (firstLon < 0)
+	{
+		delta = -2 * M_PI;
+	}
+	else
+	{
+		delta = +2 * M_PI;
+	}
+
+	for (int v = 0; v < boundary->numVerts; v++)
+	{
+		lon = boundary->verts[v].lng;
+		lat = boundary->verts[v].lat;
+
+		/* check if different sign */
+		if (extend && fabs(lon - firstLon) > M_PI)
+			lon = lon + delta;
+
+		*out++ = radsToDegs(lon);
+		*out++ = radsToDegs(lat);
+	}
+}
+
 /* Finds the boundary of the index */
 Datum
 h3_cell_to_boundary(PG_FUNCTION_ARGS)
 {
 	H3Index		cell = PG_GETARG_H3INDEX(0);
 
-	double		delta,
-				firstLon,
-				lon,
-				lat;
 	int			size;
 	POLYGON    *polygon;
 	CellBoundary boundary;
+	double		coords[2 * MAX_CELL_BNDRY_VERTS];
 
 	/* DEPRECATION BEGIN: Remove next major */
 	bool		extend;
@@ -120,28 +271,127 @@ h3_cell_to_boundary(PG_FUNCTION_ARGS)
 	SET_VARSIZE(polygon, size);
 	polygon->npts = boundary.numVerts;
 
-	firstLon = boundary.verts[0].lng;
-	if (firstLon < 0)
+	boundary_to_degrees(&boundary, extend, coords);
+	for (int v = 0; v < boundary.numVerts; v++)
 	{
-		delta = -2 * M_PI;
+		polygon->p[v].x = coords[2 * v];
+		polygon->p[v].y = coords[2 * v + 1];
 	}
-	else
+
+	PG_RETURN_POLYGON_P(polygon);
+}
+
+/*
+ * Allocates a one dimensional array of count elements of a fixed size,
+ * pass by value type without nulls, for the caller to fill in place.
+ */
+static ArrayType *
+make_flat_array(int count, Oid elmtype, int elmlen)
+{
+	Size		size = ARR_OVERHEAD_NONULLS(1) + (Size) count * elmlen;
+	ArrayType  *array;
+
+	if (count == 0)
+		return construct_empty_array(elmtype);
+
+	array = palloc0(size);
+	SET_VARSIZE(array, size);
+	array->ndim = 1;
+	array->dataoffset = 0;
+	array->elemtype = elmtype;
+	ARR_DIMS(array)[0] = count;
+	ARR_LBOUND(array)[0] = 1;
+	return array;
+}
+
+/*
+ * Finds the centroids of an array of cells, as a flat array of x/y (lng/lat)
+ * pairs in degrees. NULL cells give a NaN pair.
+ */
+Datum
+h3_cells_to_latlngs(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	int			count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	ArrayType  *result = make_flat_array(2 * count, FLOAT8OID, sizeof(float8));
+	double	   *out = (double *) ARR_DATA_PTR(result);
+	ArrayIterator iterator = array_create_iterator(array, 0, NULL);
+	Datum		value;
+	bool		isnull;
+	LatLng		center;
+
+	while (array_iterate(iterator, &value, &isnull))
 	{
-		delta = +2 * M_PI;
+		if (isnull)
+		{
+			*out++ = get_float8_nan();
+			*out++ = get_float8_nan();
+			continue;
+		}
+
+		h3_assert(cellToLatLng(DatumGetH3Index(value), &center));
+		*out++ = radsToDegs(center.lng);
+		*out++ = radsToDegs(center.lat);
 	}
+	array_free_iterator(iterator);
 
-	for (int v = 0; v < boundary.numVerts; v++)
-	{
-		lon = boundary.verts[v].lng;
-		lat = boundary.verts[v].lat;
+	PG_RETURN_ARRAYTYPE_P(result);
+}
 
-		/* check if different sign */
-		if (extend && fabs(lon - firstLon) > M_PI)
-			lon = lon + delta;
+/*
+ * Finds the boundaries of an array of cells, as a flat array of x/y (lng/lat)
+ * pairs in degrees, and the offsets of each boundary within it.
+ *
+ * Offsets number pairs from zero, with a final offset past the last boundary,
+ * so the boundary of cell i spans pairs offsets[i] up to offsets[i + 1].
+ * NULL cells give empty boundaries.
+ */
+Datum
+h3_cells_to_boundaries(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	int			count = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	ArrayIterator iterator = array_create_iterator(array, 0, NULL);
+	Datum		value;
+	bool		isnull;
+	CellBoundary *boundaries = palloc(count * sizeof(CellBoundary));
+	ArrayType  *offsets = make_flat_array(count + 1, INT4OID, sizeof(int32));
+	int32	   *offset = (int32 *) ARR_DATA_PTR(offsets);
+	ArrayType  *coords;
+	double	   *out;
+
+	TupleDesc	tuple_desc;
+	Datum		values[2];
+	bool		nulls[2] = {false};
 
-		polygon->p[v].x = radsToDegs(lon);
-		polygon->p[v].y = radsToDegs(lat);
+	/* first pass finds boundaries and offsets, sizing the coordinates */
+	offset[0] = 0;
+	for (int i = 0; array_iterate(iterator, &value, &isnull); i++)
+	{
+		boundaries[i].numVerts = 0;
+		if (!isnull)
+			h3_assert(cellToBoundary(DatumGetH3Index(value), &boundaries[i]));
+		offset[i + 1] = offset[i] + boundaries[i].numVerts;
 	}
+	array_free_iterator(iterator);
 
-	PG_RETURN_POLYGON_P(polygon);
+	/* second pass writes them out */
+	coords = make_flat_array(2 * offset[count], FLOAT8OID, sizeof(float8));
+	out = (double *) ARR_DATA_PTR(coords);
+	for (int i = 0; i < count; i++)
+	{
+		if (boundaries[i].numVerts == 0)
+			continue;
+		boundary_to_degrees(&boundaries[i], h3_guc_extend_antimeridian, out);
+		out += 2 * boundaries[i].numVerts;
+	}
+	pfree(boundaries);
+
+	ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+
+	values[0] = PointerGetDatum(coords);
+	values[1] = PointerGetDatum(offsets);
+
+	tuple_desc = BlessTupleDesc(tuple_desc);
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tuple_desc, values, nulls)));
 }
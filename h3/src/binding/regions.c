@@ -27,8 +27,10 @@
 #include <utils/builtins.h>		 // text_to_cstring
 
 #include "error.h"
+#include "guc.h"
+#include "iterator.h"
+#include "stat.h"
 #include "type.h"
-#include "srf.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_to_cells);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_to_cells_experimental);
@@ -77,11 +79,28 @@ linkedGeoLoopToNativePolygon(LinkedGeoLoop * linkedLoop, POLYGON *polygon)
 	}
 }
 
+/*
+ * Returns the next cell of the polygon iterator in user fctx. Polygons too
+ * large for h3.polygon_to_cells_chunk_size are filled in bands of latitude,
+ * so memory grows with the width of the polygon rather than its area.
+ */
+static Datum
+polygonIteratorNext(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx = SRF_PERCALL_SETUP();
+	H3Index		cell;
+
+	if (iterator_polygon_next(funcctx->user_fctx, &cell))
+		SRF_RETURN_NEXT(funcctx, H3IndexGetDatum(cell));
+
+	SRF_RETURN_DONE(funcctx);
+}
+
 /*
  * H3Error polygonToCells(const GeoPolygon *geoPolygon, int res, uint32_t flags, H3Index *out);
  */
-Datum
-h3_polygon_to_cells(PG_FUNCTION_ARGS)
+static Datum
+h3_polygon_to_cells_internal(PG_FUNCTION_ARGS)
 {
 	if (SRF_IS_FIRSTCALL())
 	{
@@ -89,8 +108,7 @@ h3_polygon_to_cells(PG_FUNCTION_ARGS)
 		MemoryContext oldcontext =
 		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
 
-		int64_t		maxSize;
-		H3Index    *indices;
+		H3PolygonIterator *iter;
 		ArrayType  *holes;
 		int			nelems = 0;
 		int			resolution;
@@ -143,25 +161,29 @@ h3_polygon_to_cells(PG_FUNCTION_ARGS)
 			polygon.numHoles = 0;
 		}
 
-		/* produce hexagons into allocated memory */
-		h3_assert(maxPolygonToCellsSize(&polygon, resolution, 0, &maxSize));
-		indices = palloc_extended(maxSize * sizeof(H3Index),
-								  MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
-		h3_assert(polygonToCells(&polygon, resolution, 0, indices));
+		/* produce hexagons a band at a time */
+		iter = palloc(sizeof(H3PolygonIterator));
+		iterator_polygon_init(iter, &polygon, resolution, 0, false,
+							  h3_guc_polygon_to_cells_chunk_size);
 
-		funcctx->user_fctx = indices;
-		funcctx->max_calls = maxSize;
+		funcctx->user_fctx = iter;
 		MemoryContextSwitchTo(oldcontext);
 	}
 
-	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
+	return polygonIteratorNext(fcinfo);
+}
+
+Datum
+h3_polygon_to_cells(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_POLYFILL, h3_polygon_to_cells_internal, fcinfo);
 }
 
 /*
  * H3Error polygonToCells(const GeoPolygon *geoPolygon, int res, uint32_t flags, H3Index *out);
  */
-Datum
-h3_polygon_to_cells_experimental(PG_FUNCTION_ARGS)
+static Datum
+h3_polygon_to_cells_experimental_internal(PG_FUNCTION_ARGS)
 {
 	if (SRF_IS_FIRSTCALL())
 	{
@@ -170,8 +192,7 @@ h3_polygon_to_cells_experimental(PG_FUNCTION_ARGS)
 		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
 
 		char       *containment_mode;
-		int64_t		maxSize;
-		H3Index    *indices;
+		H3PolygonIterator *iter;
 		ArrayType  *holes;
 		int			nelems = 0;
 		uint32_t	flags = 0;
@@ -239,25 +260,29 @@ h3_polygon_to_cells_experimental(PG_FUNCTION_ARGS)
 			polygon.numHoles = 0;
 		}
 
-		/* produce hexagons into allocated memory */
-		h3_assert(maxPolygonToCellsSizeExperimental(&polygon, resolution, flags, &maxSize));
-		indices = palloc_extended(maxSize * sizeof(H3Index),
-								  MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
-		h3_assert(polygonToCellsExperimental(&polygon, resolution, flags, maxSize, indices));
+		/* produce hexagons a band at a time */
+		iter = palloc(sizeof(H3PolygonIterator));
+		iterator_polygon_init(iter, &polygon, resolution, flags, true,
+							  h3_guc_polygon_to_cells_chunk_size);
 
-		funcctx->user_fctx = indices;
-		funcctx->max_calls = maxSize;
+		funcctx->user_fctx = iter;
 		MemoryContextSwitchTo(oldcontext);
 	}
 
-	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
+	return polygonIteratorNext(fcinfo);
+}
+
+Datum
+h3_polygon_to_cells_experimental(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_POLYFILL, h3_polygon_to_cells_experimental_internal, fcinfo);
 }
 
 /*
  * https://stackoverflow.com/questions/51127189/how-to-return-array-into-array-with-custom-type-in-postgres-c-function
  */
-Datum
-h3_cells_to_multi_polygon(PG_FUNCTION_ARGS)
+static Datum
+h3_cells_to_multi_polygon_internal(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
 	TupleDesc	tuple_desc;
@@ -376,6 +401,12 @@ h3_cells_to_multi_polygon(PG_FUNCTION_ARGS)
 	}
 }
 
+Datum
+h3_cells_to_multi_polygon(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_DISSOLVE, h3_cells_to_multi_polygon_internal, fcinfo);
+}
+
 /* ---------------------------------------------------------------------------
  * The GeoPolygon, LinkedLatLng, LinkedLatLng,
  * LinkedGeoLoop, and LinkedGeoPolygon
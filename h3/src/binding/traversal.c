@@ -17,11 +17,14 @@
 #include <postgres.h>
 #include <h3api.h>
 
-#include <fmgr.h>			 // PG_FUNCTION_ARGS
-#include <funcapi.h>		 // SRF_IS_FIRSTCALL
-#include <utils/geo_decls.h> // PG_GETARG_POINT_P
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <funcapi.h>			 // SRF_IS_FIRSTCALL
+#include <access/htup_details.h> // heap_form_tuple
+#include <utils/geo_decls.h>	 // PG_GETARG_POINT_P
 
 #include "error.h"
+#include "iterator.h"
+#include "stat.h"
 #include "type.h"
 #include "srf.h"
 
@@ -39,38 +42,53 @@ PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_local_ij_to_cell);
  * k-ring 0 is defined as the origin index, k-ring 1 is defined as k-ring 0 and
  * all neighboring indices, and so on.
  *
- * Output is placed in the provided array in no particular order.
- * There may be fewer elements in output, as can happen when crossing a
- * pentagon.
+ * Output is produced ring by ring, keeping only the current and previous
+ * ring in memory. There may be fewer elements in output, as can happen when
+ * crossing a pentagon.
  */
-Datum
-h3_grid_disk(PG_FUNCTION_ARGS)
+static Datum
+h3_grid_disk_internal(PG_FUNCTION_ARGS)
 {
+	FuncCallContext *funcctx;
+	H3DiskIterator *iter;
+	H3Index		cell;
+	int			distance;
+
 	if (SRF_IS_FIRSTCALL())
 	{
-		FuncCallContext *funcctx = SRF_FIRSTCALL_INIT();
-		MemoryContext oldcontext =
-		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
-
+		MemoryContext oldcontext;
 		int64_t		max;
-		H3Index    *indices;
 
 		/* get function arguments */
 		H3Index		origin = PG_GETARG_H3INDEX(0);
 		int			k = PG_GETARG_INT32(1);
 
-		h3_assert(maxGridDiskSize(k, &max));
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
 
-		indices = palloc(max * sizeof(H3Index));
+		/* ensure valid k */
+		h3_assert(maxGridDiskSize(k, &max));
 
-		h3_assert(gridDisk(origin, k, indices));
+		iter = palloc(sizeof(H3DiskIterator));
+		iterator_disk_init(iter, origin, k);
 
-		funcctx->user_fctx = indices;
-		funcctx->max_calls = max;
+		funcctx->user_fctx = iter;
 		MemoryContextSwitchTo(oldcontext);
 	}
 
-	SRF_RETURN_H3_INDEXES_FROM_USER_FCTX();
+	funcctx = SRF_PERCALL_SETUP();
+	iter = funcctx->user_fctx;
+
+	if (iterator_disk_next(iter, &cell, &distance))
+		SRF_RETURN_NEXT(funcctx, H3IndexGetDatum(cell));
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+Datum
+h3_grid_disk(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_DISK, h3_grid_disk_internal, fcinfo);
 }
 
 /*
@@ -79,51 +97,67 @@ h3_grid_disk(PG_FUNCTION_ARGS)
  * k-ring 0 is defined as the origin index, k-ring 1 is defined as k-ring 0 and
  * all neighboring indices, and so on.
  *
- * Output is placed in the provided array in no particular order.
+ * Output is produced ring by ring, paired with the distance of the ring.
  * There may be fewer elements in output, as can happen when crossing a
  * pentagon.
  */
-Datum
-h3_grid_disk_distances(PG_FUNCTION_ARGS)
+static Datum
+h3_grid_disk_distances_internal(PG_FUNCTION_ARGS)
 {
+	FuncCallContext *funcctx;
+	H3DiskIterator *iter;
+	H3Index		cell;
+	int			distance;
+
 	if (SRF_IS_FIRSTCALL())
 	{
-		FuncCallContext *funcctx = SRF_FIRSTCALL_INIT();
-		MemoryContext oldcontext =
-		MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		MemoryContext oldcontext;
 		TupleDesc	tuple_desc;
+		int64_t		max;
 
 		/* get function arguments */
 		H3Index		origin = PG_GETARG_H3INDEX(0);
 		int			k = PG_GETARG_INT32(1);
 
-		/*
-		 * Allocate memory for the indices, the distances and the tuple used
-		 * for
-		 */
-		/* returning */
-		int64_t		maxSize;
-		hexDistanceTuple *user_fctx;
-
-		h3_assert(maxGridDiskSize(k, &maxSize));
-
-		user_fctx = palloc(sizeof(hexDistanceTuple));
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
 
-		user_fctx->indices = palloc(maxSize * sizeof(H3Index));
-		user_fctx->distances = palloc(maxSize * sizeof(int));
+		/* ensure valid k */
+		h3_assert(maxGridDiskSize(k, &max));
 
-		h3_assert(gridDiskDistances(origin, k, user_fctx->indices, user_fctx->distances));
+		iter = palloc(sizeof(H3DiskIterator));
+		iterator_disk_init(iter, origin, k);
 
 		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
 
 		funcctx->tuple_desc = BlessTupleDesc(tuple_desc);
-		funcctx->max_calls = maxSize;
-		funcctx->user_fctx = user_fctx;
-
+		funcctx->user_fctx = iter;
 		MemoryContextSwitchTo(oldcontext);
 	}
 
-	SRF_RETURN_H3_INDEX_DISTANCES_FROM_USER_FCTX();
+	funcctx = SRF_PERCALL_SETUP();
+	iter = funcctx->user_fctx;
+
+	if (iterator_disk_next(iter, &cell, &distance))
+	{
+		Datum		values[2];
+		bool		nulls[2] = {false};
+		HeapTuple	tuple;
+
+		values[0] = H3IndexGetDatum(cell);
+		values[1] = Int32GetDatum(distance);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+Datum
+h3_grid_disk_distances(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_DISK, h3_grid_disk_distances_internal, fcinfo);
 }
 
 /*
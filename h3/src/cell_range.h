@@ -0,0 +1,175 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_CELL_RANGE_H
+#define H3_CELL_RANGE_H
+
+#include <h3api.h>
+
+#include "upstream_macros.h"
+
+/*
+ * Bit level helpers for the cell hierarchy.
+ *
+ * Setting the resolution of a cell to 15 and its unused digits to 0 (or
+ * keeping them at 7) yields the lowest (or highest) index a res 15 descendant
+ * could possibly have. These ranges nest exactly like the cells themselves,
+ * so containment can be tested with two integer comparisons instead of
+ * calling cellToParent.
+ */
+
+/* 1's in all digit bits */
+#define H3_DIGITS_MASK ((((uint64_t) 1) << H3_BC_OFFSET) - 1)
+
+/* 1's in the digit bits finer than the given resolution */
+#define H3_DIGITS_BELOW(res) \
+	((((uint64_t) 1) << ((MAX_H3_RES - (res)) * H3_PER_DIGIT_OFFSET)) - 1)
+
+/* Resolution 0 cell of base cell */
+static inline H3Index
+cell_range_base_cell(int baseCell)
+{
+	return H3_INIT
+		| ((uint64_t) H3_CELL_MODE << H3_MODE_OFFSET)
+		| ((uint64_t) baseCell << H3_BC_OFFSET);
+}
+
+/* Child of cell with the given digit at the next resolution */
+static inline H3Index
+cell_range_child(H3Index cell, int digit)
+{
+	int			res = H3_GET_RESOLUTION(cell) + 1;
+
+	H3_SET_RESOLUTION(cell, res);
+	H3_SET_INDEX_DIGIT(cell, res, digit);
+	return cell;
+}
+
+/*
+ * Cell an index belongs to in the hierarchy: the index itself for cells, the
+ * origin (or owner) cell for directed edges (or vertexes).
+ */
+static inline H3Index
+cell_range_owner(H3Index h3)
+{
+	return (h3 & ~(H3_HIGH_BIT_MASK | H3_MODE_MASK | H3_RESERVED_MASK))
+		| ((uint64_t) H3_CELL_MODE << H3_MODE_OFFSET);
+}
+
+/* Lowest res 15 index within cell */
+static inline H3Index
+cell_range_min(H3Index cell)
+{
+	int			res = H3_GET_RESOLUTION(cell);
+
+	return ((cell | H3_RES_MASK) & ~H3_DIGITS_BELOW(res));
+}
+
+/* Highest res 15 index within cell */
+static inline H3Index
+cell_range_max(H3Index cell)
+{
+	int			res = H3_GET_RESOLUTION(cell);
+
+	return ((cell | H3_RES_MASK) | H3_DIGITS_BELOW(res));
+}
+
+/* True if a contains (or equals) b */
+static inline bool
+cell_range_contains(H3Index a, H3Index b)
+{
+	return cell_range_min(a) <= cell_range_min(b)
+		&& cell_range_max(b) <= cell_range_max(a);
+}
+
+/* True if either cell contains the other */
+static inline bool
+cell_range_overlaps(H3Index a, H3Index b)
+{
+	return cell_range_min(a) <= cell_range_max(b)
+		&& cell_range_min(b) <= cell_range_max(a);
+}
+
+/*
+ * Lowest common ancestor of two cells,
+ * or H3_NULL if they are not cells or do not share a base cell.
+ */
+static inline H3Index
+cell_range_common_ancestor(H3Index a, H3Index b)
+{
+	int			res = Min(H3_GET_RESOLUTION(a), H3_GET_RESOLUTION(b));
+	uint64_t	diff = (a ^ b);
+
+	if (H3_GET_MODE(a) != H3_CELL_MODE || (diff & ~(H3_RES_MASK | H3_DIGITS_MASK)))
+		return H3_NULL;
+
+	/* step up until all digits down to res are shared */
+	diff &= H3_DIGITS_MASK;
+	while (res > 0 && (diff >> ((MAX_H3_RES - res) * H3_PER_DIGIT_OFFSET)))
+		res--;
+
+	return (a & ~(H3_RES_MASK | H3_DIGITS_BELOW(res)))
+		| ((uint64_t) res << H3_RES_OFFSET)
+		| H3_DIGITS_BELOW(res);
+}
+
+/*
+ * Sort key ordering indexes by mode, base cell, digits (unused digits lowest)
+ * and finally resolution. Ancestors sort immediately before their
+ * descendants, so every cell is followed by its entire subtree.
+ *
+ * Packs into 63 bits, and is unique for valid indexes.
+ */
+static inline uint64_t
+cell_range_hierarchy_key(H3Index h3)
+{
+	int			res = H3_GET_RESOLUTION(h3);
+	uint64_t	digits = h3 & H3_DIGITS_MASK & ~H3_DIGITS_BELOW(res);
+
+	return ((h3 >> 56) << 56)
+		| ((uint64_t) H3_GET_BASE_CELL(h3) << 49)
+		| (digits << 4)
+		| (uint64_t) res;
+}
+
+/* Cell with the given hierarchy key, the inverse of cell_range_hierarchy_key */
+static inline H3Index
+cell_range_from_hierarchy_key(uint64_t key)
+{
+	int			res = key & 15;
+
+	return ((key >> 56) << 56)
+		| ((uint64_t) res << H3_RES_OFFSET)
+		| (((key >> 49) & 127) << H3_BC_OFFSET)
+		| ((key >> 4) & H3_DIGITS_MASK)
+		| H3_DIGITS_BELOW(res);
+}
+
+/* Compares in hierarchy order, falling back to raw value for invalid indexes */
+static inline int
+cell_range_hierarchy_cmp(H3Index a, H3Index b)
+{
+	uint64_t	aKey = cell_range_hierarchy_key(a);
+	uint64_t	bKey = cell_range_hierarchy_key(b);
+
+	if (aKey != bKey)
+		return (aKey < bKey) ? -1 : 1;
+	if (a != b)
+		return (a < b) ? -1 : 1;
+	return 0;
+}
+
+#endif							/* H3_CELL_RANGE_H */
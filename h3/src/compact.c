@@ -0,0 +1,207 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
+#include <h3api.h>
+
+#include <fmgr.h>			 // PG_FUNCTION_ARGS
+#include <utils/array.h>	 // construct_array
+#include <utils/lsyscache.h> // get_typlenbyvalalign
+
+#include "cell_buffer.h"
+#include "cell_range.h"
+#include "compact.h"
+#include "error.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_compact_agg_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_compact_agg_combinefn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_compact_agg_serialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_compact_agg_deserialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_compact_agg_finalfn);
+
+static int
+compact_cmp(const void *a, const void *b)
+{
+	return cell_range_hierarchy_cmp(*(const H3Index *) a, *(const H3Index *) b);
+}
+
+int64
+compact_cells(H3Index * cells, int64 count)
+{
+	qsort(cells, count, sizeof(H3Index), compact_cmp);
+	return compact_sorted_cells(cells, count);
+}
+
+/*
+ * Sorting in hierarchy order puts every cell right before its descendants,
+ * so duplicates and covered cells are dropped in a single pass. Each
+ * remaining complete set of siblings is then contiguous, and is replaced by
+ * its parent, finest resolution first so merged parents can merge further.
+ */
+int64
+compact_sorted_cells(H3Index * cells, int64 count)
+{
+	int64		n = 0;
+
+	/* drop duplicates and descendants of preceding cells */
+	for (int64 i = 0; i < count; i++)
+		if (n == 0 || !cell_range_contains(cells[n - 1], cells[i]))
+			cells[n++] = cells[i];
+
+	/* replace complete sets of siblings with their parent */
+	for (int res = MAX_H3_RES; res > 0; res--)
+	{
+		int64		m = 0;
+
+		for (int64 i = 0; i < n;)
+		{
+			H3Index		parent = cells[i];
+			int64		j = i + 1;
+
+			if (H3_GET_RESOLUTION(cells[i]) != res)
+			{
+				cells[m++] = cells[i++];
+				continue;
+			}
+
+			H3_SET_RESOLUTION(parent, res - 1);
+			H3_SET_INDEX_DIGIT(parent, res, INVALID_DIGIT);
+			while (j < n
+				   && H3_GET_RESOLUTION(cells[j]) == res
+				   && cell_range_contains(parent, cells[j]))
+				j++;
+
+			if (j - i == NUM_DIGITS || (j - i == NUM_DIGITS - 1 && isPentagon(parent)))
+				cells[m++] = parent;
+			else
+				while (i < j)
+					cells[m++] = cells[i++];
+			i = j;
+		}
+		n = m;
+	}
+
+	return n;
+}
+
+Datum
+h3_compact_agg_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	H3CellBuffer *state = PG_ARGISNULL(0) ? NULL : (H3CellBuffer *) PG_GETARG_POINTER(0);
+	H3Index		cell;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "h3_compact_agg_transfn called in non-aggregate context");
+
+	if (PG_ARGISNULL(1))
+	{
+		if (state == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state);
+	}
+
+	cell = PG_GETARG_H3INDEX(1);
+	if (!isValidCell(cell))
+		h3_assert(E_CELL_INVALID);
+
+	if (state == NULL)
+		state = cell_buffer_create(aggcontext, 0, compact_cells);
+
+	cell_buffer_append(state, &cell, 1);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* Appends the cells of the second state to the first */
+Datum
+h3_compact_agg_combinefn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	H3CellBuffer *state1 = PG_ARGISNULL(0) ? NULL : (H3CellBuffer *) PG_GETARG_POINTER(0);
+	H3CellBuffer *state2 = PG_ARGISNULL(1) ? NULL : (H3CellBuffer *) PG_GETARG_POINTER(1);
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "h3_compact_agg_combinefn called in non-aggregate context");
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
+	}
+
+	if (state1 == NULL)
+		state1 = cell_buffer_create(aggcontext, state2->count, compact_cells);
+
+	cell_buffer_append(state1, state2->cells, state2->count);
+
+	PG_RETURN_POINTER(state1);
+}
+
+/* Serializes the compacted cells, so workers only send their compacted part */
+Datum
+h3_compact_agg_serialfn(PG_FUNCTION_ARGS)
+{
+	H3CellBuffer *state = (H3CellBuffer *) PG_GETARG_POINTER(0);
+
+	PG_RETURN_BYTEA_P(cell_buffer_serialize(state));
+}
+
+Datum
+h3_compact_agg_deserialfn(PG_FUNCTION_ARGS)
+{
+	bytea	   *bytes = PG_GETARG_BYTEA_PP(0);
+
+	PG_RETURN_POINTER(cell_buffer_deserialize(bytes, compact_cells));
+}
+
+Datum
+h3_compact_agg_finalfn(PG_FUNCTION_ARGS)
+{
+	H3CellBuffer *state = (H3CellBuffer *) PG_GETARG_POINTER(0);
+	Oid			elmtype = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	int16		elmlen;
+	bool		elmbyval;
+	char		elmalign;
+	Datum	   *cells;
+
+	/*
+	 * Compacting in place does not change the set, but does modify the
+	 * state, hence finalfunc_modify = read_write.
+	 */
+	cell_buffer_reduce(state);
+	ASSERT(
+		   state->count <= MaxArraySize,
+		   ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		   "Compacted set of %lld cells exceeds the maximum array size.",
+		   (long long) state->count
+		);
+
+	cells = palloc_extended(Max(state->count, 1) * sizeof(Datum), MCXT_ALLOC_HUGE);
+	for (int64 i = 0; i < state->count; i++)
+		cells[i] = H3IndexGetDatum(state->cells[i]);
+
+	get_typlenbyvalalign(elmtype, &elmlen, &elmbyval, &elmalign);
+	PG_RETURN_ARRAYTYPE_P(construct_array(cells, state->count, elmtype,
+										  elmlen, elmbyval, elmalign));
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_COMPACT_H
+#define H3_COMPACT_H
+
+#include <h3api.h>
+
+/*
+ * Compacts cells in place, returning the new count. Unlike compactCells,
+ * resolutions may be mixed and cells may overlap. The result covers the
+ * union of the input, sorted in hierarchy order.
+ */
+int64		compact_cells(H3Index * cells, int64 count);
+
+/* Same as compact_cells, for cells already sorted in hierarchy order */
+int64		compact_sorted_cells(H3Index * cells, int64 count);
+
+#endif							/* H3_COMPACT_H */
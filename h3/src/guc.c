@@ -18,8 +18,12 @@
 
 #include <utils/guc.h> // DefineCustom*Variable
 
+#include "iterator.h"
+
 bool		h3_guc_strict = false;
 bool		h3_guc_extend_antimeridian = false;
+int			h3_guc_polygon_to_cells_chunk_size = POLYGON_TO_CELLS_CHUNK_SIZE;
+bool		h3_guc_track_functions = false;
 
 void
 _guc_init(void)
@@ -45,4 +49,28 @@ _guc_init(void)
 							 NULL,
 							 NULL,
 							 NULL);
+
+	DefineCustomIntVariable("h3.polygon_to_cells_chunk_size",
+			 "Maximum number of cells polygon_to_cells fills at a time.",
+							 "Larger polygons are filled in bands of latitude.",
+							 &h3_guc_polygon_to_cells_chunk_size,
+							 POLYGON_TO_CELLS_CHUNK_SIZE,
+							 1,
+							 INT_MAX,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomBoolVariable("h3.track_functions",
+				"Collect runtime statistics of h3 functions.",
+							 "Requires h3 in shared_preload_libraries.",
+							 &h3_guc_track_functions,
+							 false,
+							 PGC_SUSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
 }
@@ -19,6 +19,8 @@
 
 extern bool h3_guc_strict;
 extern bool h3_guc_extend_antimeridian;
+extern int	h3_guc_polygon_to_cells_chunk_size;
+extern bool h3_guc_track_functions;
 
 void _guc_init(void);
 
@@ -0,0 +1,720 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
+#include <h3api.h>
+
+#include <ctype.h>			 // isspace
+#include <fmgr.h>			 // PG_FUNCTION_ARGS
+#include <lib/stringinfo.h>	 // StringInfo
+#include <libpq/pqformat.h>	 // needed for send/recv functions
+#include <utils/array.h>	 // construct_array
+#include <utils/lsyscache.h> // get_typlenbyvalalign
+
+#include "cell_buffer.h"
+#include "cell_range.h"
+#include "compact.h"
+#include "error.h"
+#include "h3set.h"
+#include "hex.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_in);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_out);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_recv);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_send);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_eq);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_ne);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_contains);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_contained_by);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_union);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_intersection);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_difference);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_array_to_h3set);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_to_h3index_array);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_union_agg_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3set_agg_finalfn);
+
+static int
+varint_size(uint64 value)
+{
+	int			size = 1;
+
+	while (value >>= 7)
+		size++;
+	return size;
+}
+
+static uint8 *
+varint_write(uint8 * out, uint64 value)
+{
+	while (value >= 0x80)
+	{
+		*out++ = (uint8) (value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (uint8) value;
+	return out;
+}
+
+static const uint8 *
+varint_read(const uint8 * in, uint64 *value)
+{
+	uint64		result = 0;
+	int			shift = 0;
+
+	while (*in & 0x80)
+	{
+		result |= (uint64) (*in++ & 0x7F) << shift;
+		shift += 7;
+	}
+	*value = result | ((uint64) *in++ << shift);
+	return in;
+}
+
+/*
+ * Keys within a block are stored as the difference of their digits (and base
+ * cell) to the previous key. Digits of neighbouring cells only differ at
+ * their resolution, so the difference is shifted right by whole digits,
+ * stored in a byte alongside the resolution, followed by the rest as varint.
+ */
+static int
+delta_split(uint64 prev, uint64 key, uint64 *diff)
+{
+	int			shift = 0;
+
+	*diff = (key >> 4) - (prev >> 4);
+	while (shift < 15 && *diff && (*diff & 7) == 0)
+	{
+		*diff >>= 3;
+		shift++;
+	}
+	return shift;
+}
+
+static int
+delta_size(uint64 prev, uint64 key)
+{
+	uint64		diff;
+
+	delta_split(prev, key, &diff);
+	return 1 + varint_size(diff);
+}
+
+static uint8 *
+delta_write(uint8 * out, uint64 prev, uint64 key)
+{
+	uint64		diff;
+	int			shift = delta_split(prev, key, &diff);
+
+	*out++ = (uint8) ((shift << 4) | (key & 15));
+	return varint_write(out, diff);
+}
+
+static const uint8 *
+delta_read(const uint8 * in, uint64 prev, uint64 *key)
+{
+	int			shift = *in >> 4;
+	int			res = *in & 15;
+	uint64		diff;
+
+	in = varint_read(in + 1, &diff);
+	*key = (((prev >> 4) + (diff << (shift * 3))) << 4) | res;
+	return in;
+}
+
+static int
+h3set_block_count(const H3Set * set, int32 block)
+{
+	return Min(H3SET_BLOCK_SIZE, set->count - (int64) block * H3SET_BLOCK_SIZE);
+}
+
+H3Set *
+h3set_from_cells(const H3Index * cells, int64 count)
+{
+	int64		numBlocks = (count + H3SET_BLOCK_SIZE - 1) / H3SET_BLOCK_SIZE;
+	Size		size = sizeof(H3Set) + numBlocks * (sizeof(uint64) + sizeof(uint32));
+	uint64		prev = 0;
+	H3Set	   *set;
+	uint64	   *keys;
+	uint32	   *offsets;
+	uint8	   *data;
+	uint8	   *out;
+
+	/* first pass only sizes the deltas */
+	for (int64 i = 0; i < count; i++)
+	{
+		uint64		key = cell_range_hierarchy_key(cells[i]);
+
+		if (i % H3SET_BLOCK_SIZE != 0)
+			size += delta_size(prev, key);
+		prev = key;
+	}
+
+	ASSERT(
+		   size <= MaxAllocSize,
+		   ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		   "Set of %lld cells exceeds the maximum h3set size.",
+		   (long long) count
+		);
+
+	set = palloc0(size);
+	SET_VARSIZE(set, size);
+	set->count = count;
+	set->numBlocks = numBlocks;
+
+	keys = H3SET_KEYS(set);
+	offsets = H3SET_OFFSETS(set);
+	data = H3SET_DATA(set);
+	out = data;
+	for (int64 i = 0; i < count; i++)
+	{
+		uint64		key = cell_range_hierarchy_key(cells[i]);
+
+		if (i % H3SET_BLOCK_SIZE == 0)
+		{
+			keys[i / H3SET_BLOCK_SIZE] = key;
+			offsets[i / H3SET_BLOCK_SIZE] = out - data;
+		}
+		else
+			out = delta_write(out, prev, key);
+		prev = key;
+	}
+
+	return set;
+}
+
+H3Index *
+h3set_cells(const H3Set * set)
+{
+	const uint64 *keys = H3SET_KEYS(set);
+	const uint8 *in = H3SET_DATA(set);
+	H3Index    *cells = palloc_extended(Max(set->count, 1) * sizeof(H3Index), MCXT_ALLOC_HUGE);
+	int64		n = 0;
+
+	for (int32 block = 0; block < set->numBlocks; block++)
+	{
+		uint64		key = keys[block];
+		int			count = h3set_block_count(set, block);
+
+		cells[n++] = cell_range_from_hierarchy_key(key);
+		for (int i = 1; i < count; i++)
+		{
+			in = delta_read(in, key, &key);
+			cells[n++] = cell_range_from_hierarchy_key(key);
+		}
+	}
+
+	return cells;
+}
+
+/*
+ * Cells of a compacted set do not overlap, so if any of them contains the
+ * cell, it is the last one at or before the cell in hierarchy order. It is
+ * found by binary search over the blocks, then decoding a single block.
+ */
+bool
+h3set_contains_cell(const H3Set * set, H3Index cell)
+{
+	const uint64 *keys = H3SET_KEYS(set);
+	uint64		target = cell_range_hierarchy_key(cell);
+	int32		lo = 0;
+	int32		hi = set->numBlocks;
+	const uint8 *in;
+	uint64		key;
+	int			count;
+
+	/* find the last block starting at or before target */
+	while (lo < hi)
+	{
+		int32		mid = lo + (hi - lo) / 2;
+
+		if (keys[mid] <= target)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return false;
+
+	in = H3SET_DATA(set) + H3SET_OFFSETS(set)[lo - 1];
+	key = keys[lo - 1];
+	count = h3set_block_count(set, lo - 1);
+	for (int i = 1; i < count; i++)
+	{
+		uint64		next;
+
+		in = delta_read(in, key, &next);
+		if (next > target)
+			break;
+		key = next;
+	}
+
+	return cell_range_contains(cell_range_from_hierarchy_key(key), cell);
+}
+
+/* Validates cell, then adds it to the (not yet compacted) buffer */
+static void
+h3set_append_valid(H3CellBuffer * buffer, H3Index cell)
+{
+	if (!isValidCell(cell))
+		h3_assert(E_CELL_INVALID);
+	cell_buffer_append(buffer, &cell, 1);
+}
+
+static H3Set *
+h3set_from_buffer(H3CellBuffer * buffer)
+{
+	cell_buffer_reduce(buffer);
+	return h3set_from_cells(buffer->cells, buffer->count);
+}
+
+/* textual input/output functions, using the array literal syntax */
+Datum
+h3set_in(PG_FUNCTION_ARGS)
+{
+	char	   *string = PG_GETARG_CSTRING(0);
+	char	   *p = string;
+	H3CellBuffer *buffer = cell_buffer_create(CurrentMemoryContext, 0, compact_cells);
+
+	while (isspace((unsigned char) *p))
+		p++;
+	ASSERT(
+		   *p++ == '{',
+		   ERRCODE_INVALID_TEXT_REPRESENTATION,
+		   "Malformed h3set literal: \"%s\"", string
+		);
+	while (isspace((unsigned char) *p))
+		p++;
+
+	while (*p != '}')
+	{
+		char		cell[H3_HEX_MAX_LENGTH + 1];
+		int			len = 0;
+		H3Index		h3;
+
+		while (*p && *p != ',' && *p != '}' && !isspace((unsigned char) *p))
+		{
+			ASSERT(
+				   len < H3_HEX_MAX_LENGTH,
+				   ERRCODE_INVALID_TEXT_REPRESENTATION,
+				   "Malformed h3set literal: \"%s\"", string
+				);
+			cell[len++] = *p++;
+		}
+		cell[len] = '\0';
+
+		if (!hex_to_h3(cell, &h3))
+			h3_assert(stringToH3(cell, &h3));
+		h3set_append_valid(buffer, h3);
+
+		while (isspace((unsigned char) *p))
+			p++;
+		if (*p == ',')
+			p++;
+		else
+			ASSERT(
+				   *p == '}',
+				   ERRCODE_INVALID_TEXT_REPRESENTATION,
+				   "Malformed h3set literal: \"%s\"", string
+				);
+		while (isspace((unsigned char) *p))
+			p++;
+	}
+
+	p++;
+	while (isspace((unsigned char) *p))
+		p++;
+	ASSERT(
+		   *p == '\0',
+		   ERRCODE_INVALID_TEXT_REPRESENTATION,
+		   "Malformed h3set literal: \"%s\"", string
+		);
+
+	PG_RETURN_H3SET_P(h3set_from_buffer(buffer));
+}
+
+Datum
+h3set_out(PG_FUNCTION_ARGS)
+{
+	H3Set	   *set = PG_GETARG_H3SET_P(0);
+	H3Index    *cells = h3set_cells(set);
+	StringInfoData buf;
+
+	initStringInfo(&buf);
+	appendStringInfoChar(&buf, '{');
+	for (int64 i = 0; i < set->count; i++)
+	{
+		/* room for a separator and the digits, formatted in place */
+		enlargeStringInfo(&buf, H3_HEX_MAX_LENGTH + 1);
+		if (i > 0)
+			buf.data[buf.len++] = ',';
+		buf.len += h3_to_hex(cells[i], buf.data + buf.len);
+	}
+	appendStringInfoChar(&buf, '}');
+
+	PG_RETURN_CSTRING(buf.data);
+}
+
+/* binary input/output functions, sending the count followed by the cells */
+Datum
+h3set_recv(PG_FUNCTION_ARGS)
+{
+	StringInfo	buf = (StringInfo) PG_GETARG_POINTER(0);
+	int64		count = pq_getmsgint64(buf);
+	H3CellBuffer *buffer;
+
+	ASSERT(
+		   count >= 0 && count <= (buf->len - buf->cursor) / (int64) sizeof(H3Index),
+		   ERRCODE_INVALID_BINARY_REPRESENTATION,
+		   "Invalid h3set cell count %lld", (long long) count
+		);
+
+	buffer = cell_buffer_create(CurrentMemoryContext, count, compact_cells);
+	for (int64 i = 0; i < count; i++)
+		h3set_append_valid(buffer, pq_getmsgint64(buf));
+
+	PG_RETURN_H3SET_P(h3set_from_buffer(buffer));
+}
+
+Datum
+h3set_send(PG_FUNCTION_ARGS)
+{
+	H3Set	   *set = PG_GETARG_H3SET_P(0);
+	H3Index    *cells = h3set_cells(set);
+	StringInfoData buf;
+
+	pq_begintypsend(&buf);
+	pq_sendint64(&buf, set->count);
+	for (int64 i = 0; i < set->count; i++)
+		pq_sendint64(&buf, cells[i]);
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/* the encoding is canonical, so equal sets are equal bytes */
+static bool
+h3set_equals(const H3Set * a, const H3Set * b)
+{
+	return VARSIZE(a) == VARSIZE(b) && memcmp(a, b, VARSIZE(a)) == 0;
+}
+
+Datum
+h3set_eq(PG_FUNCTION_ARGS)
+{
+	H3Set	   *a = PG_GETARG_H3SET_P(0);
+	H3Set	   *b = PG_GETARG_H3SET_P(1);
+
+	PG_RETURN_BOOL(h3set_equals(a, b));
+}
+
+Datum
+h3set_ne(PG_FUNCTION_ARGS)
+{
+	H3Set	   *a = PG_GETARG_H3SET_P(0);
+	H3Set	   *b = PG_GETARG_H3SET_P(1);
+
+	PG_RETURN_BOOL(!h3set_equals(a, b));
+}
+
+/* Set detoasted by a previous call, with its stored (toasted) form */
+typedef struct
+{
+	struct varlena *stored;
+	H3Set	   *set;
+}	H3SetCache;
+
+/*
+ * Gets a set argument of the containment operators, which usually compare
+ * the same set against every row. Sets stored out of line or compressed are
+ * detoasted once and kept for as long as the argument stays the same.
+ */
+static H3Set *
+h3set_getarg_cached(FunctionCallInfo fcinfo, int n)
+{
+	struct varlena *stored = (struct varlena *) PG_GETARG_POINTER(n);
+	H3SetCache *cache = (H3SetCache *) fcinfo->flinfo->fn_extra;
+	MemoryContext old;
+
+	if (!VARATT_IS_EXTERNAL_ONDISK(stored) && !VARATT_IS_COMPRESSED(stored))
+		return DatumGetH3SetP(PointerGetDatum(stored));
+
+	if (cache != NULL
+		&& VARSIZE_ANY(stored) == VARSIZE_ANY(cache->stored)
+		&& memcmp(stored, cache->stored, VARSIZE_ANY(stored)) == 0)
+		return cache->set;
+
+	old = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+	if (cache == NULL)
+		cache = fcinfo->flinfo->fn_extra = palloc(sizeof(H3SetCache));
+	else
+	{
+		pfree(cache->stored);
+		pfree(cache->set);
+	}
+	cache->stored = palloc(VARSIZE_ANY(stored));
+	memcpy(cache->stored, stored, VARSIZE_ANY(stored));
+	cache->set = DatumGetH3SetP(PointerGetDatum(stored));
+	MemoryContextSwitchTo(old);
+
+	return cache->set;
+}
+
+Datum
+h3set_contains(PG_FUNCTION_ARGS)
+{
+	H3Set	   *set = h3set_getarg_cached(fcinfo, 0);
+	H3Index		cell = PG_GETARG_H3INDEX(1);
+
+	PG_RETURN_BOOL(h3set_contains_cell(set, cell));
+}
+
+Datum
+h3set_contained_by(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+	H3Set	   *set = h3set_getarg_cached(fcinfo, 1);
+
+	PG_RETURN_BOOL(h3set_contains_cell(set, cell));
+}
+
+/*
+ * Set algebra works directly on the compacted cells of both sets, which are
+ * already sorted in hierarchy order, so each operation is a single merge.
+ * Overlapping cells are told apart using their res 15 ranges.
+ */
+Datum
+h3set_union(PG_FUNCTION_ARGS)
+{
+	H3Set	   *a = PG_GETARG_H3SET_P(0);
+	H3Set	   *b = PG_GETARG_H3SET_P(1);
+	H3Index    *aCells = h3set_cells(a);
+	H3Index    *bCells = h3set_cells(b);
+	H3Index    *cells = palloc_extended(Max((int64) a->count + b->count, 1) * sizeof(H3Index), MCXT_ALLOC_HUGE);
+	int64		i = 0,
+				j = 0,
+				n = 0;
+
+	while (i < a->count || j < b->count)
+	{
+		if (j == b->count
+			|| (i < a->count && cell_range_hierarchy_cmp(aCells[i], bCells[j]) <= 0))
+			cells[n++] = aCells[i++];
+		else
+			cells[n++] = bCells[j++];
+	}
+
+	/* drops cells covered by the other set, and merges completed siblings */
+	PG_RETURN_H3SET_P(h3set_from_cells(cells, compact_sorted_cells(cells, n)));
+}
+
+Datum
+h3set_intersection(PG_FUNCTION_ARGS)
+{
+	H3Set	   *a = PG_GETARG_H3SET_P(0);
+	H3Set	   *b = PG_GETARG_H3SET_P(1);
+	H3Index    *aCells = h3set_cells(a);
+	H3Index    *bCells = h3set_cells(b);
+	H3Index    *cells = palloc_extended(Max((int64) a->count + b->count, 1) * sizeof(H3Index), MCXT_ALLOC_HUGE);
+	int64		i = 0,
+				j = 0,
+				n = 0;
+
+	while (i < a->count && j < b->count)
+	{
+		H3Index		aMax = cell_range_max(aCells[i]);
+		H3Index		bMax = cell_range_max(bCells[j]);
+
+		/* the finer of two overlapping cells is covered by both sets */
+		if (cell_range_overlaps(aCells[i], bCells[j]))
+			cells[n++] = cell_range_contains(aCells[i], bCells[j]) ? bCells[j] : aCells[i];
+
+		/* the cell ending first cannot overlap anything further */
+		if (aMax <= bMax)
+			i++;
+		if (bMax <= aMax)
+			j++;
+	}
+
+	PG_RETURN_H3SET_P(h3set_from_cells(cells, compact_sorted_cells(cells, n)));
+}
+
+/*
+ * Appends what is left of cell after removing its descendants holes (sorted
+ * in hierarchy order), splitting it into children only around the holes.
+ */
+static void
+h3set_subtract(H3CellBuffer * out, H3Index cell, const H3Index * holes, int64 count)
+{
+	bool		pentagon;
+
+	if (count == 0)
+	{
+		cell_buffer_append(out, &cell, 1);
+		return;
+	}
+	if (holes[0] == cell)
+		return;
+
+	pentagon = isPentagon(cell);
+	for (int digit = 0; digit < NUM_DIGITS; digit++)
+	{
+		H3Index		child;
+		int64		n = 0;
+
+		if (pentagon && digit == PENTAGON_SKIPPED_DIGIT)
+			continue;
+
+		child = cell_range_child(cell, digit);
+		while (n < count && cell_range_contains(child, holes[n]))
+			n++;
+
+		h3set_subtract(out, child, holes, n);
+		holes += n;
+		count -= n;
+	}
+}
+
+Datum
+h3set_difference(PG_FUNCTION_ARGS)
+{
+	H3Set	   *a = PG_GETARG_H3SET_P(0);
+	H3Set	   *b = PG_GETARG_H3SET_P(1);
+	H3Index    *aCells = h3set_cells(a);
+	H3Index    *bCells = h3set_cells(b);
+	/* already compact, in hierarchy order */
+	H3CellBuffer *buffer = cell_buffer_create(CurrentMemoryContext, a->count, NULL);
+	int64		j = 0;
+
+	for (int64 i = 0; i < a->count; i++)
+	{
+		H3Index		cell = aCells[i];
+		int64		k;
+
+		/* skip cells of b ending before this one */
+		while (j < b->count && cell_range_max(bCells[j]) < cell_range_min(cell))
+			j++;
+
+		/* removed entirely */
+		if (j < b->count && cell_range_contains(bCells[j], cell))
+			continue;
+
+		/* remove the holes within */
+		k = j;
+		while (k < b->count && cell_range_contains(cell, bCells[k]))
+			k++;
+		h3set_subtract(buffer, cell, bCells + j, k - j);
+		j = k;
+	}
+
+	PG_RETURN_H3SET_P(h3set_from_cells(buffer->cells, buffer->count));
+}
+
+Datum
+h3index_array_to_h3set(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	ArrayIterator iterator = array_create_iterator(array, 0, NULL);
+	H3CellBuffer *buffer;
+	Datum		value;
+	bool		isnull;
+
+	buffer = cell_buffer_create(CurrentMemoryContext,
+								ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array)),
+								compact_cells);
+	while (array_iterate(iterator, &value, &isnull))
+	{
+		if (!isnull)
+			h3set_append_valid(buffer, DatumGetH3Index(value));
+	}
+	array_free_iterator(iterator);
+
+	PG_RETURN_H3SET_P(h3set_from_buffer(buffer));
+}
+
+Datum
+h3set_to_h3index_array(PG_FUNCTION_ARGS)
+{
+	H3Set	   *set = PG_GETARG_H3SET_P(0);
+	H3Index    *cells = h3set_cells(set);
+	Oid			elmtype = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	int16		elmlen;
+	bool		elmbyval;
+	char		elmalign;
+	Datum	   *datums;
+
+	ASSERT(
+		   set->count <= MaxArraySize,
+		   ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		   "Set of %lld cells exceeds the maximum array size.",
+		   (long long) set->count
+		);
+
+	datums = palloc_extended(Max(set->count, 1) * sizeof(Datum), MCXT_ALLOC_HUGE);
+	for (int64 i = 0; i < set->count; i++)
+		datums[i] = H3IndexGetDatum(cells[i]);
+
+	get_typlenbyvalalign(elmtype, &elmlen, &elmbyval, &elmalign);
+	PG_RETURN_ARRAYTYPE_P(construct_array(datums, set->count, elmtype,
+										  elmlen, elmbyval, elmalign));
+}
+
+/* Adds the cells of a set to the state shared with h3_compact_agg */
+Datum
+h3set_union_agg_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	H3CellBuffer *state = PG_ARGISNULL(0) ? NULL : (H3CellBuffer *) PG_GETARG_POINTER(0);
+	H3Set	   *set;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "h3set_union_agg_transfn called in non-aggregate context");
+
+	if (PG_ARGISNULL(1))
+	{
+		if (state == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state);
+	}
+
+	set = PG_GETARG_H3SET_P(1);
+
+	if (state == NULL)
+		state = cell_buffer_create(aggcontext, set->count, compact_cells);
+
+	cell_buffer_append(state, h3set_cells(set), set->count);
+
+	PG_RETURN_POINTER(state);
+}
+
+Datum
+h3set_agg_finalfn(PG_FUNCTION_ARGS)
+{
+	H3CellBuffer *state = (H3CellBuffer *) PG_GETARG_POINTER(0);
+
+	/*
+	 * Compacting in place does not change the set, but does modify the
+	 * state, hence finalfunc_modify = read_write.
+	 */
+	cell_buffer_reduce(state);
+
+	PG_RETURN_H3SET_P(h3set_from_cells(state->cells, state->count));
+}
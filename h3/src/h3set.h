@@ -0,0 +1,57 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_H3SET_H
+#define H3_H3SET_H
+
+#include <h3api.h>
+
+/*
+ * A set of cells, stored compacted and sorted in hierarchy order.
+ *
+ * Cells are encoded by their hierarchy key (see cell_range.h), in blocks of
+ * H3SET_BLOCK_SIZE cells. The first key of every block is stored as is,
+ * allowing binary search, followed by the offset of the block in the data
+ * area, where the remaining keys are stored as deltas (see h3set.c).
+ */
+typedef struct
+{
+	int32		vl_len_;		/* varlena header (do not touch directly!) */
+	int32		numBlocks;
+	int64		count;			/* number of (compacted) cells */
+	/* uint64 keys[numBlocks], uint32 offsets[numBlocks], uint8 data[] */
+}	H3Set;
+
+#define H3SET_BLOCK_SIZE 64
+
+#define H3SET_KEYS(set) ((uint64 *) ((char *) (set) + sizeof(H3Set)))
+#define H3SET_OFFSETS(set) ((uint32 *) (H3SET_KEYS(set) + (set)->numBlocks))
+#define H3SET_DATA(set) ((uint8 *) (H3SET_OFFSETS(set) + (set)->numBlocks))
+
+#define DatumGetH3SetP(X) ((H3Set *) PG_DETOAST_DATUM(X))
+#define PG_GETARG_H3SET_P(n) DatumGetH3SetP(PG_GETARG_DATUM(n))
+#define PG_RETURN_H3SET_P(x) PG_RETURN_POINTER(x)
+
+/* Builds a set from cells that are compacted and sorted in hierarchy order */
+H3Set	   *h3set_from_cells(const H3Index * cells, int64 count);
+
+/* Decodes the (compacted) cells of a set */
+H3Index    *h3set_cells(const H3Set * set);
+
+/* True if cell is covered by the set */
+bool		h3set_contains_cell(const H3Set * set, H3Index cell);
+
+#endif							/* H3_H3SET_H */
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_HEX_H
+#define H3_HEX_H
+
+#include <h3api.h>
+
+#include <port/pg_bitutils.h> // pg_leftmost_one_pos64
+
+/*
+ * Hexadecimal text format of H3 indexes, without going through the scanf
+ * and printf style formatting of stringToH3 and h3ToString.
+ */
+
+/* longest hexadecimal representation, excluding the terminator */
+#define H3_HEX_MAX_LENGTH 16
+
+/*
+ * Parses 1 to 16 hexadecimal digits (of either case) making up the entire
+ * string. Returns false for anything else, which callers should hand to
+ * stringToH3, keeping its more lenient syntax.
+ */
+static inline bool
+hex_to_h3(const char *string, H3Index * out)
+{
+	H3Index		h3 = 0;
+	unsigned	invalid = 0;
+	int			len = 0;
+
+	for (; len < H3_HEX_MAX_LENGTH && string[len]; len++)
+	{
+		unsigned char c = string[len];
+
+		/* 0 to 9 keep their low nibble, letters have bit 6 set and need 9 more */
+		invalid |= ((unsigned) (c - '0') > 9) & ((unsigned) ((c | 0x20) - 'a') > 5);
+		h3 = (h3 << 4) | ((c & 0xF) + 9 * (c >> 6));
+	}
+
+	if (invalid || len == 0 || string[len])
+		return false;
+
+	*out = h3;
+	return true;
+}
+
+/*
+ * Writes the lowercase hexadecimal digits of h3 (without leading zeros) and a
+ * terminator to out, which must hold H3_HEX_MAX_LENGTH + 1 bytes. Returns the
+ * number of digits.
+ */
+static inline int
+h3_to_hex(H3Index h3, char *out)
+{
+	int			len = h3 ? pg_leftmost_one_pos64(h3) / 4 + 1 : 1;
+
+	for (int i = len - 1; i >= 0; i--)
+	{
+		out[i] = "0123456789abcdef"[h3 & 0xF];
+		h3 >>= 4;
+	}
+	out[len] = '\0';
+	return len;
+}
+
+#endif							/* H3_HEX_H */
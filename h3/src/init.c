@@ -22,6 +22,7 @@
 #include <fmgr.h> // PG_MODULE_MAGIC
 
 #include "guc.h"
+#include "stat.h"
 
 /* see https://www.postgresql.org/docs/current/xfunc-c.html#XFUNC-C-DYNLOAD */
 PG_MODULE_MAGIC;
@@ -33,4 +34,5 @@ _PG_init(void)
 	/* we could make version number assertion here */
 
 	_guc_init();
+	_stat_init();
 }
@@ -0,0 +1,415 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <math.h> // ceil, floor
+
+#include "constants.h"
+#include "error.h"
+#include "iterator.h"
+#include "upstream_macros.h"
+
+/* Adds one to the digit at res, carrying into coarser digits */
+static inline void
+iterator_increment_digit(H3ChildIterator * it, int res)
+{
+	it->cell += ((uint64_t) 1) << ((MAX_H3_RES - res) * H3_PER_DIGIT_OFFSET);
+}
+
+/*
+ * Starts at the center child, with all digits below the parent zero.
+ * Children of pentagons whose first non-zero digit is the deleted k-axes
+ * subsequence are skipped, starting from the finest digit.
+ */
+void
+iterator_children_init(H3ChildIterator * it, H3Index parent, int childRes)
+{
+	int			parentRes = H3_GET_RESOLUTION(parent);
+
+	it->cell = parent;
+	it->parentRes = parentRes;
+	it->skipDigit = isPentagon(parent) ? childRes : -1;
+
+	H3_SET_RESOLUTION(it->cell, childRes);
+	for (int res = parentRes + 1; res <= childRes; res++)
+		H3_SET_INDEX_DIGIT(it->cell, res, CENTER_DIGIT);
+}
+
+/* Steps to the next child, or sets cell to H3_NULL after the last */
+void
+iterator_children_step(H3ChildIterator * it)
+{
+	int			childRes;
+
+	if (it->cell == H3_NULL)
+		return;
+
+	childRes = H3_GET_RESOLUTION(it->cell);
+	iterator_increment_digit(it, childRes);
+
+	for (int res = childRes; res >= it->parentRes; res--)
+	{
+		/* carried into the parent */
+		if (res == it->parentRes)
+		{
+			it->cell = H3_NULL;
+			return;
+		}
+
+		if (res == it->skipDigit
+			&& H3_GET_INDEX_DIGIT(it->cell, res) == PENTAGON_SKIPPED_DIGIT)
+		{
+			iterator_increment_digit(it, res);
+			it->skipDigit--;
+			return;
+		}
+
+		/* wrapped around, carry on to the next coarser digit */
+		if (H3_GET_INDEX_DIGIT(it->cell, res) == INVALID_DIGIT)
+			iterator_increment_digit(it, res);
+		else
+			break;
+	}
+}
+
+static int
+iterator_cmp(const void *a, const void *b)
+{
+	H3Index		x = *(const H3Index *) a;
+	H3Index		y = *(const H3Index *) b;
+
+	return (x > y) - (x < y);
+}
+
+static bool
+iterator_contains(const H3Index *sorted, int64_t size, H3Index cell)
+{
+	return size > 0
+		&& bsearch(&cell, sorted, size, sizeof(H3Index), iterator_cmp) != NULL;
+}
+
+/*
+ * Next ring around the origin. Until a pentagon is encountered this is a
+ * single call to gridRingUnsafe. From then on it is the neighbors of the
+ * current ring that are not in it or the ring before it.
+ */
+static void
+iterator_disk_expand(H3DiskIterator * it)
+{
+	int			distance = it->distance + 1;
+	H3Index    *next = MemoryContextAlloc(it->context,
+										  Max(6 * distance, 7 * it->ringSize) * sizeof(H3Index));
+	int64_t		nextSize = 0;
+
+	if (!it->distorted && gridRingUnsafe(it->origin, distance, next) == E_SUCCESS)
+		nextSize = 6 * distance;
+	else
+	{
+		H3Index		neighbors[7];
+
+		it->distorted = true;
+		qsort(it->ring, it->ringSize, sizeof(H3Index), iterator_cmp);
+		qsort(it->inner, it->innerSize, sizeof(H3Index), iterator_cmp);
+
+		for (int64_t i = 0; i < it->ringSize; i++)
+		{
+			h3_assert(gridDisk(it->ring[i], 1, neighbors));
+			for (int j = 0; j < 7; j++)
+			{
+				if (neighbors[j] != H3_NULL
+					&& !iterator_contains(it->ring, it->ringSize, neighbors[j])
+					&& !iterator_contains(it->inner, it->innerSize, neighbors[j]))
+					next[nextSize++] = neighbors[j];
+			}
+		}
+
+		/* remove duplicates */
+		qsort(next, nextSize, sizeof(H3Index), iterator_cmp);
+		if (nextSize > 0)
+		{
+			int64_t		unique = 1;
+
+			for (int64_t i = 1; i < nextSize; i++)
+				if (next[i] != next[unique - 1])
+					next[unique++] = next[i];
+			nextSize = unique;
+		}
+	}
+
+	if (it->inner)
+		pfree(it->inner);
+	it->inner = it->ring;
+	it->innerSize = it->ringSize;
+	it->ring = next;
+	it->ringSize = nextSize;
+	it->position = 0;
+	it->distance = distance;
+}
+
+/* Starts at the origin, allocating rings in the current memory context */
+void
+iterator_disk_init(H3DiskIterator * it, H3Index origin, int k)
+{
+	it->context = CurrentMemoryContext;
+	it->origin = origin;
+	it->k = k;
+	it->distance = 0;
+	it->distorted = false;
+	it->ring = palloc(sizeof(H3Index));
+	it->ring[0] = origin;
+	it->ringSize = 1;
+	it->position = 0;
+	it->inner = NULL;
+	it->innerSize = 0;
+}
+
+/* Returns false once all cells within distance k have been produced */
+bool
+iterator_disk_next(H3DiskIterator * it, H3Index *cell, int *distance)
+{
+	while (it->position >= it->ringSize)
+	{
+		/* an empty ring means the whole globe is covered */
+		if (it->distance >= it->k || it->ringSize == 0)
+			return false;
+		iterator_disk_expand(it);
+	}
+
+	*cell = it->ring[it->position++];
+	*distance = it->distance;
+	return true;
+}
+
+static int64_t
+iterator_polygon_max_size(H3PolygonIterator * it, const GeoPolygon *polygon)
+{
+	int64_t		size;
+
+	if (it->experimental)
+		h3_assert(maxPolygonToCellsSizeExperimental(polygon, it->resolution, it->flags, &size));
+	else
+		h3_assert(maxPolygonToCellsSize(polygon, it->resolution, it->flags, &size));
+	return size;
+}
+
+/*
+ * Clips a loop to the latitudes on one side of lat (Sutherland-Hodgman),
+ * unwrapping edges that cross the antimeridian before interpolating.
+ */
+static int
+iterator_clip_loop(const LatLng *in, int numIn, LatLng *out, double lat, bool north)
+{
+	int			numOut = 0;
+
+	for (int i = 0; i < numIn; i++)
+	{
+		LatLng		a = in[i];
+		LatLng		b = in[(i + 1) % numIn];
+		bool		aInside = north ? a.lat >= lat : a.lat <= lat;
+		bool		bInside = north ? b.lat >= lat : b.lat <= lat;
+
+		if (aInside)
+			out[numOut++] = a;
+
+		if (aInside != bInside)
+		{
+			LatLng		crossing;
+
+			if (b.lng - a.lng > M_PI)
+				b.lng -= 2 * M_PI;
+			else if (a.lng - b.lng > M_PI)
+				b.lng += 2 * M_PI;
+
+			crossing.lat = lat;
+			crossing.lng = a.lng + (b.lng - a.lng) * (lat - a.lat) / (b.lat - a.lat);
+			if (crossing.lng > M_PI)
+				crossing.lng -= 2 * M_PI;
+			else if (crossing.lng < -M_PI)
+				crossing.lng += 2 * M_PI;
+			out[numOut++] = crossing;
+		}
+	}
+	return numOut;
+}
+
+/* Clips a loop to the latitudes between south and north, false if empty */
+static bool
+iterator_clip_band(const GeoLoop *loop, double south, double north, GeoLoop *out)
+{
+	LatLng	   *buffer = palloc(2 * loop->numVerts * sizeof(LatLng));
+
+	out->verts = palloc(4 * loop->numVerts * sizeof(LatLng));
+	out->numVerts = iterator_clip_loop(loop->verts, loop->numVerts, buffer, south, true);
+	out->numVerts = iterator_clip_loop(buffer, out->numVerts, out->verts, north, false);
+	pfree(buffer);
+
+	return out->numVerts >= 3;
+}
+
+/* Fills the next band, returning false after the last */
+static bool
+iterator_polygon_fill(H3PolygonIterator * it)
+{
+	MemoryContext oldcontext;
+	GeoPolygon	band;
+	GeoPolygon *polygon = &it->polygon;
+	double		south;
+	double		north;
+
+	if (it->cells)
+		pfree(it->cells);
+	it->cells = NULL;
+	it->numCells = 0;
+	it->position = 0;
+
+	if (++it->band >= it->numBands)
+		return false;
+
+	oldcontext = MemoryContextSwitchTo(it->context);
+
+	if (it->numBands > 1)
+	{
+		/* overlap neighbouring bands by more than any cell reaches */
+		south = it->south + it->band * it->bandHeight - it->margin;
+		north = it->south + (it->band + 1) * it->bandHeight + it->margin;
+
+		/* nothing of the polygon in this band */
+		if (!iterator_clip_band(&it->polygon.geoloop, south, north, &band.geoloop))
+		{
+			pfree(band.geoloop.verts);
+			MemoryContextSwitchTo(oldcontext);
+			return true;
+		}
+
+		polygon = &band;
+		band.numHoles = 0;
+		band.holes = palloc(Max(it->polygon.numHoles, 1) * sizeof(GeoLoop));
+
+		for (int i = 0; i < it->polygon.numHoles; i++)
+		{
+			if (iterator_clip_band(&it->polygon.holes[i], south, north,
+								   &band.holes[band.numHoles]))
+				band.numHoles++;
+			else
+				pfree(band.holes[band.numHoles].verts);
+		}
+	}
+
+	it->numCells = iterator_polygon_max_size(it, polygon);
+	it->cells = palloc_extended(it->numCells * sizeof(H3Index),
+								MCXT_ALLOC_HUGE | MCXT_ALLOC_ZERO);
+
+	if (it->experimental)
+		h3_assert(polygonToCellsExperimental(polygon, it->resolution, it->flags,
+											 it->numCells, it->cells));
+	else
+		h3_assert(polygonToCells(polygon, it->resolution, it->flags, it->cells));
+
+	if (polygon == &band)
+	{
+		pfree(band.geoloop.verts);
+		for (int i = 0; i < band.numHoles; i++)
+			pfree(band.holes[i].verts);
+		pfree(band.holes);
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+	return true;
+}
+
+/*
+ * Polygon is kept by reference, and must live as long as the iterator. Bands
+ * are allocated in the current memory context.
+ */
+void
+iterator_polygon_init(H3PolygonIterator * it, const GeoPolygon *polygon,
+					  int resolution, uint32_t flags, bool experimental,
+					  int64_t chunkSize)
+{
+	int64_t		maxSize;
+	double		north;
+	double		edge;
+	double		bands;
+
+	it->context = CurrentMemoryContext;
+	it->polygon = *polygon;
+	it->resolution = resolution;
+	it->flags = flags;
+	it->experimental = experimental;
+	it->numBands = 1;
+	it->band = -1;
+	it->cells = NULL;
+	it->numCells = 0;
+	it->position = 0;
+
+	maxSize = iterator_polygon_max_size(it, polygon);
+	if (maxSize <= chunkSize || polygon->geoloop.numVerts == 0)
+		return;
+
+	it->south = north = polygon->geoloop.verts[0].lat;
+	for (int i = 1; i < polygon->geoloop.numVerts; i++)
+	{
+		it->south = Min(it->south, polygon->geoloop.verts[i].lat);
+		north = Max(north, polygon->geoloop.verts[i].lat);
+	}
+
+	/*
+	 * Twice the average edge length covers the distortion of cells and
+	 * pentagons. Bands narrower than the overlap would mostly fill it.
+	 */
+	h3_assert(getHexagonEdgeLengthAvgKm(resolution, &edge));
+	it->margin = 2 * edge / EARTH_RADIUS_KM;
+	bands = ceil((double) maxSize / chunkSize);
+	bands = Min(bands, floor((north - it->south) / it->margin));
+	it->numBands = Max(1, (int) bands);
+	it->bandHeight = (north - it->south) / it->numBands;
+}
+
+/* Returns false once all cells of the polygon have been produced */
+bool
+iterator_polygon_next(H3PolygonIterator * it, H3Index *cell)
+{
+	for (;;)
+	{
+		while (it->position < it->numCells)
+		{
+			H3Index		candidate = it->cells[it->position++];
+			LatLng		center;
+			int			band;
+
+			/* skip missing indices (all zeros) */
+			if (candidate == H3_NULL)
+				continue;
+
+			/* keep cells centered in this band, the outer bands are open ended */
+			if (it->numBands > 1)
+			{
+				h3_assert(cellToLatLng(candidate, &center));
+				band = floor((center.lat - it->south) / it->bandHeight);
+				if (Max(0, Min(band, it->numBands - 1)) != it->band)
+					continue;
+			}
+
+			*cell = candidate;
+			return true;
+		}
+
+		if (!iterator_polygon_fill(it))
+			return false;
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_ITERATOR_H
+#define H3_ITERATOR_H
+
+#include <h3api.h>
+
+/*
+ * Iterators producing the output of set returning functions one cell at a
+ * time, so memory stays constant (or linear in k for disks) and the first
+ * row is available immediately.
+ */
+
+/*	children of a cell, in the same order as cellToChildren */
+typedef struct
+{
+	H3Index		cell;			/* current child, or H3_NULL when done */
+	int			parentRes;
+	int			skipDigit;		/* pentagon digit to skip, or -1 */
+}	H3ChildIterator;
+
+/*	cells within distance k of an origin, ring by ring */
+typedef struct
+{
+	MemoryContext context;		/* where rings are allocated */
+	H3Index		origin;
+	int			k;
+	int			distance;		/* distance of current ring */
+	bool		distorted;		/* pentagon encountered */
+	H3Index    *ring;
+	int64_t		ringSize;
+	int64_t		position;		/* next cell in ring */
+	H3Index    *inner;			/* previous ring */
+	int64_t		innerSize;
+}	H3DiskIterator;
+
+/*
+ * cells of a polygon. Polygons whose worst case exceeds chunkSize cells (by
+ * default h3.polygon_to_cells_chunk_size) are filled one band of latitude at
+ * a time, keeping the cells whose center falls within the band.
+ */
+#define POLYGON_TO_CELLS_CHUNK_SIZE 1048576
+
+typedef struct
+{
+	MemoryContext context;		/* where bands are allocated */
+	GeoPolygon	polygon;
+	int			resolution;
+	uint32_t	flags;
+	bool		experimental;	/* use polygonToCellsExperimental */
+	int			numBands;
+	int			band;			/* band of cells, -1 before the first */
+	double		south;			/* southern edge of the first band */
+	double		bandHeight;
+	double		margin;			/* band overlap, covering any cell */
+	H3Index    *cells;
+	int64_t		numCells;
+	int64_t		position;		/* next cell in band */
+}	H3PolygonIterator;
+
+void		iterator_children_init(H3ChildIterator * it, H3Index parent, int childRes);
+void		iterator_children_step(H3ChildIterator * it);
+
+void		iterator_disk_init(H3DiskIterator * it, H3Index origin, int k);
+bool		iterator_disk_next(H3DiskIterator * it, H3Index *cell, int *distance);
+
+void		iterator_polygon_init(H3PolygonIterator * it, const GeoPolygon *polygon,
+								  int resolution, uint32_t flags, bool experimental,
+								  int64_t chunkSize);
+bool		iterator_polygon_next(H3PolygonIterator * it, H3Index *cell);
+
+#endif /* H3_ITERATOR_H */
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include "error.h"
+#include "knn.h"
+
+/*
+ * Distance in grid cells, at the finest resolution of the two
+ * (using center child), or -1 if it cannot be computed.
+ */
+int64_t
+knn_distance(H3Index a, H3Index b)
+{
+	int			resA = getResolution(a);
+	int			resB = getResolution(b);
+	H3Error		error;
+	int64_t		distance;
+
+	if (resA < resB)
+		h3_assert(cellToCenterChild(a, resB, &a));
+	else if (resB < resA)
+		h3_assert(cellToCenterChild(b, resA, &b));
+
+	error = gridDistance(a, b, &distance);
+	if (error)
+		distance = -1;
+
+	return distance;
+}
+
+/*
+ * Lower bound of knn_distance(cell, query) for every cell descending from
+ * (or equal to) ancestor, used to order index pages in KNN scans.
+ *
+ * This is the distance between the ancestors of both at the coarsest
+ * resolution of the two. Within (neighbouring) hexagon base cells, H3 local
+ * coordinates are exact aperture 7 lattices: the children of a cell are its
+ * center child and its six neighbours, and the center child scales
+ * coordinates by sqrt(7), multiplying hex distances by at least
+ * sqrt(7) * sqrt(3) / 2 > 2. Two cells whose parents are d > 1 apart are
+ * then at least 2d - 2 >= d apart, and distances never shrink towards
+ * finer resolutions, where knn_distance compares the cells.
+ *
+ * The distance is -1 when the base cells are not neighbours, as for every
+ * descendant. Pentagons distort the lattice and may fail the grid distance,
+ * so any pentagon base cell gives -1 as well: such pages sort ahead of
+ * everything else and are always visited.
+ */
+double
+knn_distance_lower_bound(H3Index query, H3Index ancestor)
+{
+	int			res = Min(getResolution(query), getResolution(ancestor));
+	H3Index		queryBase;
+	H3Index		ancestorBase;
+
+	h3_assert(cellToParent(query, 0, &queryBase));
+	h3_assert(cellToParent(ancestor, 0, &ancestorBase));
+
+	if (isPentagon(queryBase) || isPentagon(ancestorBase))
+		return -1;
+
+	h3_assert(cellToParent(query, res, &query));
+	h3_assert(cellToParent(ancestor, res, &ancestor));
+
+	/* same argument order as leaf distances, measuring from the descendant */
+	return knn_distance(ancestor, query);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_KNN_H
+#define H3_KNN_H
+
+#include <h3api.h>
+
+/*	grid distance as computed by the <-> operator */
+int64_t		knn_distance(H3Index a, H3Index b);
+
+/*	lower bound of knn_distance from query to any descendant of ancestor */
+double		knn_distance_lower_bound(H3Index query, H3Index ancestor);
+
+#endif /* H3_KNN_H */
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <fmgr.h> // PG_FUNCTION_ARGS
+
+#include "cell_range.h"
+#include "error.h"
+#include "type.h"
+
+/*
+ * Support functions for the BRIN inclusion operator class, which summarizes
+ * each block range by the lowest common ancestor of its cells.
+ *
+ * Ranges spanning several base cells (or holding edges or vertexes) have no
+ * such ancestor, and are marked unmergeable, matching every query.
+ */
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_brin_inclusion_merge);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_brin_inclusion_mergeable);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_brin_inclusion_contains);
+
+/* Lowest common ancestor of two mergeable cells */
+Datum
+h3index_brin_inclusion_merge(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+	H3Index		ancestor = cell_range_common_ancestor(a, b);
+
+	ASSERT(
+		   ancestor != H3_NULL,
+		   ERRCODE_INTERNAL_ERROR,
+		   "Cannot merge indexes without a common ancestor"
+		);
+
+	PG_RETURN_H3INDEX(ancestor);
+}
+
+/* True if two cells share a common ancestor */
+Datum
+h3index_brin_inclusion_mergeable(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+
+	PG_RETURN_BOOL(cell_range_common_ancestor(a, b) != H3_NULL);
+}
+
+/* True if summary cell a already covers cell b */
+Datum
+h3index_brin_inclusion_contains(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+	bool		contains = H3_GET_MODE(b) == H3_CELL_MODE
+		&& cell_range_contains(a, b);
+
+	PG_RETURN_BOOL(contains);
+}
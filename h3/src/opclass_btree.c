@@ -20,6 +20,7 @@
 #include <fmgr.h>			   // PG_FUNCTION_ARGS
 #include <utils/sortsupport.h> // SortSupport
 
+#include "cell_range.h"
 #include "type.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_cmp);
@@ -30,12 +31,12 @@ h3index_cmp(PG_FUNCTION_ARGS)
 	H3Index		a = PG_GETARG_H3INDEX(0);
 	H3Index		b = PG_GETARG_H3INDEX(1);
 
-	uint32_t	ret = 0;
+	int32_t		ret = 0;
 
 	if (a < b)
-		ret = 1;
-	else if (a > b)
 		ret = -1;
+	else if (a > b)
+		ret = 1;
 
 	PG_RETURN_INT32(ret);
 }
@@ -47,9 +48,9 @@ h3index_cmp_abbrev(Datum x, Datum y, SortSupport ssup)
 	if (x == y)
 		return 0;
 	else if (x < y)
-		return 1;
-	else
 		return -1;
+	else
+		return 1;
 }
 
 static int
@@ -61,8 +62,8 @@ h3index_cmp_full(Datum x, Datum y, SortSupport ssup)
 	if (a == b)
 		return 0;
 	else if (a < b)
-		return 1;
-	return -1;
+		return -1;
+	return 1;
 }
 
 static bool
@@ -101,3 +102,91 @@ h3index_sortsupport(PG_FUNCTION_ARGS)
 
 	PG_RETURN_VOID();
 }
+
+/*
+ * Hierarchy ordering: base cell, then digits (unused digits lowest), then
+ * resolution. Every cell is directly followed by its descendants.
+ */
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_hierarchy_cmp);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_hierarchy_lt);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_hierarchy_le);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_hierarchy_gt);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_hierarchy_ge);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_hierarchy_sortsupport);
+
+Datum
+h3index_hierarchy_cmp(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+
+	PG_RETURN_INT32(cell_range_hierarchy_cmp(a, b));
+}
+
+Datum
+h3index_hierarchy_lt(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+
+	PG_RETURN_BOOL(cell_range_hierarchy_cmp(a, b) < 0);
+}
+
+Datum
+h3index_hierarchy_le(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+
+	PG_RETURN_BOOL(cell_range_hierarchy_cmp(a, b) <= 0);
+}
+
+Datum
+h3index_hierarchy_gt(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+
+	PG_RETURN_BOOL(cell_range_hierarchy_cmp(a, b) > 0);
+}
+
+Datum
+h3index_hierarchy_ge(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+
+	PG_RETURN_BOOL(cell_range_hierarchy_cmp(a, b) >= 0);
+}
+
+static int
+h3index_hierarchy_cmp_full(Datum x, Datum y, SortSupport ssup)
+{
+	return cell_range_hierarchy_cmp(DatumGetH3Index(x), DatumGetH3Index(y));
+}
+
+/* abbreviated keys are unique for valid indexes, so ties are rare */
+static Datum
+h3index_hierarchy_abbrev_convert(Datum original, SortSupport ssup)
+{
+	return (Datum) cell_range_hierarchy_key(DatumGetH3Index(original));
+}
+
+Datum
+h3index_hierarchy_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+
+	ssup->comparator = h3index_hierarchy_cmp_full;
+	ssup->ssup_extra = NULL;
+	/* Enable sortsupport only on 64 bit Datum */
+	if (ssup->abbreviate && sizeof(Datum) == 8)
+	{
+		ssup->comparator = h3index_cmp_abbrev;
+		ssup->abbrev_converter = h3index_hierarchy_abbrev_convert;
+		ssup->abbrev_abort = h3index_abbrev_abort;
+		ssup->abbrev_full_comparator = h3index_hierarchy_cmp_full;
+	}
+
+	PG_RETURN_VOID();
+}
@@ -0,0 +1,374 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <fmgr.h>				// PG_FUNCTION_ARGS
+#include <math.h>				// pow
+#include <access/gist.h>		// GiST
+#include <access/stratnum.h>	// RTOverlapStrategyNumber, etc.
+#include <utils/sortsupport.h>	// SortSupport
+
+#include "cell_range.h"
+#include "error.h"
+#include "knn.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_consistent);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_union);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_penalty);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_picksplit);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_same);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_distance);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_gist_sortsupport);
+
+/*
+ * Keys of inner index tuples are the lowest common ancestor of everything
+ * below them. When the entries span several base cells there is no such
+ * ancestor, and we store the range of base cells instead, flagged by the
+ * (for valid indexes always unset) high bit. The lowest base cell goes into
+ * the regular base cell bits, the highest into the lowest digit bits.
+ */
+#define GIST_RANGE_FLAG ((uint64_t) 1 << 63)
+#define GIST_RANGE_HI_MASK ((uint64_t) 127)
+
+#define GIST_KEY_IS_RANGE(key) (((key) & GIST_RANGE_FLAG) != 0)
+#define GIST_KEY_RANGE(lo, hi) \
+	(GIST_RANGE_FLAG | ((uint64_t) (lo) << H3_BC_OFFSET) | (uint64_t) (hi))
+
+typedef struct
+{
+	OffsetNumber offset;
+	H3Index		key;
+	uint64_t	order;
+}	GistSplitItem;
+
+static bool
+gist_key_is_cell(H3Index key)
+{
+	return !GIST_KEY_IS_RANGE(key) && H3_GET_MODE(key) == H3_CELL_MODE;
+}
+
+/* lowest base cell below key */
+static int
+gist_key_lo(H3Index key)
+{
+	return H3_GET_BASE_CELL(key);
+}
+
+/* highest base cell below key */
+static int
+gist_key_hi(H3Index key)
+{
+	if (GIST_KEY_IS_RANGE(key))
+		return (int) (key & GIST_RANGE_HI_MASK);
+	return H3_GET_BASE_CELL(key);
+}
+
+/* smallest key covering both keys */
+static H3Index
+gist_key_union(H3Index a, H3Index b)
+{
+	if (a == b)
+		return a;
+
+	if (gist_key_is_cell(a) && gist_key_is_cell(b))
+	{
+		H3Index		ancestor = cell_range_common_ancestor(a, b);
+
+		if (ancestor != H3_NULL)
+			return ancestor;
+	}
+
+	return GIST_KEY_RANGE(
+						  Min(gist_key_lo(a), gist_key_lo(b)),
+						  Max(gist_key_hi(a), gist_key_hi(b)));
+}
+
+/* area covered by key, measured in base cells */
+static double
+gist_key_size(H3Index key)
+{
+	/* each resolution step has (roughly) seven times as many cells */
+	if (gist_key_is_cell(key))
+		return pow(7, -H3_GET_RESOLUTION(key));
+	return gist_key_hi(key) - gist_key_lo(key) + 1;
+}
+
+/* position of key in hierarchy order, placing ranges at their lowest base cell */
+static uint64_t
+gist_key_order(H3Index key)
+{
+	if (GIST_KEY_IS_RANGE(key))
+		key = cell_range_base_cell(gist_key_lo(key));
+	return cell_range_hierarchy_key(key);
+}
+
+static int
+gist_split_item_cmp(const void *a, const void *b)
+{
+	uint64_t	x = ((const GistSplitItem *) a)->order;
+	uint64_t	y = ((const GistSplitItem *) b)->order;
+
+	return (x > y) - (x < y);
+}
+
+/* can anything below an inner key satisfy the query */
+static bool
+gist_inner_consistent(H3Index key, H3Index query, StrategyNumber strategy)
+{
+	if (!gist_key_is_cell(key))
+	{
+		int			bc = H3_GET_BASE_CELL(query);
+
+		return gist_key_lo(key) <= bc && bc <= gist_key_hi(key);
+	}
+
+	switch (strategy)
+	{
+		case RTSameStrategyNumber:
+		case RTContainsStrategyNumber:
+			/* only the query and its ancestors qualify */
+			return cell_range_contains(key, query);
+		case RTOverlapStrategyNumber:
+		case RTContainedByStrategyNumber:
+			return cell_range_overlaps(key, query);
+		default:
+			elog(ERROR, "unrecognized strategy number: %d", strategy);
+	}
+	return false;
+}
+
+/* does leaf key satisfy the query */
+static bool
+gist_leaf_consistent(H3Index key, H3Index query, StrategyNumber strategy)
+{
+	switch (strategy)
+	{
+		case RTSameStrategyNumber:
+			return key == query;
+		case RTContainsStrategyNumber:
+			return cell_range_contains(key, query);
+		case RTContainedByStrategyNumber:
+			/* strict, a cell is not contained by itself */
+			return key != query && cell_range_contains(query, key);
+		case RTOverlapStrategyNumber:
+			return cell_range_overlaps(key, query);
+		default:
+			elog(ERROR, "unrecognized strategy number: %d", strategy);
+	}
+	return false;
+}
+
+/*
+ * Given an index entry p and a query value q, determines whether the index
+ * entry is "consistent" with the query.
+ */
+Datum
+h3index_gist_consistent(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	H3Index		query = PG_GETARG_H3INDEX(1);
+	StrategyNumber strategy = (StrategyNumber) PG_GETARG_UINT16(2);
+	bool	   *recheck = (bool *) PG_GETARG_POINTER(4);
+	H3Index		key = DatumGetH3Index(entry->key);
+	bool		retval;
+
+	/* all tests are exact */
+	*recheck = false;
+
+	if (GIST_LEAF(entry))
+		retval = gist_leaf_consistent(key, query, strategy);
+	else
+		retval = gist_inner_consistent(key, query, strategy);
+
+	PG_RETURN_BOOL(retval);
+}
+
+/*
+ * Consolidates information in the tree. Given a set of entries, generates a
+ * new index entry that represents all of them.
+ */
+Datum
+h3index_gist_union(PG_FUNCTION_ARGS)
+{
+	GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+	int		   *size = (int *) PG_GETARG_POINTER(1);
+	H3Index		key = DatumGetH3Index(entryvec->vector[0].key);
+
+	for (int i = 1; i < entryvec->n; i++)
+		key = gist_key_union(key, DatumGetH3Index(entryvec->vector[i].key));
+
+	*size = sizeof(H3Index);
+	PG_RETURN_H3INDEX(key);
+}
+
+/*
+ * Returns a value indicating the "cost" of inserting the new entry into a
+ * particular branch of the tree: the area the branch key has to grow by.
+ */
+Datum
+h3index_gist_penalty(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *origentry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	GISTENTRY  *newentry = (GISTENTRY *) PG_GETARG_POINTER(1);
+	float	   *penalty = (float *) PG_GETARG_POINTER(2);
+	H3Index		origKey = DatumGetH3Index(origentry->key);
+	H3Index		newKey = DatumGetH3Index(newentry->key);
+
+	*penalty = gist_key_size(gist_key_union(origKey, newKey))
+		- gist_key_size(origKey);
+
+	PG_RETURN_POINTER(penalty);
+}
+
+/*
+ * When an index page split is necessary, decides which entries on the page
+ * stay on the old page, and which move to the new page.
+ *
+ * Entries are sorted in hierarchy order, making every subtree contiguous,
+ * and split where the two resulting keys cover the smallest total area.
+ */
+Datum
+h3index_gist_picksplit(PG_FUNCTION_ARGS)
+{
+	GistEntryVector *entryvec = (GistEntryVector *) PG_GETARG_POINTER(0);
+	GIST_SPLITVEC *v = (GIST_SPLITVEC *) PG_GETARG_POINTER(1);
+	int			n = entryvec->n - FirstOffsetNumber;
+	int			margin = Max(1, n / 4);
+	int			split = n / 2;
+	double		best = -1;
+
+	GistSplitItem *items = palloc(n * sizeof(GistSplitItem));
+
+	/* union of items up to and including i, and from i onwards */
+	H3Index    *left = palloc(n * sizeof(H3Index));
+	H3Index    *right = palloc(n * sizeof(H3Index));
+
+	for (int i = 0; i < n; i++)
+	{
+		OffsetNumber offset = FirstOffsetNumber + i;
+		H3Index		key = DatumGetH3Index(entryvec->vector[offset].key);
+
+		items[i].offset = offset;
+		items[i].key = key;
+		items[i].order = gist_key_order(key);
+	}
+
+	qsort(items, n, sizeof(GistSplitItem), gist_split_item_cmp);
+
+	left[0] = items[0].key;
+	for (int i = 1; i < n; i++)
+		left[i] = gist_key_union(left[i - 1], items[i].key);
+
+	right[n - 1] = items[n - 1].key;
+	for (int i = n - 2; i >= 0; i--)
+		right[i] = gist_key_union(right[i + 1], items[i].key);
+
+	/* split before item i, keeping at least a quarter on either side */
+	for (int i = margin; i <= n - margin; i++)
+	{
+		double		cost = gist_key_size(left[i - 1]) + gist_key_size(right[i]);
+
+		if (best < 0 || cost < best
+			|| (cost == best && abs(i - n / 2) < abs(split - n / 2)))
+		{
+			best = cost;
+			split = i;
+		}
+	}
+
+	v->spl_left = palloc(n * sizeof(OffsetNumber));
+	v->spl_right = palloc(n * sizeof(OffsetNumber));
+	v->spl_nleft = 0;
+	v->spl_nright = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		if (i < split)
+			v->spl_left[v->spl_nleft++] = items[i].offset;
+		else
+			v->spl_right[v->spl_nright++] = items[i].offset;
+	}
+
+	v->spl_ldatum = H3IndexGetDatum(left[split - 1]);
+	v->spl_rdatum = H3IndexGetDatum(right[split]);
+
+	PG_RETURN_POINTER(v);
+}
+
+/*
+ * Returns true if two index entries are identical, false otherwise.
+ */
+Datum
+h3index_gist_same(PG_FUNCTION_ARGS)
+{
+	H3Index		a = PG_GETARG_H3INDEX(0);
+	H3Index		b = PG_GETARG_H3INDEX(1);
+	bool	   *result = (bool *) PG_GETARG_POINTER(2);
+
+	*result = (a == b);
+
+	PG_RETURN_POINTER(result);
+}
+
+/*
+ * Given an index entry p and a query value q, determines the index entry's
+ * "distance" from the query value. For inner entries this must be a lower
+ * bound of the distance to any leaf below.
+ */
+Datum
+h3index_gist_distance(PG_FUNCTION_ARGS)
+{
+	GISTENTRY  *entry = (GISTENTRY *) PG_GETARG_POINTER(0);
+	H3Index		query = PG_GETARG_H3INDEX(1);
+	bool	   *recheck = (bool *) PG_GETARG_POINTER(4);
+	H3Index		key = DatumGetH3Index(entry->key);
+	double		distance;
+
+	/* leaf distances are exact */
+	*recheck = false;
+
+	if (GIST_LEAF(entry))
+		distance = knn_distance(key, query);
+	else if (gist_key_is_cell(key))
+		distance = knn_distance_lower_bound(query, key);
+	else
+		distance = -1;
+
+	PG_RETURN_FLOAT8(distance);
+}
+
+static int
+h3index_gist_cmp(Datum x, Datum y, SortSupport ssup)
+{
+	return cell_range_hierarchy_cmp(DatumGetH3Index(x), DatumGetH3Index(y));
+}
+
+/*
+ * Sort support for sorted index builds, placing subtrees next to each other.
+ */
+Datum
+h3index_gist_sortsupport(PG_FUNCTION_ARGS)
+{
+	SortSupport ssup = (SortSupport) PG_GETARG_POINTER(0);
+
+	ssup->comparator = h3index_gist_cmp;
+	ssup->ssup_extra = NULL;
+
+	PG_RETURN_VOID();
+}
@@ -23,9 +23,9 @@
 #include "type.h"
 #include "error.h"
 
-#include "inttypes.h"
-
 #include "upstream_macros.h" // Technically not public API, but we need the bit macros
+#include "cell_range.h"
+#include "knn.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_spgist_config);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_spgist_choose);
@@ -33,38 +33,86 @@ PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_spgist_picksplit);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_spgist_inner_consistent);
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_spgist_leaf_consistent);
 
-#define H3_ROOT_INDEX -1
-#define NUM_BASE_CELLS 122
-#define MAX_H3_RES 15
+/*
+ * Tree layout
+ *
+ * Inner tuples without a prefix have one node per base cell. Inner tuples
+ * with a prefix cover the prefix cell, which is the lowest common ancestor of
+ * everything below. Their first node holds values exactly at the prefix
+ * (the prefix cell itself, and edges or vertexes owned by it), the remaining
+ * nodes hold each child cell: 7 for hexagons, 6 for pentagons.
+ *
+ * Values are placed by the cell owning them (see cell_range_owner), and all
+ * containment tests are done on the bit level (see cell_range.h).
+ */
 
-#define H3_NUM_CHILDREN 7
+/* node of values exactly at the prefix */
+#define SPGIST_EXACT_NODE 0
 
+/* Number of nodes of an inner tuple with given prefix */
 static int
-spgist_cmp(H3Index * a, H3Index * b)
+spgist_num_nodes(H3Index prefix)
 {
-	int			aRes = getResolution(*a);
-	int			bRes = getResolution(*b);
-	H3Index		aParent;
-	H3Index		bParent;
-	H3Error		error;
+	if (H3_GET_RESOLUTION(prefix) == MAX_H3_RES)
+		return 1;
+	return 1 + (isPentagon(prefix) ? NUM_DIGITS - 1 : NUM_DIGITS);
+}
 
-	cellToParent(*a, bRes, &aParent);
-	cellToParent(*b, aRes, &bParent);
+/* Node of an inner tuple with given prefix holding the given owner cell */
+static int
+spgist_node(H3Index prefix, H3Index owner)
+{
+	int			res = H3_GET_RESOLUTION(prefix);
+	int			digit;
 
-	/* a contains b */
-	if (*a == H3_ROOT_INDEX || *a == bParent)
-	{
-		return 1;
-	}
+	if (owner == prefix)
+		return SPGIST_EXACT_NODE;
+
+	/* pentagons skip the k-axes child */
+	digit = H3_GET_INDEX_DIGIT(owner, res + 1);
+	if (digit > PENTAGON_SKIPPED_DIGIT && isPentagon(prefix))
+		digit--;
+	return 1 + digit;
+}
 
-	/* a contained by b */
-	if (*b == H3_ROOT_INDEX || *b == aParent)
+/* Child cell of the given (non-exact) node of an inner tuple with given prefix */
+static H3Index
+spgist_node_cell(H3Index prefix, int node)
+{
+	int			digit = node - 1;
+
+	if (digit >= PENTAGON_SKIPPED_DIGIT && isPentagon(prefix))
+		digit++;
+	return cell_range_child(prefix, digit);
+}
+
+/*
+ * Can a value within region satisfy the query.
+ *
+ * With exact set, region is the only cell (owner) of values below.
+ */
+static bool
+spgist_region_consistent(H3Index region, bool exact, H3Index query, StrategyNumber strategy)
+{
+	switch (strategy)
 	{
-		return -1;
+		case RTSameStrategyNumber:
+			if (exact)
+				return region == cell_range_owner(query);
+			return cell_range_contains(region, cell_range_owner(query));
+		case RTContainsStrategyNumber:
+			/* only the query and its ancestors qualify */
+			return cell_range_contains(region, query);
+		case RTContainedByStrategyNumber:
+			if (exact)
+				return cell_range_contains(query, region);
+			return cell_range_overlaps(region, query);
+		case RTOverlapStrategyNumber:
+			return cell_range_overlaps(region, query);
+		default:
+			elog(ERROR, "unrecognized strategy number: %d", strategy);
 	}
-
-	/* no overlap */
-	return 0;
+	return false;
 }
 
 /*
@@ -94,7 +142,7 @@ h3index_spgist_config(PG_FUNCTION_ARGS)
 	// }
 	spgConfigOut *out = (spgConfigOut *) PG_GETARG_POINTER(1);
 
-	/* prefix is parent H3 index */
+	/* prefix is the cell covering everything below */
 	out->prefixType = in->attType;
 	/* no need for labels */
 	out->labelType = VOIDOID;
@@ -133,9 +181,8 @@ h3index_spgist_config(PG_FUNCTION_ARGS)
  *
  * NOTE: When working with an inner tuple having unlabeled nodes, it is an error
  * for choose to return spgAddNode, since the set of nodes is supposed to be
- * fixed in such cases. Also, there is no provision for generating an unlabeled
- * node in spgSplitTuple actions, since it is expected that an spgAddNode action
- * will be needed as well.
+ * fixed in such cases. Our nodes are fixed by the prefix, so values outside the
+ * prefix split the tuple below a new upper tuple for the common ancestor.
  */
 Datum
 h3index_spgist_choose(PG_FUNCTION_ARGS)
@@ -181,26 +228,57 @@ h3index_spgist_choose(PG_FUNCTION_ARGS)
 	 */
 	spgChooseOut *out = (spgChooseOut *) PG_GETARG_POINTER(1);
 
-	int			resolution = in->level;
-	H3Index     insert = DatumGetH3Index(in->datum);
-	int			node;
+	H3Index		insert = DatumGetH3Index(in->datum);
+	H3Index		owner = cell_range_owner(insert);
+	H3Index		prefix;
+	H3Index		ancestor;
 
 	out->resultType = spgMatchNode;
 	out->result.matchNode.levelAdd = 1;
 	out->result.matchNode.restDatum = H3IndexGetDatum(insert);
+	out->result.matchNode.nodeN = 0;
 
-	if (!in->allTheSame)
+	if (!in->hasPrefix)
 	{
-		if (resolution == 0)
-		{
-			node = getBaseCellNumber(insert);
-		}
-		else
-		{
-			node = H3_GET_INDEX_DIGIT(insert, resolution);
-		}
+		/* one node per base cell */
+		out->result.matchNode.nodeN = H3_GET_BASE_CELL(owner);
+		PG_RETURN_VOID();
+	}
+
+	prefix = DatumGetH3Index(in->prefixDatum);
 
-		out->result.matchNode.nodeN = node;
+	if (owner == prefix || (!in->allTheSame && cell_range_contains(prefix, owner)))
+	{
+		/* nodes of all-the-same tuples are picked by the core */
+		if (!in->allTheSame)
+			out->result.matchNode.nodeN = spgist_node(prefix, owner);
+		PG_RETURN_VOID();
+	}
+
+	/*
+	 * Value does not belong here, so push the tuple down below a new upper
+	 * tuple covering both. For all-the-same tuples (which only hold values
+	 * exactly at the prefix) the upper tuple may have the very same prefix.
+	 */
+	ancestor = cell_range_common_ancestor(prefix, owner);
+
+	out->resultType = spgSplitTuple;
+	out->result.splitTuple.prefixNodeLabels = NULL;
+	out->result.splitTuple.postfixHasPrefix = true;
+	out->result.splitTuple.postfixPrefixDatum = H3IndexGetDatum(prefix);
+
+	if (ancestor == H3_NULL)
+	{
+		out->result.splitTuple.prefixHasPrefix = false;
+		out->result.splitTuple.prefixNNodes = NUM_BASE_CELLS;
+		out->result.splitTuple.childNodeN = H3_GET_BASE_CELL(prefix);
+	}
+	else
+	{
+		out->result.splitTuple.prefixHasPrefix = true;
+		out->result.splitTuple.prefixPrefixDatum = H3IndexGetDatum(ancestor);
+		out->result.splitTuple.prefixNNodes = spgist_num_nodes(ancestor);
+		out->result.splitTuple.childNodeN = spgist_node(ancestor, prefix);
 	}
 
 	PG_RETURN_VOID();
@@ -230,61 +308,45 @@ h3index_spgist_picksplit(PG_FUNCTION_ARGS)
 {
 	spgPickSplitIn *in = (spgPickSplitIn *) PG_GETARG_POINTER(0);
 	spgPickSplitOut *out = (spgPickSplitOut *) PG_GETARG_POINTER(1);
-	int			resolution = in->level;
+	H3Index		prefix = cell_range_owner(DatumGetH3Index(in->datums[0]));
 
 	/* we don't need node labels */
 	out->nodeLabels = NULL;
 	out->mapTuplesToNodes = palloc(sizeof(int) * in->nTuples);
 	out->leafTupleDatums = palloc(sizeof(Datum) * in->nTuples);
 
-	if (resolution == 0)
+	/* prefix is the lowest common ancestor, if any */
+	for (int i = 1; i < in->nTuples && prefix != H3_NULL; i++)
 	{
-		/* at resolution 0 there is one node per base cell */
-		out->nNodes = NUM_BASE_CELLS;
+		H3Index		owner = cell_range_owner(DatumGetH3Index(in->datums[i]));
+
+		prefix = cell_range_common_ancestor(prefix, owner);
+	}
+
+	if (prefix == H3_NULL)
+	{
+		/* spanning several base cells, one node per base cell */
 		out->hasPrefix = false;
+		out->nNodes = NUM_BASE_CELLS;
 	}
 	else
 	{
-		/* at finer resolutions there is exactly 7 nodes, one per child */
-		H3Index first = DatumGetH3Index(in->datums[0]);
-		H3Index parent;
-		H3Error error;
-		h3_assert(cellToParent(first, resolution, &parent));
-
-
-		/*
-		 * TODO: consider decreasing nNodes for pentagons which only have 6
-		 * children?
-		 */
-		out->nNodes = H3_NUM_CHILDREN;
 		out->hasPrefix = true;
-		out->prefixDatum = H3IndexGetDatum(parent);
+		out->prefixDatum = H3IndexGetDatum(prefix);
+		out->nNodes = spgist_num_nodes(prefix);
 	}
 
 	/* map each leaf tuple to node in the new inner tuple */
 	for (int i = 0; i < in->nTuples; i++)
 	{
-		H3Index     insert = DatumGetH3Index(in->datums[i]);
-		int			node;
+		H3Index		owner = cell_range_owner(DatumGetH3Index(in->datums[i]));
 
-		if (resolution == 0)
-		{
-			/* first resolution is base cells */
-			node = getBaseCellNumber(insert);
-		}
-		else if (getResolution(insert) >= resolution)
-		{
-			/* finer resolutions use index digit 0-6 */
-			node = H3_GET_INDEX_DIGIT(insert, resolution);
-		}
+		if (prefix == H3_NULL)
+			out->mapTuplesToNodes[i] = H3_GET_BASE_CELL(owner);
 		else
-		{
-			/* coarse indexes are put into center node */
-			node = 0;
-		}
+			out->mapTuplesToNodes[i] = spgist_node(prefix, owner);
 
-		out->leafTupleDatums[i] = H3IndexGetDatum(insert);
-		out->mapTuplesToNodes[i] = node;
+		out->leafTupleDatums[i] = in->datums[i];
 	}
 
 	PG_RETURN_VOID();
@@ -293,106 +355,93 @@ h3index_spgist_picksplit(PG_FUNCTION_ARGS)
 /**
  * Returns set of nodes (branches) to follow during tree search.
  *
- * Each query is a single H3 index to be checked against the parent prefix
- *
- * We either return all or none (except for res 0)
+ * Each node covers a cell (or exactly a cell, for the first node of prefixed
+ * tuples), which is tested against every scan key. For ORDER BY <-> scans the
+ * distance to that cell is reported as well, bounding the exact distances of
+ * all leaves below from beneath so that they need no recheck.
  */
 Datum
 h3index_spgist_inner_consistent(PG_FUNCTION_ARGS)
 {
 	spgInnerConsistentIn *in = (spgInnerConsistentIn *) PG_GETARG_POINTER(0);
 	spgInnerConsistentOut *out = (spgInnerConsistentOut *) PG_GETARG_POINTER(1);
-	H3Index     parent = H3_NULL;
-	int			bc,
-				i;
-	bool		stop;
-	int			innerNodes = in->nNodes;
+	H3Index		prefix = H3_NULL;
+	int			first = 0;
+	int			last = in->nNodes - 1;
 
 	if (in->hasPrefix)
-	{
-		parent = DatumGetH3Index(in->prefixDatum);
-	}
+		prefix = DatumGetH3Index(in->prefixDatum);
 
-	if (in->allTheSame)
+	/* base cell tuples only need to visit the base cell of the query */
+	if (!in->hasPrefix && !in->allTheSame)
 	{
-		/* Report that all nodes should be visited */
-		out->nNodes = in->nNodes;
-		out->nodeNumbers = (int *) palloc(sizeof(int) * in->nNodes);
-		for (i = 0; i < in->nNodes; i++)
+		for (int i = 0; i < in->nkeys; i++)
 		{
-			out->nodeNumbers[i] = i;
+			H3Index		query = DatumGetH3Index(in->scankeys[i].sk_argument);
+			int			bc = H3_GET_BASE_CELL(query);
+
+			first = Max(first, bc);
+			last = Min(last, bc);
 		}
-		PG_RETURN_VOID();
 	}
 
-	out->levelAdds = palloc(sizeof(int) * innerNodes);
-	for (i = 0; i < innerNodes; ++i)
-		out->levelAdds[i] = 1;
-
-	/* We must descend into the quadrant(s) identified by which */
-	out->nodeNumbers = (int *) palloc(sizeof(int) * innerNodes);
 	out->nNodes = 0;
+	out->nodeNumbers = (int *) palloc(sizeof(int) * in->nNodes);
+	if (in->norderbys > 0)
+		out->distances = (double **) palloc(sizeof(double *) * in->nNodes);
 
-	/* "which" is a bitmask of child nodes that satisfy all constraints */
-	bc = -1;
-	stop = false;
-	for (i = 0; i < in->nkeys; i++)
+	for (int node = first; node <= last; node++)
 	{
-		/* each scankey is a constraint to be checked against */
-		StrategyNumber strategy = in->scankeys[i].sk_strategy;
-		H3Index    query = DatumGetH3Index(in->scankeys[i].sk_argument);
+		H3Index		region;
+		bool		exact;
+		bool		consistent = true;
 
-		if (parent == H3_NULL)
+		if (!in->hasPrefix)
 		{
-			if (bc > -1)
-			{
-				stop = true;
-			}
-			bc = getBaseCellNumber(query);
+			/* all-the-same nodes do not tell the base cell */
+			region = in->allTheSame ? H3_NULL : cell_range_base_cell(node);
+			exact = false;
+		}
+		else if (in->allTheSame || node == SPGIST_EXACT_NODE)
+		{
+			region = prefix;
+			exact = true;
 		}
 		else
 		{
-			switch (strategy)
-			{
-				case RTSameStrategyNumber:
-					if (spgist_cmp(&parent, &query) == 0)
-						stop = true;
-					break;
-				case RTContainsStrategyNumber:
-					if (spgist_cmp(&parent, &query) == 0)
-						stop = true;
-					/* no overlap */
-					break;
-				case RTContainedByStrategyNumber:
-					if (spgist_cmp(&parent, &query) == 0)
-						stop = true;
-					/* no overlap */
-					break;
-				default:
-					elog(ERROR, "unrecognized strategy number: %d", strategy);
-					break;
-			}
+			region = spgist_node_cell(prefix, node);
+			exact = false;
 		}
 
-		if (stop)
-			break;				/* no need to consider remaining conditions */
-	}
-
-	if (!stop)
-	{
-		if (bc > -1)
+		for (int i = 0; i < in->nkeys && consistent && region != H3_NULL; i++)
 		{
-			out->nodeNumbers[out->nNodes] = bc;
-			out->nNodes++;
+			StrategyNumber strategy = in->scankeys[i].sk_strategy;
+			H3Index		query = DatumGetH3Index(in->scankeys[i].sk_argument);
+
+			consistent = spgist_region_consistent(region, exact, query, strategy);
 		}
-		else
+
+		if (!consistent)
+			continue;
+
+		if (in->norderbys > 0)
 		{
-			for (i = 0; i < innerNodes; i++)
+			double	   *distances = palloc(sizeof(double) * in->norderbys);
+
+			for (int i = 0; i < in->norderbys; i++)
 			{
-				out->nodeNumbers[out->nNodes] = i;
-				out->nNodes++;
+				H3Index		query = DatumGetH3Index(in->orderbys[i].sk_argument);
+
+				if (region == H3_NULL)
+					distances[i] = -1;
+				else
+					distances[i] = knn_distance_lower_bound(query, region);
 			}
+			out->distances[out->nNodes] = distances;
 		}
+
+		out->nodeNumbers[out->nNodes] = node;
+		out->nNodes++;
 	}
 
 	PG_RETURN_VOID();
@@ -431,11 +480,15 @@ h3index_spgist_leaf_consistent(PG_FUNCTION_ARGS)
 				break;
 			case RTContainsStrategyNumber:
 				/* leaf contains the query */
-				retval = (spgist_cmp(&leaf, &query) > 0);
+				retval = cell_range_contains(leaf, query);
 				break;
 			case RTContainedByStrategyNumber:
-				/* leaf is contained by the query */
-				retval = (spgist_cmp(&leaf, &query) < 0);
+				/* leaf is strictly contained by the query */
+				retval = leaf != query && cell_range_contains(query, leaf);
+				break;
+			case RTOverlapStrategyNumber:
+				/* leaf contains or is contained by the query */
+				retval = cell_range_overlaps(leaf, query);
 				break;
 			default:
 				ereport(ERROR, (
@@ -448,5 +501,18 @@ h3index_spgist_leaf_consistent(PG_FUNCTION_ARGS)
 			break;
 	}
 
+	/* report exact distances for ORDER BY <-> */
+	if (retval && in->norderbys > 0)
+	{
+		out->distances = palloc(sizeof(double) * in->norderbys);
+		out->recheckDistances = false;
+		for (int i = 0; i < in->norderbys; i++)
+		{
+			H3Index		query = DatumGetH3Index(in->orderbys[i].sk_argument);
+
+			out->distances[i] = knn_distance(leaf, query);
+		}
+	}
+
 	PG_RETURN_BOOL(retval);
 }
@@ -20,6 +20,7 @@
 #include <fmgr.h> // PG_FUNCTION_ARGS
 
 #include "error.h"
+#include "knn.h"
 #include "type.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_distance);
@@ -69,20 +70,7 @@ h3index_distance(PG_FUNCTION_ARGS)
 {
 	H3Index		a = PG_GETARG_H3INDEX(0);
 	H3Index		b = PG_GETARG_H3INDEX(1);
-	int			resA = getResolution(a);
-	int			resB = getResolution(b);
-	H3Error		error;
-	int64_t		distance;
-
-	if (resA < resB)
-		h3_assert(cellToCenterChild(a, resB, &a));
-	else if (resB < resA)
-		h3_assert(cellToCenterChild(b, resA, &b));
-
-	error = gridDistance(a, b, &distance);
-	/* h3_assert(error); */
-	if (error)
-		distance = -1;
+	int64_t		distance = knn_distance(a, b);
 
 	PG_RETURN_INT64(distance);
 }
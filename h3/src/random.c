@@ -0,0 +1,370 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" // SET_VARSIZE
+#endif
+#include <h3api.h>
+
+#include <fmgr.h>				// PG_FUNCTION_ARGS
+#include <funcapi.h>			// SRF_IS_FIRSTCALL
+#include <math.h>				// asin
+#include <utils/builtins.h>		// text_to_cstring
+#include <utils/geo_decls.h>	// POLYGON
+
+#include "constants.h"
+#include "error.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_random_cells);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_random_polygons);
+
+/* clusters of points, spreading (one standard deviation) some distance */
+#define RANDOM_CLUSTER_COUNT 16
+#define RANDOM_CLUSTER_SPREAD_KM 50
+
+/* points along each road, a cell edge apart, turning a little at each */
+#define RANDOM_ROAD_POINTS 1000
+#define RANDOM_ROAD_TURN 0.1
+
+/* spread around pentagons and the antimeridian, in cell edge lengths */
+#define RANDOM_EDGE_SPREAD 3
+
+typedef enum
+{
+	RANDOM_UNIFORM,
+	RANDOM_CLUSTERS,
+	RANDOM_ROADS,
+	RANDOM_PENTAGONS,
+	RANDOM_ANTIMERIDIAN
+}	RandomDistribution;
+
+/* State of a set of random points */
+typedef struct
+{
+	RandomDistribution distribution;
+	uint64_t	seed;
+	int64_t		count;			/* points to produce */
+	int64_t		position;		/* next point */
+	int			resolution;
+	double		spread;			/* in radians */
+	LatLng		centers[RANDOM_CLUSTER_COUNT];	/* pentagons fit too */
+	int			numCenters;
+	LatLng		road;			/* last point of current road */
+	double		heading;
+}	RandomPoints;
+
+/* splitmix64, to hash the seed and position into independent streams */
+static uint64_t
+random_mix(uint64_t x)
+{
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+	return x ^ (x >> 31);
+}
+
+/* The n'th number in [0, 1) of a stream, given by the seed and position */
+static double
+random_uniform(uint64_t seed, int64_t position, int n)
+{
+	uint64_t	x = random_mix(seed + 0x9E3779B97F4A7C15 * (uint64_t) position);
+
+	return (random_mix(x + 0x9E3779B97F4A7C15 * (n + 1)) >> 11) * 0x1.0p-53;
+}
+
+/* Normally distributed, using the n'th and n + 1'th number */
+static double
+random_normal(uint64_t seed, int64_t position, int n)
+{
+	double		u = random_uniform(seed, position, n);
+	double		v = random_uniform(seed, position, n + 1);
+
+	return sqrt(-2 * log(1 - u)) * cos(2 * M_PI * v);
+}
+
+/* Uniform on the sphere */
+static void
+random_on_sphere(uint64_t seed, int64_t position, LatLng * out)
+{
+	out->lat = asin(2 * random_uniform(seed, position, 0) - 1);
+	out->lng = (2 * random_uniform(seed, position, 1) - 1) * M_PI;
+}
+
+/* Travels distance radians from a point towards a bearing */
+static void
+random_destination(const LatLng * from, double bearing, double distance, LatLng * out)
+{
+	double		lat = asin(sin(from->lat) * cos(distance)
+						   + cos(from->lat) * sin(distance) * cos(bearing));
+	double		lng = from->lng + atan2(sin(bearing) * sin(distance) * cos(from->lat),
+										cos(distance) - sin(from->lat) * sin(lat));
+
+	out->lat = lat;
+	out->lng = remainder(lng, 2 * M_PI);
+}
+
+static RandomDistribution
+random_distribution(text *name)
+{
+	char	   *distribution = text_to_cstring(name);
+
+	if (strcmp(distribution, "uniform") == 0)
+		return RANDOM_UNIFORM;
+	if (strcmp(distribution, "clusters") == 0)
+		return RANDOM_CLUSTERS;
+	if (strcmp(distribution, "roads") == 0)
+		return RANDOM_ROADS;
+	if (strcmp(distribution, "pentagons") == 0)
+		return RANDOM_PENTAGONS;
+	if (strcmp(distribution, "antimeridian") == 0)
+		return RANDOM_ANTIMERIDIAN;
+
+	ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Distribution must be uniform, clusters, roads, pentagons, or antimeridian.");
+	return RANDOM_UNIFORM;
+}
+
+/*
+ * Prepares count random points, spread around pentagons and the antimeridian
+ * by a few edges of cells at the given resolution.
+ */
+static void
+random_points_init(RandomPoints * points, RandomDistribution distribution,
+				   uint64_t seed, int64_t count, int resolution)
+{
+	double		edge;
+
+	ASSERT(count >= 0, ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Number of rows must not be negative");
+	h3_assert(getHexagonEdgeLengthAvgKm(resolution, &edge));
+
+	points->distribution = distribution;
+	points->seed = random_mix(seed);
+	points->count = count;
+	points->position = 0;
+	points->resolution = resolution;
+	points->spread = RANDOM_EDGE_SPREAD * edge / EARTH_RADIUS_KM;
+	points->numCenters = 0;
+
+	if (distribution == RANDOM_CLUSTERS)
+	{
+		/* centers at negative positions, apart from the points */
+		points->spread = RANDOM_CLUSTER_SPREAD_KM / EARTH_RADIUS_KM;
+		points->numCenters = RANDOM_CLUSTER_COUNT;
+		for (int i = 0; i < RANDOM_CLUSTER_COUNT; i++)
+			random_on_sphere(points->seed, -1 - i, &points->centers[i]);
+	}
+	else if (distribution == RANDOM_PENTAGONS)
+	{
+		H3Index		pentagons[RANDOM_CLUSTER_COUNT];
+
+		points->numCenters = pentagonCount();
+		h3_assert(getPentagons(resolution, pentagons));
+		for (int i = 0; i < points->numCenters; i++)
+			h3_assert(cellToLatLng(pentagons[i], &points->centers[i]));
+	}
+	else if (distribution == RANDOM_ROADS)
+	{
+		/* roads are a string of points an edge apart */
+		points->spread = edge / EARTH_RADIUS_KM;
+	}
+}
+
+/* Produces the next point, returning false when done */
+static bool
+random_points_next(RandomPoints * points, LatLng * out)
+{
+	uint64_t	seed = points->seed;
+	int64_t		i = points->position;
+
+	if (i >= points->count)
+		return false;
+	points->position++;
+
+	switch (points->distribution)
+	{
+		case RANDOM_UNIFORM:
+			random_on_sphere(seed, i, out);
+			break;
+
+		case RANDOM_CLUSTERS:
+		case RANDOM_PENTAGONS:
+			{
+				int			center = random_uniform(seed, i, 0) * points->numCenters;
+
+				random_destination(&points->centers[center],
+								   2 * M_PI * random_uniform(seed, i, 1),
+								   fabs(random_normal(seed, i, 2)) * points->spread,
+								   out);
+				break;
+			}
+
+		case RANDOM_ROADS:
+			if (i % RANDOM_ROAD_POINTS == 0)
+			{
+				/* start a new road */
+				random_on_sphere(seed, i, &points->road);
+				points->heading = 2 * M_PI * random_uniform(seed, i, 2);
+			}
+			else
+			{
+				points->heading += RANDOM_ROAD_TURN * random_normal(seed, i, 0);
+				random_destination(&points->road, points->heading, points->spread,
+								   &points->road);
+			}
+			*out = points->road;
+			break;
+
+		case RANDOM_ANTIMERIDIAN:
+			{
+				LatLng		meridian = {
+					.lat = asin(2 * random_uniform(seed, i, 0) - 1),
+					.lng = M_PI
+				};
+
+				/* east or west, by the sign of the normal */
+				random_destination(&meridian, M_PI_2,
+								   random_normal(seed, i, 1) * points->spread,
+								   out);
+				break;
+			}
+	}
+	return true;
+}
+
+/*
+ * Random cells, the same for the same seed. Points are drawn one at a time,
+ * so memory use does not depend on the number of cells.
+ */
+Datum
+h3_random_cells(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	RandomPoints *points;
+	LatLng		point;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		int			resolution = PG_GETARG_INT32(0);
+		int64_t		count = PG_GETARG_INT64(1);
+		RandomDistribution distribution = random_distribution(PG_GETARG_TEXT_PP(2));
+		int64_t		seed = PG_GETARG_INT64(3);
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		points = MemoryContextAlloc(funcctx->multi_call_memory_ctx, sizeof(RandomPoints));
+		random_points_init(points, distribution, seed, count, resolution);
+		funcctx->user_fctx = points;
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	points = funcctx->user_fctx;
+
+	if (random_points_next(points, &point))
+	{
+		H3Index		cell;
+
+		h3_assert(latLngToCell(&point, points->resolution, &cell));
+		SRF_RETURN_NEXT(funcctx, H3IndexGetDatum(cell));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+typedef struct
+{
+	RandomPoints centers;
+	double		radius;			/* in radians */
+	int			vertices;
+}	RandomPolygons;
+
+/*
+ * Random polygons with jagged edges, of vertices between 0.6 and 1 times the
+ * radius from their centers, which are drawn like the points of
+ * h3_random_cells.
+ */
+Datum
+h3_random_polygons(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	RandomPolygons *polygons;
+	LatLng		center;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		double		radius = PG_GETARG_FLOAT8(0);
+		int64_t		count = PG_GETARG_INT64(1);
+		RandomDistribution distribution = random_distribution(PG_GETARG_TEXT_PP(2));
+		int64_t		seed = PG_GETARG_INT64(3);
+		int			vertices = PG_GETARG_INT32(4);
+
+		ASSERT(radius > 0, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Radius must be positive");
+		ASSERT(vertices >= 3, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Polygons must have at least 3 vertices");
+		ASSERT(distribution != RANDOM_ROADS, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Distribution must be uniform, clusters, pentagons, or antimeridian.");
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		polygons = MemoryContextAlloc(funcctx->multi_call_memory_ctx, sizeof(RandomPolygons));
+		/* spread around pentagons and the antimeridian like the polygons */
+		random_points_init(&polygons->centers, distribution, seed, count, 0);
+		if (distribution != RANDOM_CLUSTERS)
+			polygons->centers.spread = radius / EARTH_RADIUS_KM;
+		polygons->radius = radius / EARTH_RADIUS_KM;
+		polygons->vertices = vertices;
+		funcctx->user_fctx = polygons;
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	polygons = funcctx->user_fctx;
+
+	if (random_points_next(&polygons->centers, &center))
+	{
+		RandomPoints *centers = &polygons->centers;
+		int64_t		i = centers->position - 1;
+		int			size = offsetof(POLYGON, p) + sizeof(Point) * polygons->vertices;
+		POLYGON    *polygon = palloc(size);
+
+		SET_VARSIZE(polygon, size);
+		polygon->npts = polygons->vertices;
+
+		/* vertices drawn from a stream of their own */
+		for (int v = 0; v < polygons->vertices; v++)
+		{
+			LatLng		vertex;
+			double		distance = polygons->radius
+				* (0.6 + 0.4 * random_uniform(centers->seed ^ 0xA5A5A5A5A5A5A5A5, i, v));
+
+			random_destination(&center, 2 * M_PI * v / polygons->vertices, distance, &vertex);
+			polygon->p[v].x = radsToDegs(vertex.lng);
+			polygon->p[v].y = radsToDegs(vertex.lat);
+
+			if (v == 0 || polygon->p[v].x < polygon->boundbox.low.x)
+				polygon->boundbox.low.x = polygon->p[v].x;
+			if (v == 0 || polygon->p[v].x > polygon->boundbox.high.x)
+				polygon->boundbox.high.x = polygon->p[v].x;
+			if (v == 0 || polygon->p[v].y < polygon->boundbox.low.y)
+				polygon->boundbox.low.y = polygon->p[v].y;
+			if (v == 0 || polygon->p[v].y > polygon->boundbox.high.y)
+				polygon->boundbox.high.y = polygon->p[v].y;
+		}
+
+		SRF_RETURN_NEXT(funcctx, PolygonPGetDatum(polygon));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -17,8 +17,7 @@
 #include <postgres.h>
 #include <h3api.h>
 
-#include <funcapi.h>			 // SRF_IS_FIRSTCALL
-#include <access/htup_details.h> // HeapTuple
+#include <funcapi.h> // SRF_IS_FIRSTCALL
 
 #include "type.h"
 #include "srf.h"
@@ -53,46 +52,3 @@ srf_return_h3_indexes_from_user_fctx(PG_FUNCTION_ARGS)
 		SRF_RETURN_DONE(funcctx);
 	}
 }
-
-/*
- * Returns hex/distance tuples from user_fctx
- * will skip missing (all zeros) indices
- */
-Datum
-srf_return_h3_index_distances_from_user_fctx(PG_FUNCTION_ARGS)
-{
-	FuncCallContext *funcctx = SRF_PERCALL_SETUP();
-	int			call_cntr = funcctx->call_cntr;
-	int			max_calls = funcctx->max_calls;
-
-	hexDistanceTuple *user_fctx = funcctx->user_fctx;
-	H3Index    *indices = user_fctx->indices;
-	int		   *distances = user_fctx->distances;
-
-	/* skip missing indices (all zeros) */
-	while (!indices[call_cntr])
-	{
-		funcctx->call_cntr = ++call_cntr;
-	};
-
-	if (call_cntr < max_calls)
-	{
-		TupleDesc	tuple_desc = funcctx->tuple_desc;
-		Datum		values[2];
-		bool		nulls[2] = {false};
-		HeapTuple	tuple;
-		Datum		result;
-
-		values[0] = H3IndexGetDatum(indices[call_cntr]);
-		values[1] = Int32GetDatum(distances[call_cntr]);
-
-		tuple = heap_form_tuple(tuple_desc, values, nulls);
-		result = HeapTupleGetDatum(tuple);
-
-		SRF_RETURN_NEXT(funcctx, result);
-	}
-	else
-	{
-		SRF_RETURN_DONE(funcctx);
-	}
-}
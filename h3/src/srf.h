@@ -19,20 +19,11 @@
 
 #include <h3api.h>
 
-typedef struct
-{
-	H3Index    *indices;
-	int		   *distances;
-}	hexDistanceTuple;
-
 /*	helper functions to return sets from user fctx */
 Datum		srf_return_h3_indexes_from_user_fctx(PG_FUNCTION_ARGS);
-Datum		srf_return_h3_index_distances_from_user_fctx(PG_FUNCTION_ARGS);
 
 /*	macros to pass on fcinfo to above helpers */
 #define SRF_RETURN_H3_INDEXES_FROM_USER_FCTX() \
 	return srf_return_h3_indexes_from_user_fctx(fcinfo)
-#define SRF_RETURN_H3_INDEX_DISTANCES_FROM_USER_FCTX() \
-	return srf_return_h3_index_distances_from_user_fctx(fcinfo)
 
 #endif /* H3_SRF_H */
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <funcapi.h>			 // SRF_IS_FIRSTCALL
+#include <miscadmin.h>			 // process_shared_preload_libraries_in_progress
+#include <access/htup_details.h> // heap_form_tuple
+#include <storage/ipc.h>		 // shmem_startup_hook
+#include <storage/lwlock.h>		 // AddinShmemInitLock
+#include <storage/shmem.h>		 // ShmemInitStruct
+#include <utils/builtins.h>		 // CStringGetTextDatum
+
+#include "error.h"
+#include "guc.h"
+#include "stat.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_stat_functions);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_stat_functions_reset);
+
+static H3StatState state = {
+	.enabled = &h3_guc_track_functions,
+	.shared = NULL
+};
+
+#if POSTGRESQL_VERSION_MAJOR >= 15
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+#endif
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+#if POSTGRESQL_VERSION_MAJOR >= 15
+static void
+stat_shmem_request(void)
+{
+	if (prev_shmem_request_hook)
+		prev_shmem_request_hook();
+
+	RequestAddinShmemSpace(sizeof(H3StatShared));
+}
+#endif
+
+static void
+stat_shmem_startup(void)
+{
+	H3StatShared *shared;
+	bool		found;
+
+	if (prev_shmem_startup_hook)
+		prev_shmem_startup_hook();
+
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+	shared = ShmemInitStruct(H3_STAT_RENDEZVOUS, sizeof(H3StatShared), &found);
+	if (!found)
+	{
+		memset(shared, 0, sizeof(H3StatShared));
+		SpinLockInit(&shared->mutex);
+		shared->reset = GetCurrentTimestamp();
+	}
+	LWLockRelease(AddinShmemInitLock);
+
+	state.shared = shared;
+}
+
+/*
+ * Publishes the state to h3_postgis, and allocates shared memory when
+ * preloaded. Otherwise nothing is tracked.
+ */
+void
+_stat_init(void)
+{
+	*find_rendezvous_variable(H3_STAT_RENDEZVOUS) = &state;
+
+	if (!process_shared_preload_libraries_in_progress)
+		return;
+
+#if POSTGRESQL_VERSION_MAJOR >= 15
+	prev_shmem_request_hook = shmem_request_hook;
+	shmem_request_hook = stat_shmem_request;
+#else
+	RequestAddinShmemSpace(sizeof(H3StatShared));
+#endif
+	prev_shmem_startup_hook = shmem_startup_hook;
+	shmem_startup_hook = stat_shmem_startup;
+}
+
+static void
+stat_assert_preloaded(void)
+{
+	ASSERT(state.shared != NULL, ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE,
+		   "h3 must be loaded via shared_preload_libraries to track functions");
+}
+
+/* Statistics of each function, since they were last reset */
+Datum
+h3_stat_functions(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	H3StatCounters *counters;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tuple_desc;
+		H3StatShared *snapshot;
+
+		stat_assert_preloaded();
+		stat_flush();
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		snapshot = palloc(sizeof(H3StatShared));
+		SpinLockAcquire(&state.shared->mutex);
+		memcpy(snapshot, state.shared, sizeof(H3StatShared));
+		SpinLockRelease(&state.shared->mutex);
+
+		ENSURE_TYPEFUNC_COMPOSITE(get_call_result_type(fcinfo, NULL, &tuple_desc));
+
+		funcctx->tuple_desc = BlessTupleDesc(tuple_desc);
+		funcctx->user_fctx = snapshot;
+		funcctx->max_calls = H3_STAT_FUNCTIONS;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		H3StatShared *snapshot = funcctx->user_fctx;
+		Datum		values[7];
+		bool		nulls[7] = {false};
+		HeapTuple	tuple;
+
+		counters = &snapshot->counters[funcctx->call_cntr];
+		values[0] = CStringGetTextDatum(stat_function_names[funcctx->call_cntr]);
+		values[1] = Int64GetDatum(counters->calls);
+		values[2] = Float8GetDatum(counters->total_ms);
+		values[3] = Float8GetDatum(counters->max_ms);
+		values[4] = Int64GetDatum(counters->rows);
+		values[5] = Int64GetDatum(counters->peak_memory);
+		values[6] = TimestampTzGetDatum(snapshot->reset);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+/* Resets statistics of all functions */
+Datum
+h3_stat_functions_reset(PG_FUNCTION_ARGS)
+{
+	TimestampTz now = GetCurrentTimestamp();
+
+	stat_assert_preloaded();
+	stat_flush();
+
+	SpinLockAcquire(&state.shared->mutex);
+	memset(state.shared->counters, 0, sizeof(state.shared->counters));
+	state.shared->reset = now;
+	SpinLockRelease(&state.shared->mutex);
+
+	PG_RETURN_VOID();
+}
@@ -0,0 +1,877 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <fmgr.h>					// PG_FUNCTION_ARGS
+#include <math.h>					// pow
+#include <access/htup_details.h>	// GETSTRUCT
+#include <catalog/pg_statistic.h>	// STATISTIC_NUM_SLOTS
+#include <commands/vacuum.h>		// VacAttrStats
+#include <nodes/nodeFuncs.h>		// is_funcclause
+#include <nodes/supportnodes.h>		// SupportRequestSelectivity
+#include <optimizer/cost.h>			// cpu_operator_cost
+#include <utils/array.h>			// array_create_iterator
+#include <utils/geo_decls.h>		// DatumGetPolygonP
+#include <utils/lsyscache.h>		// get_opname
+#include <utils/selfuncs.h>			// VariableStatData
+
+#include "cell_range.h"
+#include "constants.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_analyze);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_contsel);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_contjoinsel);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_hierarchysel);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_are_neighbor_cells_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_grid_disk_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_grid_ring_unsafe_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_children_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_uncompact_cells_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_to_cells_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_random_support);
+
+/*
+ * Besides the standard statistics, ANALYZE collects the fraction of values
+ * at each resolution and in each base cell. Kind numbers are picked from the
+ * range reserved for private use.
+ */
+#define STATISTIC_KIND_H3_RESOLUTION 13101
+#define STATISTIC_KIND_H3_BASE_CELL 13102
+
+/* same defaults as contsel and contjoinsel */
+#define DEFAULT_H3_CONTSEL 0.001
+
+typedef struct
+{
+	AnalyzeAttrComputeStatsFunc std_compute_stats;
+	void	   *std_extra_data;
+}	H3AnalyzeExtraData;
+
+/*
+ * Fractions of non-null values at each resolution and base cell, assumed to
+ * be independent. Constants are represented by a single resolution and base
+ * cell.
+ */
+typedef struct
+{
+	double		nullfrac;
+	double		resolutions[MAX_H3_RES + 1];
+	double		baseCells[NUM_BASE_CELLS];
+}	H3ColumnStats;
+
+typedef enum
+{
+	H3_SEL_CONTAINS,
+	H3_SEL_CONTAINED_BY,
+	H3_SEL_OVERLAPS,
+	H3_SEL_NEIGHBORS,
+	/* comparisons in hierarchy order (h3index_hierarchy_ops) */
+	H3_SEL_BEFORE,
+	H3_SEL_BEFORE_EQ,
+	H3_SEL_AFTER,
+	H3_SEL_AFTER_EQ
+}	H3SelectivityOp;
+
+static void
+h3index_compute_stats(VacAttrStats *stats, AnalyzeAttrFetchFunc fetchfunc,
+					  int samplerows, double totalrows)
+{
+	H3AnalyzeExtraData *extra = (H3AnalyzeExtraData *) stats->extra_data;
+	double		resolutions[MAX_H3_RES + 1] = {0};
+	double		baseCells[NUM_BASE_CELLS] = {0};
+	int			nonnull = 0;
+	int			slot = 0;
+	MemoryContext old;
+
+	/* standard statistics, which need their own extra data */
+	stats->extra_data = extra->std_extra_data;
+	extra->std_compute_stats(stats, fetchfunc, samplerows, totalrows);
+	stats->extra_data = extra;
+
+	if (!stats->stats_valid)
+		return;
+
+	for (int i = 0; i < samplerows; i++)
+	{
+		bool		isnull;
+		Datum		value = fetchfunc(stats, i, &isnull);
+		H3Index		h3;
+
+		if (isnull)
+			continue;
+
+		h3 = DatumGetH3Index(value);
+		resolutions[H3_GET_RESOLUTION(h3)]++;
+		if (H3_GET_BASE_CELL(h3) < NUM_BASE_CELLS)
+			baseCells[H3_GET_BASE_CELL(h3)]++;
+		nonnull++;
+	}
+
+	/* find two free slots */
+	while (slot < STATISTIC_NUM_SLOTS && stats->stakind[slot] != 0)
+		slot++;
+	if (nonnull == 0 || slot + 1 >= STATISTIC_NUM_SLOTS)
+		return;
+
+	old = MemoryContextSwitchTo(stats->anl_context);
+
+	stats->stakind[slot] = STATISTIC_KIND_H3_RESOLUTION;
+	stats->staop[slot] = InvalidOid;
+	stats->stacoll[slot] = InvalidOid;
+	stats->numnumbers[slot] = MAX_H3_RES + 1;
+	stats->stanumbers[slot] = palloc(sizeof(float4) * (MAX_H3_RES + 1));
+	for (int res = 0; res <= MAX_H3_RES; res++)
+		stats->stanumbers[slot][res] = resolutions[res] / nonnull;
+
+	slot++;
+	stats->stakind[slot] = STATISTIC_KIND_H3_BASE_CELL;
+	stats->staop[slot] = InvalidOid;
+	stats->stacoll[slot] = InvalidOid;
+	stats->numnumbers[slot] = NUM_BASE_CELLS;
+	stats->stanumbers[slot] = palloc(sizeof(float4) * NUM_BASE_CELLS);
+	for (int bc = 0; bc < NUM_BASE_CELLS; bc++)
+		stats->stanumbers[slot][bc] = baseCells[bc] / nonnull;
+
+	MemoryContextSwitchTo(old);
+}
+
+/* Wraps the standard typanalyze, adding resolution and base cell fractions */
+Datum
+h3index_analyze(PG_FUNCTION_ARGS)
+{
+	VacAttrStats *stats = (VacAttrStats *) PG_GETARG_POINTER(0);
+	H3AnalyzeExtraData *extra;
+
+	if (!std_typanalyze(stats))
+		PG_RETURN_BOOL(false);
+
+	extra = palloc(sizeof(H3AnalyzeExtraData));
+	extra->std_compute_stats = stats->compute_stats;
+	extra->std_extra_data = stats->extra_data;
+
+	stats->compute_stats = h3index_compute_stats;
+	stats->extra_data = extra;
+
+	PG_RETURN_BOOL(true);
+}
+
+/* Reads the statistics collected by h3index_analyze */
+static bool
+statistics_load(VariableStatData *vardata, H3ColumnStats *out)
+{
+	AttStatsSlot resSlot;
+	AttStatsSlot bcSlot;
+	bool		valid = false;
+
+	if (!HeapTupleIsValid(vardata->statsTuple))
+		return false;
+
+	if (!get_attstatsslot(&resSlot, vardata->statsTuple,
+						  STATISTIC_KIND_H3_RESOLUTION, InvalidOid,
+						  ATTSTATSSLOT_NUMBERS))
+		return false;
+
+	if (get_attstatsslot(&bcSlot, vardata->statsTuple,
+						 STATISTIC_KIND_H3_BASE_CELL, InvalidOid,
+						 ATTSTATSSLOT_NUMBERS))
+	{
+		if (resSlot.nnumbers == MAX_H3_RES + 1 && bcSlot.nnumbers == NUM_BASE_CELLS)
+		{
+			out->nullfrac = ((Form_pg_statistic) GETSTRUCT(vardata->statsTuple))->stanullfrac;
+			for (int res = 0; res <= MAX_H3_RES; res++)
+				out->resolutions[res] = resSlot.numbers[res];
+			for (int bc = 0; bc < NUM_BASE_CELLS; bc++)
+				out->baseCells[bc] = bcSlot.numbers[bc];
+			valid = true;
+		}
+		free_attstatsslot(&bcSlot);
+	}
+	free_attstatsslot(&resSlot);
+
+	return valid;
+}
+
+static void
+statistics_from_const(H3Index h3, H3ColumnStats *out)
+{
+	memset(out, 0, sizeof(H3ColumnStats));
+	out->resolutions[H3_GET_RESOLUTION(h3)] = 1;
+	if (H3_GET_BASE_CELL(h3) < NUM_BASE_CELLS)
+		out->baseCells[H3_GET_BASE_CELL(h3)] = 1;
+}
+
+/*
+ * Probability of "a op b" for random non-null a and b. A cell at resolution r
+ * is one of roughly 7^r cells in its base cell, so a cell at finer resolution
+ * has a chance of 7^-r to descend from a given cell at resolution r.
+ */
+static double
+statistics_selectivity(const H3ColumnStats *a, const H3ColumnStats *b, H3SelectivityOp op)
+{
+	double		sameBaseCell = 0;
+	double		sel = 0;
+
+	for (int bc = 0; bc < NUM_BASE_CELLS; bc++)
+		sameBaseCell += a->baseCells[bc] * b->baseCells[bc];
+
+	for (int aRes = 0; aRes <= MAX_H3_RES; aRes++)
+	{
+		for (int bRes = 0; bRes <= MAX_H3_RES; bRes++)
+		{
+			double		both = a->resolutions[aRes] * b->resolutions[bRes];
+
+			if (both == 0)
+				continue;
+
+			switch (op)
+			{
+				case H3_SEL_CONTAINS:
+					if (aRes <= bRes)
+						sel += both * pow(7, -aRes);
+					break;
+				case H3_SEL_CONTAINED_BY:
+					if (aRes > bRes)
+						sel += both * pow(7, -bRes);
+					break;
+				case H3_SEL_OVERLAPS:
+					sel += both * pow(7, -Min(aRes, bRes));
+					break;
+				case H3_SEL_NEIGHBORS:
+					if (aRes == bRes)
+						sel += both * 6 * pow(7, -aRes);
+					break;
+				default:
+					/* see statistics_order */
+					break;
+			}
+		}
+	}
+
+	sel *= sameBaseCell;
+	CLAMP_PROBABILITY(sel);
+
+	return sel;
+}
+
+static H3SelectivityOp
+statistics_operator(Oid operator)
+{
+	char	   *name = get_opname(operator);
+
+	if (name && strcmp(name, "@>") == 0)
+		return H3_SEL_CONTAINS;
+	if (name && strcmp(name, "<@") == 0)
+		return H3_SEL_CONTAINED_BY;
+	if (name && strcmp(name, "~<~") == 0)
+		return H3_SEL_BEFORE;
+	if (name && strcmp(name, "~<=~") == 0)
+		return H3_SEL_BEFORE_EQ;
+	if (name && strcmp(name, "~>~") == 0)
+		return H3_SEL_AFTER;
+	if (name && strcmp(name, "~>=~") == 0)
+		return H3_SEL_AFTER_EQ;
+	return H3_SEL_OVERLAPS;
+}
+
+/*
+ * Fraction of non-null values ordered before (or after) a constant in
+ * hierarchy order, from the base cell fractions: whole base cells sorting
+ * before that of the constant, and the share of its own base cell whose
+ * digits precede those of the constant, assuming digits are uniform.
+ */
+static double
+statistics_order(const H3ColumnStats *varStats, H3Index value, bool varonleft,
+				 H3SelectivityOp op)
+{
+	int			baseCell = Min(H3_GET_BASE_CELL(value), NUM_BASE_CELLS);
+	double		before = 0;
+	double		position = 0;
+	double		scale = 1;
+
+	for (int bc = 0; bc < baseCell; bc++)
+		before += varStats->baseCells[bc];
+
+	for (int res = 1; res <= H3_GET_RESOLUTION(value); res++)
+	{
+		scale /= 7;
+		position += H3_GET_INDEX_DIGIT(value, res) * scale;
+	}
+	if (baseCell < NUM_BASE_CELLS)
+		before += varStats->baseCells[baseCell] * position;
+
+	/* "const ~<~ var" holds for values after the constant */
+	if ((op == H3_SEL_BEFORE || op == H3_SEL_BEFORE_EQ) == varonleft)
+		return before;
+	return 1 - before;
+}
+
+/* Evaluates "a op b" for a single pair of values */
+static bool
+statistics_match(H3Index a, H3Index b, H3SelectivityOp op)
+{
+	switch (op)
+	{
+		case H3_SEL_BEFORE:
+			return cell_range_hierarchy_cmp(a, b) < 0;
+		case H3_SEL_BEFORE_EQ:
+			return cell_range_hierarchy_cmp(a, b) <= 0;
+		case H3_SEL_AFTER:
+			return cell_range_hierarchy_cmp(a, b) > 0;
+		case H3_SEL_AFTER_EQ:
+			return cell_range_hierarchy_cmp(a, b) >= 0;
+		default:
+			break;
+	}
+
+	a = cell_range_owner(a);
+	b = cell_range_owner(b);
+
+	switch (op)
+	{
+		case H3_SEL_CONTAINS:
+			return cell_range_contains(a, b);
+		case H3_SEL_CONTAINED_BY:
+			return a != b && cell_range_contains(b, a);
+		case H3_SEL_OVERLAPS:
+			return cell_range_overlaps(a, b);
+		default:
+			return false;
+	}
+}
+
+/*
+ * Fraction of non-null values matching the constant, checking the most
+ * common values and histogram bounds of the standard statistics directly.
+ * Values in the histogram are spread evenly across the column, and unlike
+ * the resolution and base cell fractions they capture clustered data. With
+ * no histogram, or no bounds matching, we use the fractions instead.
+ */
+static double
+statistics_sample(VariableStatData *vardata, const H3ColumnStats *varStats,
+				  H3Index value, bool varonleft, H3SelectivityOp op)
+{
+	AttStatsSlot sslot;
+	H3ColumnStats constStats;
+	double		model;
+	double		mcvSel = 0;
+	double		mcvFreq = 0;
+	double		histSel = -1;
+
+	statistics_from_const(value, &constStats);
+	if (op >= H3_SEL_BEFORE)
+		model = statistics_order(varStats, value, varonleft, op);
+	else
+		model = varonleft
+			? statistics_selectivity(varStats, &constStats, op)
+			: statistics_selectivity(&constStats, varStats, op);
+
+	if (get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_MCV,
+						 InvalidOid, ATTSTATSSLOT_VALUES | ATTSTATSSLOT_NUMBERS))
+	{
+		for (int i = 0; i < sslot.nvalues; i++)
+		{
+			H3Index		mcv = DatumGetH3Index(sslot.values[i]);
+
+			if (varonleft ? statistics_match(mcv, value, op) : statistics_match(value, mcv, op))
+				mcvSel += sslot.numbers[i];
+			mcvFreq += sslot.numbers[i];
+		}
+		free_attstatsslot(&sslot);
+	}
+
+	if (get_attstatsslot(&sslot, vardata->statsTuple, STATISTIC_KIND_HISTOGRAM,
+						 InvalidOid, ATTSTATSSLOT_VALUES))
+	{
+		int			matches = 0;
+
+		for (int i = 0; i < sslot.nvalues; i++)
+		{
+			H3Index		bound = DatumGetH3Index(sslot.values[i]);
+
+			if (varonleft ? statistics_match(bound, value, op) : statistics_match(value, bound, op))
+				matches++;
+		}
+		if (matches > 0)
+			histSel = (double) matches / sslot.nvalues;
+		else if (sslot.nvalues > 0)
+			histSel = Min(model, 1.0 / sslot.nvalues);
+		free_attstatsslot(&sslot);
+	}
+
+	if (histSel < 0)
+		histSel = model;
+
+	/* fractions above are of all non-null values, excluding MCVs here */
+	return mcvSel + Max(0, 1 - varStats->nullfrac - mcvFreq) * histSel;
+}
+
+/* Selectivity of "var op const" (or "const op var") */
+static double
+statistics_restriction(PlannerInfo *root, List *args, int varRelid, H3SelectivityOp op)
+{
+	VariableStatData vardata;
+	Node	   *other;
+	bool		varonleft;
+	H3ColumnStats varStats;
+	H3ColumnStats constStats;
+	H3Index		value;
+	double		sel = -1;
+
+	if (!get_restriction_variable(root, args, varRelid, &vardata, &other, &varonleft))
+		return -1;
+
+	if (IsA(other, Const) && ((Const *) other)->constisnull)
+		sel = 0;
+	else if (IsA(other, Const) && statistics_load(&vardata, &varStats))
+	{
+		value = DatumGetH3Index(((Const *) other)->constvalue);
+		if (op == H3_SEL_NEIGHBORS)
+		{
+			statistics_from_const(value, &constStats);
+			sel = (1 - varStats.nullfrac)
+				* statistics_selectivity(&varStats, &constStats, op);
+		}
+		else
+			sel = statistics_sample(&vardata, &varStats, value, varonleft, op);
+		CLAMP_PROBABILITY(sel);
+	}
+
+	ReleaseVariableStats(vardata);
+	return sel;
+}
+
+/* Selectivity of "var op var" in a join */
+static double
+statistics_join(PlannerInfo *root, List *args, SpecialJoinInfo *sjinfo, H3SelectivityOp op)
+{
+	VariableStatData vardata1;
+	VariableStatData vardata2;
+	bool		reversed;
+	H3ColumnStats stats1;
+	H3ColumnStats stats2;
+	double		sel = -1;
+
+	get_join_variables(root, args, sjinfo, &vardata1, &vardata2, &reversed);
+
+	if (statistics_load(&vardata1, &stats1) && statistics_load(&vardata2, &stats2))
+		sel = (1 - stats1.nullfrac) * (1 - stats2.nullfrac)
+			* statistics_selectivity(&stats1, &stats2, op);
+
+	ReleaseVariableStats(vardata1);
+	ReleaseVariableStats(vardata2);
+	return sel;
+}
+
+/* Restriction selectivity of containment operators */
+Datum
+h3index_contsel(PG_FUNCTION_ARGS)
+{
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	Oid			operator = PG_GETARG_OID(1);
+	List	   *args = (List *) PG_GETARG_POINTER(2);
+	int			varRelid = PG_GETARG_INT32(3);
+	double		sel = statistics_restriction(root, args, varRelid,
+											 statistics_operator(operator));
+
+	PG_RETURN_FLOAT8(sel < 0 ? DEFAULT_H3_CONTSEL : sel);
+}
+
+/* Join selectivity of containment operators */
+Datum
+h3index_contjoinsel(PG_FUNCTION_ARGS)
+{
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	Oid			operator = PG_GETARG_OID(1);
+	List	   *args = (List *) PG_GETARG_POINTER(2);
+	SpecialJoinInfo *sjinfo = (SpecialJoinInfo *) PG_GETARG_POINTER(4);
+	double		sel = statistics_join(root, args, sjinfo,
+									  statistics_operator(operator));
+
+	PG_RETURN_FLOAT8(sel < 0 ? DEFAULT_H3_CONTSEL : sel);
+}
+
+/*
+ * Restriction selectivity of comparisons in hierarchy order. The standard
+ * histogram is sorted in the default order, so scalarltsel would misjudge
+ * where the constant falls; its bounds are checked one by one instead.
+ */
+Datum
+h3index_hierarchysel(PG_FUNCTION_ARGS)
+{
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	Oid			operator = PG_GETARG_OID(1);
+	List	   *args = (List *) PG_GETARG_POINTER(2);
+	int			varRelid = PG_GETARG_INT32(3);
+	double		sel = statistics_restriction(root, args, varRelid,
+											 statistics_operator(operator));
+
+	PG_RETURN_FLOAT8(sel < 0 ? DEFAULT_INEQ_SEL : sel);
+}
+
+/* Selectivity of h3_are_neighbor_cells */
+Datum
+h3_are_neighbor_cells_support(PG_FUNCTION_ARGS)
+{
+	Node	   *rawreq = (Node *) PG_GETARG_POINTER(0);
+	SupportRequestSelectivity *req;
+	double		sel;
+
+	if (!IsA(rawreq, SupportRequestSelectivity))
+		PG_RETURN_POINTER(NULL);
+
+	req = (SupportRequestSelectivity *) rawreq;
+	if (req->is_join)
+		sel = statistics_join(req->root, req->args, req->sjinfo, H3_SEL_NEIGHBORS);
+	else
+		sel = statistics_restriction(req->root, req->args, req->varRelid, H3_SEL_NEIGHBORS);
+
+	if (sel < 0)
+		PG_RETURN_POINTER(NULL);
+
+	req->selectivity = sel;
+	PG_RETURN_POINTER(req);
+}
+
+/*
+ * Row estimates of set returning functions, from constant arguments or, for
+ * cells taken from a column, its resolution statistics. Each row costs about
+ * one operator call to produce, apart from polygon_to_cells which tests
+ * every cell against each polygon edge.
+ */
+typedef bool (*H3RowsEstimator) (PlannerInfo *root, List *args, double *rows, double *rowCost);
+
+static Node *
+statistics_srf_support(Node *rawreq, H3RowsEstimator estimator)
+{
+	double		rows;
+	double		rowCost = 1;
+
+	if (IsA(rawreq, SupportRequestRows))
+	{
+		SupportRequestRows *req = (SupportRequestRows *) rawreq;
+
+		if (is_funcclause(req->node)
+			&& estimator(req->root, ((FuncExpr *) req->node)->args, &rows, &rowCost))
+		{
+			req->rows = rows;
+			return (Node *) req;
+		}
+	}
+	else if (IsA(rawreq, SupportRequestCost))
+	{
+		SupportRequestCost *req = (SupportRequestCost *) rawreq;
+
+		if (is_funcclause(req->node)
+			&& estimator(req->root, ((FuncExpr *) req->node)->args, &rows, &rowCost))
+		{
+			/* the whole set is computed by each call */
+			req->startup = 0;
+			req->per_tuple = rows * rowCost * cpu_operator_cost;
+			return (Node *) req;
+		}
+	}
+	return NULL;
+}
+
+/* Value of a constant integer argument, or missing if it was omitted */
+static bool
+statistics_int_argument(List *args, int n, int missing, int *out)
+{
+	Node	   *arg;
+
+	if (list_length(args) <= n)
+	{
+		*out = missing;
+		return true;
+	}
+
+	arg = (Node *) list_nth(args, n);
+	if (!IsA(arg, Const) || ((Const *) arg)->constisnull)
+		return false;
+
+	*out = DatumGetInt32(((Const *) arg)->constvalue);
+	return true;
+}
+
+/* Value of a constant bigint argument */
+static bool
+statistics_int8_argument(List *args, int n, int64 *out)
+{
+	Node	   *arg = (Node *) list_nth(args, n);
+
+	if (!IsA(arg, Const) || ((Const *) arg)->constisnull)
+		return false;
+
+	*out = DatumGetInt64(((Const *) arg)->constvalue);
+	return true;
+}
+
+/* Statistics of an h3index argument, either constant or a column */
+static bool
+statistics_argument(PlannerInfo *root, Node *arg, H3ColumnStats *out)
+{
+	VariableStatData vardata;
+	bool		valid;
+
+	if (IsA(arg, Const))
+	{
+		if (((Const *) arg)->constisnull)
+			return false;
+		statistics_from_const(DatumGetH3Index(((Const *) arg)->constvalue), out);
+		return true;
+	}
+
+	if (root == NULL)
+		return false;
+
+	examine_variable(root, arg, 0, &vardata);
+	valid = statistics_load(&vardata, out);
+	ReleaseVariableStats(vardata);
+	return valid;
+}
+
+/*
+ * Approximate area of a polygon in degrees, scaling the planar area by the
+ * length of a degree at its mean latitude.
+ */
+static double
+statistics_polygon_area_km2(POLYGON *polygon)
+{
+	double		lat = (polygon->boundbox.low.y + polygon->boundbox.high.y) / 2;
+	double		degree = degsToRads(1) * EARTH_RADIUS_KM;
+	double		area = 0;
+
+	for (int i = 0; i < polygon->npts; i++)
+	{
+		Point	   *a = &polygon->p[i];
+		Point	   *b = &polygon->p[(i + 1) % polygon->npts];
+
+		area += a->x * b->y - b->x * a->y;
+	}
+
+	return fabs(area) / 2 * degree * degree * cos(degsToRads(lat));
+}
+
+/* 3k(k + 1) + 1 cells within distance k */
+static bool
+statistics_grid_disk_rows(PlannerInfo *root, List *args, double *rows, double *rowCost)
+{
+	int			k;
+
+	if (!statistics_int_argument(args, 1, 1, &k) || k < 0)
+		return false;
+
+	*rows = 3.0 * k * (k + 1) + 1;
+	return true;
+}
+
+/* 6k cells at distance k */
+static bool
+statistics_grid_ring_rows(PlannerInfo *root, List *args, double *rows, double *rowCost)
+{
+	int			k;
+
+	if (!statistics_int_argument(args, 1, 1, &k) || k < 0)
+		return false;
+
+	*rows = (k == 0) ? 1 : 6.0 * k;
+	return true;
+}
+
+/* 7^n children n resolutions down, averaged over the parents */
+static bool
+statistics_children_rows(PlannerInfo *root, List *args, double *rows, double *rowCost)
+{
+	H3ColumnStats stats;
+	int			childRes;
+	double		total = 0;
+	double		fraction = 0;
+
+	/* next resolution if none given */
+	if (list_length(args) < 2)
+	{
+		*rows = 7;
+		return true;
+	}
+
+	if (!statistics_int_argument(args, 1, -1, &childRes)
+		|| childRes < 0 || childRes > MAX_H3_RES
+		|| !statistics_argument(root, (Node *) linitial(args), &stats))
+		return false;
+
+	/* finer parents are an error, and do not count */
+	for (int res = 0; res <= childRes; res++)
+	{
+		total += stats.resolutions[res] * pow(7, childRes - res);
+		fraction += stats.resolutions[res];
+	}
+
+	if (fraction <= 0)
+		return false;
+
+	*rows = total / fraction;
+	return true;
+}
+
+/* 7^n children of each cell in a constant array */
+static bool
+statistics_uncompact_rows(PlannerInfo *root, List *args, double *rows, double *rowCost)
+{
+	Node	   *arg = (Node *) linitial(args);
+	ArrayType  *array;
+	ArrayIterator iterator;
+	Datum		value;
+	bool		isnull;
+	int			counts[MAX_H3_RES + 1] = {0};
+	int			maxRes = -1;
+	int			childRes;
+
+	if (!IsA(arg, Const) || ((Const *) arg)->constisnull)
+		return false;
+
+	array = DatumGetArrayTypeP(((Const *) arg)->constvalue);
+	iterator = array_create_iterator(array, 0, NULL);
+	while (array_iterate(iterator, &value, &isnull))
+	{
+		int			res;
+
+		if (isnull)
+			continue;
+		res = H3_GET_RESOLUTION(DatumGetH3Index(value));
+		counts[res]++;
+		maxRes = Max(maxRes, res);
+	}
+	array_free_iterator(iterator);
+
+	/* one step further than the highest resolution if none given */
+	if (!statistics_int_argument(args, 1, Min(maxRes + 1, MAX_H3_RES), &childRes)
+		|| childRes > MAX_H3_RES)
+		return false;
+
+	*rows = 0;
+	for (int res = 0; res <= childRes; res++)
+		*rows += counts[res] * pow(7, childRes - res);
+	return true;
+}
+
+/* Area of a constant polygon over the average cell area */
+static bool
+statistics_polygon_to_cells_rows(PlannerInfo *root, List *args, double *rows, double *rowCost)
+{
+	Node	   *exterior = (Node *) linitial(args);
+	Node	   *holes = (Node *) lsecond(args);
+	POLYGON    *polygon;
+	double		area;
+	double		cellArea;
+	int			edges;
+	int			res;
+
+	if (!IsA(exterior, Const) || ((Const *) exterior)->constisnull
+		|| !statistics_int_argument(args, 2, 1, &res)
+		|| getHexagonAreaAvgKm2(res, &cellArea) != E_SUCCESS)
+		return false;
+
+	polygon = DatumGetPolygonP(((Const *) exterior)->constvalue);
+	area = statistics_polygon_area_km2(polygon);
+	edges = polygon->npts;
+
+	/* holes given by anything but a constant are ignored */
+	if (IsA(holes, Const) && !((Const *) holes)->constisnull)
+	{
+		ArrayIterator iterator;
+		Datum		value;
+		bool		isnull;
+
+		iterator = array_create_iterator(DatumGetArrayTypeP(((Const *) holes)->constvalue), 0, NULL);
+		while (array_iterate(iterator, &value, &isnull))
+		{
+			if (isnull)
+				continue;
+			polygon = DatumGetPolygonP(value);
+			area -= statistics_polygon_area_km2(polygon);
+			edges += polygon->npts;
+		}
+		array_free_iterator(iterator);
+	}
+
+	*rows = Max(area, 0) / cellArea;
+	*rowCost = edges;
+	return true;
+}
+
+/* The number of rows asked for */
+static bool
+statistics_random_rows(PlannerInfo *root, List *args, double *rows, double *rowCost)
+{
+	int64		count;
+
+	if (!statistics_int8_argument(args, 1, &count) || count < 0)
+		return false;
+
+	*rows = count;
+	return true;
+}
+
+/* Row estimates of h3_grid_disk and h3_grid_disk_distances */
+Datum
+h3_grid_disk_support(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_POINTER(statistics_srf_support((Node *) PG_GETARG_POINTER(0),
+											 statistics_grid_disk_rows));
+}
+
+/* Row estimates of h3_grid_ring_unsafe */
+Datum
+h3_grid_ring_unsafe_support(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_POINTER(statistics_srf_support((Node *) PG_GETARG_POINTER(0),
+											 statistics_grid_ring_rows));
+}
+
+/* Row estimates of h3_cell_to_children */
+Datum
+h3_cell_to_children_support(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_POINTER(statistics_srf_support((Node *) PG_GETARG_POINTER(0),
+											 statistics_children_rows));
+}
+
+/* Row estimates of h3_uncompact_cells */
+Datum
+h3_uncompact_cells_support(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_POINTER(statistics_srf_support((Node *) PG_GETARG_POINTER(0),
+											 statistics_uncompact_rows));
+}
+
+/* Row estimates of h3_polygon_to_cells and h3_polygon_to_cells_experimental */
+Datum
+h3_polygon_to_cells_support(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_POINTER(statistics_srf_support((Node *) PG_GETARG_POINTER(0),
+											 statistics_polygon_to_cells_rows));
+}
+
+/* Row estimates of h3_random_cells and h3_random_polygons */
+Datum
+h3_random_support(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_POINTER(statistics_srf_support((Node *) PG_GETARG_POINTER(0),
+											 statistics_random_rows));
+}
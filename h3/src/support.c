@@ -0,0 +1,465 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <fmgr.h>				// PG_FUNCTION_ARGS
+#include <access/genam.h>		// index_open
+#include <access/nbtree.h>		// BTORDER_PROC
+#include <access/stratnum.h>	// BTEqualStrategyNumber, etc.
+#include <access/table.h>		// table_open
+#include <catalog/pg_am.h>		// BTREE_AM_OID
+#include <catalog/pg_type.h>	// BOOLOID
+#include <nodes/makefuncs.h>	// makeConst
+#include <nodes/nodeFuncs.h>	// exprType
+#include <nodes/pathnodes.h>	// PlannerInfo
+#include <nodes/supportnodes.h> // SupportRequestIndexCondition
+#include <parser/parsetree.h>	// rt_fetch
+#include <utils/array.h>		// construct_array
+#include <utils/lsyscache.h>	// get_opfamily_member
+#include <utils/rel.h>			// RelationData, RelationGetIndexList
+
+#include "cell_range.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_contains_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_contained_by_support);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3index_eq_support);
+
+/* opclass_btree.c */
+extern PGDLLEXPORT Datum h3index_hierarchy_cmp(PG_FUNCTION_ARGS);
+
+/* binding/hierarchy.c */
+extern PGDLLEXPORT Datum h3_cell_to_parent(PG_FUNCTION_ARGS);
+
+/*
+ * Planner support for the containment operators, allowing btree indexes to
+ * serve them.
+ *
+ * Ancestors of a constant are turned into an equality lookup of each of
+ * them. In hierarchy order (h3index_hierarchy_ops) descendants directly
+ * follow their ancestor, making them a single range. Conditions are lossy,
+ * leaving the original operator as a recheck.
+ *
+ * In the default order descendants are only contiguous per resolution, and
+ * since the resolution bits are more significant than the digits, a single
+ * range holding them all would span every cell of the intermediate
+ * resolutions. Index conditions are all ANDed, so the clause itself is
+ * rewritten into an OR of one range per resolution instead, which bitmap
+ * scans serve. For a valid cell these ranges hold exactly its descendants.
+ *
+ * The same ranges are added to "h3_cell_to_parent(key, res) = const". The
+ * planner only asks the support function of the operator, so that is done
+ * by the support function of the equality.
+ */
+/*
+ * Sets the resolution of cell, clearing (or filling) the digits below both
+ * resolutions. Filled, this is the ancestor at a coarser resolution, or the
+ * last possible descendant at a finer one.
+ */
+static H3Index
+support_at_resolution(H3Index cell, int res, bool fill)
+{
+	uint64_t	digits = H3_DIGITS_BELOW(Min(res, H3_GET_RESOLUTION(cell)));
+	H3Index		out = cell & ~(H3_RES_MASK | digits);
+
+	if (fill)
+		out |= digits;
+	return out | ((uint64_t) res << H3_RES_OFFSET);
+}
+
+static Expr *
+support_bound(Oid opfamily, Oid type, int strategy, Node *key, H3Index value)
+{
+	Oid			opno = get_opfamily_member(opfamily, type, type, strategy);
+	Const	   *bound;
+
+	if (!OidIsValid(opno))
+		return NULL;
+
+	bound = makeConst(type, -1, InvalidOid, sizeof(H3Index),
+					  H3IndexGetDatum(value), false, FLOAT8PASSBYVAL);
+	return make_opclause(opno, BOOLOID, false, (Expr *) key, (Expr *) bound,
+						 InvalidOid, InvalidOid);
+}
+
+/* key = ANY(ancestors of cell from res 0 up to maxRes) */
+static List *
+support_ancestors(Oid opfamily, Oid type, Node *key, H3Index cell, int maxRes)
+{
+	Oid			opno = get_opfamily_member(opfamily, type, type, BTEqualStrategyNumber);
+	Oid			arrayType = get_array_type(type);
+	Datum		ancestors[MAX_H3_RES + 1];
+	ArrayType  *array;
+	ScalarArrayOpExpr *expr;
+	int16		typlen;
+	bool		typbyval;
+	char		typalign;
+
+	if (!OidIsValid(opno) || !OidIsValid(arrayType) || maxRes < 0)
+		return NIL;
+
+	for (int res = 0; res <= maxRes; res++)
+		ancestors[res] = H3IndexGetDatum(support_at_resolution(cell, res, true));
+
+	get_typlenbyvalalign(type, &typlen, &typbyval, &typalign);
+	array = construct_array(ancestors, maxRes + 1, type, typlen, typbyval, typalign);
+
+	expr = makeNode(ScalarArrayOpExpr);
+	expr->opno = opno;
+	expr->opfuncid = get_opcode(opno);
+	expr->useOr = true;
+	expr->inputcollid = InvalidOid;
+	expr->args = list_make2(key, makeConst(arrayType, -1, InvalidOid, -1,
+										   PointerGetDatum(array), false, false));
+	expr->location = -1;
+
+	return list_make1(expr);
+}
+
+/* True if opfamily sorts in hierarchy order */
+static bool
+support_is_hierarchy(Oid opfamily, Oid type)
+{
+	Oid			proc = get_opfamily_proc(opfamily, type, type, BTORDER_PROC);
+	FmgrInfo	flinfo;
+
+	if (!OidIsValid(proc))
+		return false;
+
+	fmgr_info(proc, &flinfo);
+	return flinfo.fn_addr == h3index_hierarchy_cmp;
+}
+
+/* key between cell (exclusive if strict) and its last descendant */
+static List *
+support_descendants(Oid opfamily, Oid type, Node *key, H3Index cell, bool strict)
+{
+	Expr	   *lower;
+	Expr	   *upper;
+
+	if (!support_is_hierarchy(opfamily, type))
+		return NIL;
+
+	lower = support_bound(opfamily, type,
+						  strict ? BTGreaterStrategyNumber : BTGreaterEqualStrategyNumber,
+						  key, cell);
+	upper = support_bound(opfamily, type, BTLessEqualStrategyNumber, key,
+						  support_at_resolution(cell, MAX_H3_RES, true));
+
+	if (lower == NULL || upper == NULL)
+		return NIL;
+
+	return list_make2(lower, upper);
+}
+
+/*
+ * Finds the opfamilies of B-tree indexes on the column of key, in default
+ * and hierarchy order. Returns true if the column has other indexes as well
+ * (GiST, SP-GiST or BRIN), which serve the containment operators themselves.
+ */
+static bool
+support_column_btrees(PlannerInfo *root, Node *key, Oid *plain, Oid *hierarchy)
+{
+	Var		   *var = (Var *) key;
+	RangeTblEntry *rte;
+	Relation	rel;
+	List	   *indexes;
+	ListCell   *lc;
+	bool		other = false;
+
+	*plain = InvalidOid;
+	*hierarchy = InvalidOid;
+
+	if (root == NULL || !IsA(key, Var) || var->varlevelsup != 0 || var->varattno <= 0
+		|| var->varno > list_length(root->parse->rtable))
+		return false;
+
+	rte = rt_fetch(var->varno, root->parse->rtable);
+	if (rte->rtekind != RTE_RELATION)
+		return false;
+
+	/* already locked by the parser, like its indexes by the planner later */
+	rel = table_open(rte->relid, NoLock);
+	indexes = RelationGetIndexList(rel);
+	foreach(lc, indexes)
+	{
+		Relation	index = index_open(lfirst_oid(lc), AccessShareLock);
+
+		for (int col = 0; col < index->rd_index->indnkeyatts; col++)
+		{
+			Oid			opfamily = index->rd_opfamily[col];
+
+			if (index->rd_index->indkey.values[col] != var->varattno)
+				continue;
+
+			if (index->rd_rel->relam != BTREE_AM_OID)
+				other |= index->rd_rel->relam != HASH_AM_OID;
+			else if (support_is_hierarchy(opfamily, var->vartype))
+				*hierarchy = opfamily;
+			else
+				*plain = opfamily;
+		}
+		index_close(index, NoLock);
+	}
+	list_free(indexes);
+	table_close(rel, NoLock);
+
+	return other;
+}
+
+/*
+ * OR of the ranges of descendants of cell at each resolution, and cell itself
+ * unless strict, in the default order opfamily.
+ */
+static Node *
+support_ranges(Oid opfamily, Oid type, Node *key, H3Index cell, bool strict)
+{
+	List	   *ranges = NIL;
+
+	if (!strict)
+	{
+		Expr	   *equal = support_bound(opfamily, type, BTEqualStrategyNumber,
+										  copyObject(key), cell);
+
+		if (equal == NULL)
+			return NULL;
+		ranges = lappend(ranges, equal);
+	}
+
+	for (int res = H3_GET_RESOLUTION(cell) + 1; res <= MAX_H3_RES; res++)
+	{
+		Expr	   *lower = support_bound(opfamily, type, BTGreaterEqualStrategyNumber,
+										  copyObject(key),
+										  support_at_resolution(cell, res, false));
+		Expr	   *upper = support_bound(opfamily, type, BTLessEqualStrategyNumber,
+										  copyObject(key),
+										  support_at_resolution(cell, res, true));
+
+		if (lower == NULL || upper == NULL)
+			return NULL;
+		ranges = lappend(ranges, make_andclause(list_make2(lower, upper)));
+	}
+
+	if (list_length(ranges) == 1)
+		return (Node *) linitial(ranges);
+	return (Node *) make_orclause(ranges);
+}
+
+/*
+ * Rewrites "key <@ const" (strict) or "const @> key" into an OR of the ranges
+ * of descendants at each resolution, equal to the constant itself unless
+ * strict. Only valid cells are rewritten, as the ranges are exact for them.
+ */
+static Node *
+support_simplify(PlannerInfo *root, List *args, int keyArg, bool strict)
+{
+	Node	   *key = (Node *) list_nth(args, keyArg);
+	Node	   *other = (Node *) list_nth(args, 1 - keyArg);
+	Oid			plain;
+	Oid			hierarchy;
+	H3Index		cell;
+
+	if (!IsA(other, Const) || ((Const *) other)->constisnull)
+		return NULL;
+
+	cell = DatumGetH3Index(((Const *) other)->constvalue);
+	if (!isValidCell(cell) || (strict && H3_GET_RESOLUTION(cell) == MAX_H3_RES))
+		return NULL;
+
+	/* other indexes serve the operator, which the rewrite would take from them */
+	if (support_column_btrees(root, key, &plain, &hierarchy)
+		|| !OidIsValid(plain) || OidIsValid(hierarchy))
+		return NULL;
+
+	return support_ranges(plain, exprType(key), key, cell, strict);
+}
+
+/*
+ * Adds the descendants of const to "h3_cell_to_parent(key, res) = const",
+ * where res is the resolution of const, so B-tree indexes on key can serve
+ * it. The equality is kept, as h3_cell_to_parent raises an error for cells
+ * coarser than res.
+ */
+static Node *
+support_parent_simplify(PlannerInfo *root, FuncExpr *fcall)
+{
+	Node	   *parent = (Node *) linitial(fcall->args);
+	Node	   *other = (Node *) lsecond(fcall->args);
+	FuncExpr   *func;
+	Const	   *res;
+	Node	   *key;
+	Node	   *ranges;
+	FmgrInfo	flinfo;
+	Oid			plain;
+	Oid			hierarchy;
+	Oid			opno;
+	H3Index		cell;
+
+	if (IsA(parent, Const))
+	{
+		other = parent;
+		parent = (Node *) lsecond(fcall->args);
+	}
+
+	if (!IsA(parent, FuncExpr) || !IsA(other, Const) || ((Const *) other)->constisnull)
+		return NULL;
+
+	func = (FuncExpr *) parent;
+	if (list_length(func->args) != 2 || !IsA(lsecond(func->args), Const))
+		return NULL;
+
+	res = (Const *) lsecond(func->args);
+	cell = DatumGetH3Index(((Const *) other)->constvalue);
+	if (res->constisnull || !isValidCell(cell)
+		|| DatumGetInt32(res->constvalue) != H3_GET_RESOLUTION(cell))
+		return NULL;
+
+	fmgr_info(func->funcid, &flinfo);
+	if (flinfo.fn_addr != h3_cell_to_parent)
+		return NULL;
+
+	key = (Node *) linitial(func->args);
+	support_column_btrees(root, key, &plain, &hierarchy);
+	if (OidIsValid(hierarchy))
+	{
+		List	   *bounds = support_descendants(hierarchy, exprType(key),
+												 copyObject(key), cell, false);
+
+		ranges = bounds ? (Node *) make_andclause(bounds) : NULL;
+		plain = hierarchy;
+	}
+	else if (OidIsValid(plain))
+		ranges = support_ranges(plain, exprType(key), key, cell, false);
+	else
+		return NULL;
+
+	opno = get_opfamily_member(plain, exprType(key), exprType(key), BTEqualStrategyNumber);
+	if (ranges == NULL || !OidIsValid(opno))
+		return NULL;
+
+	return (Node *) make_andclause(list_make2(
+		make_opclause(opno, BOOLOID, false, (Expr *) parent, (Expr *) other,
+					  InvalidOid, InvalidOid),
+		ranges));
+}
+
+/*
+ * Index condition for "key @> const" (ancestors) or "const @> key"
+ * (descendants). Contained by is strict, excluding the constant itself.
+ */
+static Node *
+support_index_condition(SupportRequestIndexCondition *req, bool ancestors, bool strict)
+{
+	List	   *args;
+	Node	   *key;
+	Node	   *other;
+	H3Index		cell;
+
+	if (req->index->relam != BTREE_AM_OID)
+		return NULL;
+
+	if (is_opclause(req->node))
+		args = ((OpExpr *) req->node)->args;
+	else if (is_funcclause(req->node))
+		args = ((FuncExpr *) req->node)->args;
+	else
+		return NULL;
+
+	if (list_length(args) != 2)
+		return NULL;
+
+	key = (Node *) list_nth(args, req->indexarg);
+	other = (Node *) list_nth(args, 1 - req->indexarg);
+
+	if (!IsA(other, Const) || ((Const *) other)->constisnull)
+		return NULL;
+
+	cell = DatumGetH3Index(((Const *) other)->constvalue);
+
+	req->lossy = true;
+	if (ancestors)
+		return (Node *) support_ancestors(req->opfamily, exprType(key), key,
+										  cell, H3_GET_RESOLUTION(cell) - strict);
+	return (Node *) support_descendants(req->opfamily, exprType(key), key,
+										cell, strict);
+}
+
+Datum
+h3index_contains_support(PG_FUNCTION_ARGS)
+{
+	Node	   *rawreq = (Node *) PG_GETARG_POINTER(0);
+	Node	   *ret = NULL;
+
+	if (IsA(rawreq, SupportRequestIndexCondition))
+	{
+		SupportRequestIndexCondition *req = (SupportRequestIndexCondition *) rawreq;
+
+		/* key @> const, or const @> key */
+		ret = support_index_condition(req, req->indexarg == 0, false);
+	}
+	else if (IsA(rawreq, SupportRequestSimplify))
+	{
+		SupportRequestSimplify *req = (SupportRequestSimplify *) rawreq;
+
+		/* const @> key */
+		ret = support_simplify(req->root, req->fcall->args, 1, false);
+	}
+
+	PG_RETURN_POINTER(ret);
+}
+
+Datum
+h3index_contained_by_support(PG_FUNCTION_ARGS)
+{
+	Node	   *rawreq = (Node *) PG_GETARG_POINTER(0);
+	Node	   *ret = NULL;
+
+	if (IsA(rawreq, SupportRequestIndexCondition))
+	{
+		SupportRequestIndexCondition *req = (SupportRequestIndexCondition *) rawreq;
+
+		/* key <@ const, or const <@ key */
+		ret = support_index_condition(req, req->indexarg == 1, true);
+	}
+	else if (IsA(rawreq, SupportRequestSimplify))
+	{
+		SupportRequestSimplify *req = (SupportRequestSimplify *) rawreq;
+
+		/* key <@ const */
+		ret = support_simplify(req->root, req->fcall->args, 0, true);
+	}
+
+	PG_RETURN_POINTER(ret);
+}
+
+Datum
+h3index_eq_support(PG_FUNCTION_ARGS)
+{
+	Node	   *rawreq = (Node *) PG_GETARG_POINTER(0);
+	Node	   *ret = NULL;
+
+	if (IsA(rawreq, SupportRequestSimplify))
+	{
+		SupportRequestSimplify *req = (SupportRequestSimplify *) rawreq;
+
+		/* h3_cell_to_parent(key, res) = const */
+		ret = support_parent_simplify(req->root, req->fcall);
+	}
+
+	PG_RETURN_POINTER(ret);
+}
@@ -21,6 +21,7 @@
 #include <libpq/pqformat.h> // needed for send/recv functions
 
 #include "error.h"
+#include "hex.h"
 #include "type.h"
 
 /* conversion */
@@ -38,7 +39,8 @@ h3index_in(PG_FUNCTION_ARGS)
 	char	   *string = PG_GETARG_CSTRING(0);
 	H3Index		h3;
 
-	h3_assert(stringToH3(string, &h3));
+	if (!hex_to_h3(string, &h3))
+		h3_assert(stringToH3(string, &h3));
 
 	PG_RETURN_H3INDEX(h3);
 }
@@ -47,9 +49,9 @@ Datum
 h3index_out(PG_FUNCTION_ARGS)
 {
 	H3Index		h3 = PG_GETARG_H3INDEX(0);
-	char	   *string = palloc(17 * sizeof(char));
+	char	   *string = palloc(H3_HEX_MAX_LENGTH + 1);
 
-	h3_assert(h3ToString(h3, string, 17));
+	h3_to_hex(h3, string);
 
 	PG_RETURN_CSTRING(string);
 }
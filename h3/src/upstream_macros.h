@@ -21,6 +21,17 @@
 
 #include "h3api.h"
 
+/* SOURCE constants.h */
+
+/** The number of H3 base cells */
+#define NUM_BASE_CELLS 122
+
+/** Max H3 resolution; H3 version 1 has 16 resolutions, numbered 0 through 15 */
+#define MAX_H3_RES 15
+
+/** H3 index modes */
+#define H3_CELL_MODE 1
+
 /* SOURCE coordijk.h */
 
 /** @brief H3 digit representing ijk+ axes direction.
@@ -52,12 +63,69 @@ typedef enum {
 
 /* SOURCE h3Index.h */
 
+/** The bit offset of the reserved bits in an H3 index. */
+#define H3_RESERVED_OFFSET 56
+
+/** 1 in the highest bit, 0's everywhere else. */
+#define H3_HIGH_BIT_MASK ((uint64_t)(1) << 63)
+
+/** 1's in the 3 reserved bits, 0's everywhere else. */
+#define H3_RESERVED_MASK ((uint64_t)(7) << H3_RESERVED_OFFSET)
+
+/** The bit offset of the mode in an H3 index. */
+#define H3_MODE_OFFSET 59
+
+/** 1's in the 4 mode bits, 0's everywhere else. */
+#define H3_MODE_MASK ((uint64_t)(15) << H3_MODE_OFFSET)
+
+/** The bit offset of the resolution in an H3 index. */
+#define H3_RES_OFFSET 52
+
+/** 1's in the 4 resolution bits, 0's everywhere else. */
+#define H3_RES_MASK ((uint64_t)(15) << H3_RES_OFFSET)
+
+/** 0's in the 4 resolution bits, 1's everywhere else. */
+#define H3_RES_MASK_NEGATIVE (~H3_RES_MASK)
+
+/** The bit offset of the base cell in an H3 index. */
+#define H3_BC_OFFSET 45
+
+/** 1's in the 7 base cell bits, 0's everywhere else. */
+#define H3_BC_MASK ((uint64_t)(127) << H3_BC_OFFSET)
+
+/** H3 index with mode 0, res 0, base cell 0, and 7 for all index digits.
+ * Typically used to initialize the creation of an H3 cell index, which
+ * expects all direction digits to be 7 beyond the cell's resolution.
+ */
+#define H3_INIT (UINT64_C(35184372088831))
+
 /** The number of bits in a single H3 resolution digit. */
 #define H3_PER_DIGIT_OFFSET 3
 
 /** 1's in the 3 bits of res 15 digit bits, 0's everywhere else. */
 #define H3_DIGIT_MASK ((uint64_t)(7))
 
+/**
+ * Gets the integer mode of h3.
+ */
+#define H3_GET_MODE(h3) ((int)((((h3)&H3_MODE_MASK) >> H3_MODE_OFFSET)))
+
+/**
+ * Gets the integer resolution of h3.
+ */
+#define H3_GET_RESOLUTION(h3) ((int)((((h3)&H3_RES_MASK) >> H3_RES_OFFSET)))
+
+/**
+ * Sets the integer resolution of h3.
+ */
+#define H3_SET_RESOLUTION(h3, res) \
+    (h3) = (((h3)&H3_RES_MASK_NEGATIVE) | (((uint64_t)(res)) << H3_RES_OFFSET))
+
+/**
+ * Gets the integer base cell of h3.
+ */
+#define H3_GET_BASE_CELL(h3) ((int)((((h3)&H3_BC_MASK) >> H3_BC_OFFSET)))
+
 /**
  * Gets the resolution res integer digit (0-7) of h3.
  */
@@ -65,4 +133,13 @@ typedef enum {
     ((Direction)((((h3) >> ((MAX_H3_RES - (res)) * H3_PER_DIGIT_OFFSET)) & \
                   H3_DIGIT_MASK)))
 
+/**
+ * Sets the resolution res digit of h3 to the integer digit (0-7)
+ */
+#define H3_SET_INDEX_DIGIT(h3, res, digit)                                  \
+    (h3) = (((h3) & ~((H3_DIGIT_MASK                                        \
+                       << ((MAX_H3_RES - (res)) * H3_PER_DIGIT_OFFSET)))) | \
+            (((uint64_t)(digit))                                            \
+             << ((MAX_H3_RES - (res)) * H3_PER_DIGIT_OFFSET)))
+
 #endif /* H3_UPSTREAM_MACROS_H */
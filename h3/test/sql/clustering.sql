@@ -12,3 +12,16 @@ CLUSTER h3_test_clustering_index ON h3_test_clustering;
 SELECT hex = :hexagon FROM (
     SELECT hex FROM h3_test_clustering WHERE hex = :hexagon
 ) q;
+
+--
+-- TEST clustering on B-tree in hierarchy order
+--
+CREATE TABLE h3_test_clustering_hierarchy (hex h3index);
+INSERT INTO h3_test_clustering_hierarchy (hex)
+    SELECT h3_cell_to_children(:hexagon, res) FROM generate_series(0, 2) res;
+CREATE INDEX h3_test_clustering_hierarchy_index ON h3_test_clustering_hierarchy
+    USING btree (hex h3index_hierarchy_ops);
+CLUSTER h3_test_clustering_hierarchy USING h3_test_clustering_hierarchy_index;
+SELECT bool_and(prev ~<~ hex) FROM (
+    SELECT hex, lag(hex) OVER (ORDER BY ctid) prev FROM h3_test_clustering_hierarchy
+) q WHERE prev IS NOT NULL;
@@ -0,0 +1,121 @@
+\pset tuples_only on
+
+-- neighbouring indexes (one hexagon, one pentagon) at resolution 3
+\set hexagon '\'831c02fffffffff\'::h3index'
+\set pentagon '\'831c00fffffffff\'::h3index'
+\set resolution 3
+
+-- all resolution 1 cells, except the center children, spanning many blocks
+CREATE TABLE h3_test_h3set AS
+	SELECT c FROM (SELECT h3_cell_to_children(h3_get_res_0_cells(), 1) c) q
+	WHERE c <> h3_cell_to_center_child(h3_cell_to_parent(c));
+
+--
+-- TEST h3set input and output
+--
+
+-- text representation is the compacted cells
+SELECT '{}'::h3set::text = '{}';
+SELECT ('{' || array_to_string(ARRAY(SELECT h3_cell_to_children(:hexagon)), ',') || '}')::h3set::text
+	= '{' || :hexagon::text || '}';
+SELECT ('{ ' || array_to_string(ARRAY(SELECT h3_cell_to_children(:pentagon)), ' , ') || ' }')::h3set::text
+	= '{' || :pentagon::text || '}';
+
+-- round trips through arrays, sorted with each cell before its descendants
+SELECT ARRAY[:pentagon, :hexagon]::h3set::h3index[] = ARRAY[:pentagon, :hexagon];
+SELECT ARRAY(SELECT c FROM h3_test_h3set)::h3set::h3index[]::h3set
+	= ARRAY(SELECT c FROM h3_test_h3set)::h3set;
+
+-- arrays may hold mixed resolutions, duplicates and nulls
+SELECT ARRAY[
+	h3_cell_to_center_child(:hexagon), :hexagon, NULL, :hexagon
+]::h3set::h3index[] = ARRAY[:hexagon];
+
+-- stored smaller than the array of its cells
+SELECT pg_column_size(s) * 3 < pg_column_size(s::h3index[]) FROM (
+	SELECT ARRAY(SELECT c FROM h3_test_h3set)::h3set s
+) q;
+
+--
+-- TEST h3set membership
+--
+
+-- covers the cells of the set and their descendants
+SELECT bool_and(s @> c AND h3_cell_to_center_child(c, 10) <@ s) FROM (
+	SELECT ARRAY(SELECT c FROM h3_test_h3set)::h3set s
+) q, h3_test_h3set;
+
+-- but not their ancestors or any other cells
+SELECT NOT bool_or(h3_cell_to_parent(c) <@ s OR h3_cell_to_center_child(h3_cell_to_parent(c)) <@ s) FROM (
+	SELECT ARRAY(SELECT c FROM h3_test_h3set)::h3set s
+) q, h3_test_h3set;
+SELECT NOT :pentagon <@ ARRAY[:hexagon]::h3set;
+SELECT NOT :hexagon <@ '{}'::h3set;
+
+-- sets stored out of line give the same answers as in memory
+CREATE TABLE h3_test_h3set_stored (id integer, s h3set);
+ALTER TABLE h3_test_h3set_stored ALTER COLUMN s SET STORAGE external;
+INSERT INTO h3_test_h3set_stored SELECT 1, ARRAY(
+	SELECT c FROM (SELECT h3_cell_to_children(c, 2) c FROM h3_test_h3set) q
+	WHERE c <> h3_cell_to_center_child(h3_cell_to_parent(c))
+)::h3set;
+INSERT INTO h3_test_h3set_stored SELECT 2, s - ARRAY(
+	SELECT c FROM h3_test_h3set ORDER BY c LIMIT 10
+)::h3set FROM h3_test_h3set_stored;
+SELECT bool_and((s @> c) = (t @> c) AND (c <@ s) = (c <@ t)) AND bool_or(s @> c) AND NOT bool_and(s @> c)
+FROM h3_test_h3set_stored
+JOIN (SELECT id, s::h3index[]::h3set t FROM h3_test_h3set_stored) m USING (id),
+	(SELECT h3_cell_to_children(c, 2) c FROM h3_test_h3set) q;
+
+--
+-- TEST h3set algebra
+--
+
+-- union of the center child and its siblings is the parent
+SELECT ARRAY[h3_cell_to_center_child(:hexagon)]::h3set
+	+ ARRAY(SELECT c FROM h3_cell_to_children(:hexagon) c WHERE c <> h3_cell_to_center_child(:hexagon))::h3set
+	= ARRAY[:hexagon]::h3set;
+
+-- intersection keeps the finer of overlapping cells
+SELECT ARRAY[:hexagon, :pentagon]::h3set * ARRAY[h3_cell_to_center_child(:hexagon, 10)]::h3set
+	= ARRAY[h3_cell_to_center_child(:hexagon, 10)]::h3set;
+SELECT ARRAY[:hexagon]::h3set * ARRAY[:pentagon]::h3set = '{}';
+
+-- difference splits cells around the removed descendants
+SELECT ARRAY[:pentagon]::h3set - ARRAY[h3_cell_to_center_child(:pentagon)]::h3set
+	= ARRAY(SELECT c FROM h3_cell_to_children(:pentagon) c WHERE c <> h3_cell_to_center_child(:pentagon))::h3set;
+SELECT cardinality((ARRAY[:hexagon]::h3set - ARRAY[h3_cell_to_center_child(:hexagon, 10)]::h3set)::h3index[])
+	= 6 * (10 - :resolution);
+SELECT ARRAY[:hexagon]::h3set - ARRAY[h3_cell_to_center_child(:hexagon, 10)]::h3set
+	+ ARRAY[h3_cell_to_center_child(:hexagon, 10)]::h3set = ARRAY[:hexagon]::h3set;
+SELECT ARRAY[:hexagon]::h3set - ARRAY[h3_cell_to_parent(:hexagon)]::h3set = '{}';
+
+--
+-- TEST h3set aggregates
+--
+
+-- gives the same set as the cast from array
+SELECT h3set_agg(c) = ARRAY(SELECT c FROM h3_test_h3set)::h3set FROM h3_test_h3set;
+
+-- union of sets of all children is the parent
+SELECT h3set_union_agg(ARRAY[c]::h3set) = ARRAY[:hexagon]::h3set
+FROM h3_cell_to_children(:hexagon, :resolution + 2) c;
+
+-- is null without cells, like array_agg
+SELECT h3set_agg(c) IS NULL FROM (SELECT NULL::h3index c) q;
+
+-- and unions sets in parallel, where the leader merges the sets of the
+-- workers, which overlap as siblings share their parent
+ALTER TABLE h3_test_h3set SET (parallel_workers = 2);
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+EXPLAIN (COSTS OFF) SELECT h3set_union_agg(ARRAY[h3_cell_to_parent(c)]::h3set) FROM h3_test_h3set;
+SELECT h3set_union_agg(ARRAY[h3_cell_to_parent(c)]::h3set) = ARRAY(SELECT h3_get_res_0_cells())::h3set
+FROM h3_test_h3set;
+RESET parallel_setup_cost;
+RESET parallel_tuple_cost;
+RESET min_parallel_table_scan_size;
+
+DROP TABLE h3_test_h3set_stored;
+DROP TABLE h3_test_h3set;
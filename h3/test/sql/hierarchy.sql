@@ -77,6 +77,44 @@ SELECT array_agg(result) is null FROM (
 	EXCEPT SELECT unnest(ARRAY[:hexagon, :pentagon]) result
 ) q;
 
+-- compact aggregate gives the same result as h3_compact_cells
+SELECT array_agg(result) is null FROM (
+	SELECT unnest(h3_compact_agg(c)) result FROM (
+		SELECT h3_cell_to_children(:hexagon, :resolution + 2) c
+		UNION ALL SELECT h3_cell_to_children(:pentagon, :resolution + 2)
+	) q
+	EXCEPT SELECT unnest(ARRAY[:hexagon, :pentagon]) result
+) q;
+
+-- and accepts mixed resolutions, duplicates and nulls
+SELECT h3_compact_agg(c) = ARRAY[:hexagon] FROM (
+	SELECT h3_cell_to_children(:hexagon, :resolution + 1) c
+	UNION ALL SELECT h3_cell_to_children(h3_cell_to_center_child(:hexagon), :resolution + 3)
+	UNION ALL SELECT h3_cell_to_center_child(:hexagon)
+	UNION ALL SELECT NULL
+) q;
+
+-- is null without cells, like array_agg
+SELECT h3_compact_agg(c) IS NULL FROM (SELECT NULL::h3index c) q;
+
+-- and compacts partitions in parallel, compacting the partially compacted
+-- (and overlapping) cells of the workers again in the leader
+CREATE TABLE h3_test_compact_agg WITH (parallel_workers = 2) AS
+	SELECT h3_cell_to_children(:hexagon, :resolution + 4) c
+	UNION ALL SELECT h3_cell_to_children(:pentagon, :resolution + 3)
+	UNION ALL SELECT h3_cell_to_children(:hexagon, :resolution + 1);
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+EXPLAIN (COSTS OFF) SELECT h3_compact_agg(c) FROM h3_test_compact_agg;
+SELECT h3_compact_agg(c) AS compacted FROM h3_test_compact_agg \gset
+SELECT ARRAY(SELECT unnest(:'compacted'::h3index[]) ORDER BY 1)
+	= ARRAY(SELECT unnest(ARRAY[:hexagon, :pentagon]) ORDER BY 1);
+RESET parallel_setup_cost;
+RESET parallel_tuple_cost;
+RESET min_parallel_table_scan_size;
+DROP TABLE h3_test_compact_agg;
+
 -- compact is inverse of uncompact
 SELECT h3_compact_cells(ARRAY(SELECT h3_uncompact_cells(ARRAY[:hexagon], :resolution))) = :hexagon;
 
@@ -91,6 +129,13 @@ SELECT array_agg(result) is null FROM (
 	)
 ) q;
 
+-- children are produced one at a time, skipping the deleted pentagon subsequence
+SELECT COUNT(*) = 286 FROM h3_cell_to_children(:pentagon, :resolution + 3);
+
+-- so LIMIT stops long before all 7^12 children of a res 3 cell
+SELECT COUNT(*) = 10 FROM (SELECT h3_cell_to_children(:hexagon, 15) LIMIT 10) q;
+SELECT COUNT(*) = 10 FROM (SELECT h3_uncompact_cells(ARRAY[:hexagon, :pentagon], 15) LIMIT 10) q;
+
 --
 -- TEST h3_cell_to_children_slow
 --
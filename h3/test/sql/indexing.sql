@@ -30,6 +30,18 @@ SELECT h3_latlng_to_cell(g, r) = :pentagon FROM (
     SELECT h3_cell_to_latlng(:pentagon) AS g, h3_get_resolution(:pentagon) AS r
 ) AS q;
 
+-- batch indexing matches indexing one by one, keeping missing locations
+SELECT h3_latlng_to_cells(ARRAY[:geo, NULL, h3_cell_to_latlng(:pentagon)], :resolution)
+    = ARRAY[:hexagon, NULL, :pentagon];
+
+-- same for arrays of latitudes and longitudes
+SELECT h3_latlng_to_cells(
+    ARRAY[(:geo)[1], NULL, 0], ARRAY[(:geo)[0], 0, NULL], :resolution
+) = ARRAY[:hexagon, NULL, NULL];
+
+-- empty arrays give empty arrays
+SELECT h3_latlng_to_cells('{}'::point[], :resolution) = '{}'::h3index[];
+
 --
 -- TEST h3_cell_to_boundary
 --
@@ -44,6 +56,27 @@ SELECT h3_polygon_to_cells(h3_cell_to_boundary(:pentagon), null, :resolution) =
 SELECT h3_cell_to_boundary(:hexagon) ~= h3_cell_to_boundary(:hexagon, true)
 AND NOT h3_cell_to_boundary(:edgecross) ~= h3_cell_to_boundary(:edgecross, true);
 
+-- batch centroids match centroids one by one, with NaN for missing indexes
+SELECT h3_cells_to_latlngs(ARRAY[:hexagon, NULL, :pentagon]) = ARRAY[
+    (h3_cell_to_latlng(:hexagon))[0], (h3_cell_to_latlng(:hexagon))[1],
+    'NaN', 'NaN',
+    (h3_cell_to_latlng(:pentagon))[0], (h3_cell_to_latlng(:pentagon))[1]
+];
+
+-- batch boundaries match boundaries one by one, with empty boundaries for missing indexes
+SELECT bool_and(
+    offsets[n + 1] - offsets[n] = coalesce(npoints(h3_cell_to_boundary(cell)), 0)
+    AND (cell IS NULL OR h3_cell_to_boundary(cell) ~= (
+        SELECT ('(' || string_agg(point(coords[2 * k + 1], coords[2 * k + 2])::text, ',' ORDER BY k) || ')')::polygon
+        FROM generate_series(offsets[n], offsets[n + 1] - 1) AS k
+    ))
+) FROM
+    h3_cells_to_boundaries(ARRAY[:hexagon, NULL, :pentagon, :edgecross]),
+    unnest(ARRAY[:hexagon, NULL, :pentagon, :edgecross]) WITH ORDINALITY AS c(cell, n);
+
+-- empty arrays give empty arrays
+SELECT coords = '{}' AND offsets = '{0}' FROM h3_cells_to_boundaries('{}');
+
 -- cell to parent RES_MISMATCH
 CREATE FUNCTION h3_fail_indexing_cell_to_parent() RETURNS boolean LANGUAGE PLPGSQL
     AS $$
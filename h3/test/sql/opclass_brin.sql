@@ -11,3 +11,19 @@ CREATE INDEX h3_brin ON h3_test_brin USING brin (hex);
 SELECT hex = :hexagon FROM (
   SELECT hex FROM h3_test_brin WHERE hex = :hexagon
 ) q;
+
+--
+-- Test BRIN inclusion operator class
+--
+CREATE TABLE h3_test_brin_inclusion (hex h3index);
+INSERT INTO h3_test_brin_inclusion (hex)
+    SELECT h3_cell_to_children(cell, 3) FROM h3_get_res_0_cells() cell ORDER BY 1;
+CREATE INDEX h3_brin_inclusion ON h3_test_brin_inclusion
+    USING brin (hex h3index_inclusion_ops) WITH (pages_per_range = 1);
+SET enable_seqscan = off;
+\set parent 'h3_cell_to_parent(\'8a2a1072b59ffff\', 0)'
+SELECT COUNT(*) = 343 FROM h3_test_brin_inclusion WHERE hex <@ :parent;
+SELECT COUNT(*) = 1 FROM h3_test_brin_inclusion WHERE hex @> '8a2a1072b59ffff';
+SELECT COUNT(*) = 343 FROM h3_test_brin_inclusion WHERE hex && :parent;
+SELECT COUNT(*) = 1 FROM h3_test_brin_inclusion WHERE hex = h3_cell_to_center_child(:parent, 3);
+RESET enable_seqscan;
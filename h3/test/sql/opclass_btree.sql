@@ -11,3 +11,69 @@ CREATE INDEX h3_btree ON h3_test_btree USING btree (hex);
 SELECT hex = :hexagon FROM (
     SELECT hex FROM h3_test_btree WHERE hex = :hexagon
 ) q;
+
+--
+-- TEST b-tree planner support for containment operators
+--
+\set cell '\'8a2a1072b59ffff\'::h3index'
+\set parent 'h3_cell_to_parent(:cell, 7)'
+CREATE TABLE h3_test_btree_containment (hex h3index);
+INSERT INTO h3_test_btree_containment (hex)
+    SELECT h3_cell_to_children(:parent, 10)
+    UNION ALL SELECT h3_cell_to_parent(:cell, res) FROM generate_series(0, 9) res;
+CREATE INDEX h3_btree_containment ON h3_test_btree_containment USING btree (hex);
+
+CREATE FUNCTION h3_test_btree_plan(query text) RETURNS text AS $$
+DECLARE
+    plan json;
+BEGIN
+    EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO plan;
+    RETURN plan::text;
+END;
+$$ LANGUAGE plpgsql;
+
+SET enable_seqscan = off;
+-- ancestors are looked up, descendants scanned in one range per resolution
+SELECT h3_test_btree_plan($$
+    SELECT * FROM h3_test_btree_containment WHERE hex @> $$ || quote_literal(:cell)
+) LIKE '%"Index Cond"%';
+SELECT h3_test_btree_plan($$
+    SELECT * FROM h3_test_btree_containment WHERE hex <@ $$ || quote_literal(:parent)
+) LIKE '%"BitmapOr"%"Index Cond"%';
+SELECT h3_test_btree_plan($$
+    SELECT * FROM h3_test_btree_containment WHERE $$ || quote_literal(:parent) || $$ @> hex
+) LIKE '%"BitmapOr"%"Index Cond"%';
+SELECT COUNT(*) = 345 FROM h3_test_btree_containment WHERE hex <@ :parent;
+SELECT COUNT(*) = 346 FROM h3_test_btree_containment WHERE :parent @> hex;
+SELECT COUNT(*) = 11 FROM h3_test_btree_containment WHERE hex @> :cell;
+SELECT COUNT(*) = 10 FROM h3_test_btree_containment WHERE :cell <@ hex;
+-- parents at the resolution of a constant are found among its descendants
+SELECT h3_test_btree_plan($$
+    SELECT * FROM h3_test_btree_containment WHERE h3_cell_to_parent(hex, 7) = $$ || quote_literal(:parent)
+) LIKE '%"BitmapOr"%"Index Cond"%';
+SELECT COUNT(*) = 346 FROM h3_test_btree_containment WHERE h3_cell_to_parent(hex, 7) = :parent;
+RESET enable_seqscan;
+
+--
+-- TEST b-tree hierarchy operator class
+--
+DROP INDEX h3_btree_containment;
+CREATE INDEX h3_btree_hierarchy ON h3_test_btree_containment
+    USING btree (hex h3index_hierarchy_ops);
+SET enable_seqscan = off;
+SELECT h3_test_btree_plan($$
+    SELECT * FROM h3_test_btree_containment WHERE hex <@ $$ || quote_literal(:parent)
+) LIKE '%"Index Cond"%';
+SELECT COUNT(*) = 345 FROM h3_test_btree_containment WHERE hex <@ :parent;
+SELECT COUNT(*) = 346 FROM h3_test_btree_containment WHERE :parent @> hex;
+SELECT COUNT(*) = 11 FROM h3_test_btree_containment WHERE hex @> :cell;
+SELECT h3_test_btree_plan($$
+    SELECT * FROM h3_test_btree_containment WHERE h3_cell_to_parent(hex, 7) = $$ || quote_literal(:parent)
+) LIKE '%"Index Cond"%';
+SELECT COUNT(*) = 346 FROM h3_test_btree_containment WHERE h3_cell_to_parent(hex, 7) = :parent;
+RESET enable_seqscan;
+-- parent is directly followed by all its descendants
+SELECT MAX(rn) - MIN(rn) = 345 FROM (
+    SELECT hex, row_number() OVER (ORDER BY hex USING ~<~) rn
+    FROM h3_test_btree_containment
+) q WHERE :parent @> hex;
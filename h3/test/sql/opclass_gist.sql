@@ -0,0 +1,66 @@
+\pset tuples_only on
+\set hexagon '\'831c02fffffffff\'::h3index'
+\set knn '\'8a2a1072b59ffff\'::h3index'
+
+CREATE TABLE h3_test_gist (hex h3index);
+CREATE INDEX GIST_IDX ON h3_test_gist USING gist(hex);
+INSERT INTO h3_test_gist (hex) SELECT h3_cell_to_parent(:hexagon);
+INSERT INTO h3_test_gist (hex) SELECT h3_cell_to_children(:hexagon);
+INSERT INTO h3_test_gist (hex) SELECT h3_cell_to_center_child(:hexagon, 15);
+INSERT INTO h3_test_gist (hex) SELECT h3_grid_disk(:hexagon, 3);
+
+SET enable_seqscan = off;
+
+--
+-- TEST GiST
+--
+SELECT COUNT(*) = 2 FROM h3_test_gist WHERE hex @> :hexagon;
+SELECT COUNT(*) = 8 FROM h3_test_gist WHERE hex <@ :hexagon;
+SELECT COUNT(*) = 10 FROM h3_test_gist WHERE hex && :hexagon;
+SELECT COUNT(*) = 1 FROM h3_test_gist WHERE hex = :hexagon;
+
+--
+-- TEST KNN
+--
+CREATE TABLE h3_test_gist_knn AS
+    SELECT h3_cell_to_children(h3_grid_disk(h3_cell_to_parent(:knn, 6), 5), 8) AS hex;
+CREATE INDEX GIST_KNN_IDX ON h3_test_gist_knn USING gist(hex);
+
+CREATE FUNCTION h3_test_gist_plan(query text) RETURNS text AS $$
+DECLARE
+    plan json;
+BEGIN
+    EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO plan;
+    RETURN plan::text;
+END;
+$$ LANGUAGE plpgsql;
+
+-- ordering is served by the index, without a separate sort
+SELECT plan LIKE '%"Index Name": "gist_knn_idx"%'
+    AND plan NOT LIKE '%"Node Type": "Sort"%'
+FROM h3_test_gist_plan($$
+    SELECT hex FROM h3_test_gist_knn ORDER BY hex <-> $$ || quote_literal(:knn) || $$ LIMIT 100
+$$) plan;
+
+SELECT array_agg(d) FROM (
+    SELECT hex <-> :knn AS d FROM h3_test_gist_knn
+    ORDER BY hex <-> :knn LIMIT 100
+) q \gset index_
+
+RESET enable_seqscan;
+SET enable_indexscan = off;
+SET enable_bitmapscan = off;
+
+SELECT array_agg(d) = :'index_array_agg' FROM (
+    SELECT hex <-> :knn AS d FROM h3_test_gist_knn
+    ORDER BY hex <-> :knn LIMIT 100
+) q;
+
+RESET enable_indexscan;
+RESET enable_bitmapscan;
+
+--
+
+TRUNCATE TABLE h3_test_gist;
+INSERT INTO h3_test_gist (hex) SELECT h3_cell_to_children(h3_cell_to_center_child(:hexagon, 10), 15);
+SELECT COUNT(*) = 16807 FROM h3_test_gist WHERE hex <@ :hexagon;
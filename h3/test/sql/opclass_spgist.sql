@@ -1,5 +1,7 @@
 \pset tuples_only on
 \set hexagon '\'831c02fffffffff\'::h3index'
+\set pentagon '\'831c00fffffffff\'::h3index'
+\set knn '\'8a2a1072b59ffff\'::h3index'
 
 CREATE TABLE h3_test_spgist (hex h3index);
 CREATE INDEX SPGIST_IDX ON h3_test_spgist USING spgist(hex h3index_ops_experimental);
@@ -18,3 +20,75 @@ SELECT COUNT(*) = 8 FROM h3_test_spgist WHERE hex <@ :hexagon;
 TRUNCATE TABLE h3_test_spgist;
 INSERT INTO h3_test_spgist (hex) SELECT h3_cell_to_children(h3_cell_to_center_child(:hexagon, 10), 15);
 SELECT COUNT(*) = 16807 FROM h3_test_spgist WHERE hex <@ :hexagon;
+
+--
+-- TEST KNN
+--
+CREATE TABLE h3_test_spgist_knn AS
+    SELECT h3_cell_to_children(h3_grid_disk(h3_cell_to_parent(:knn, 6), 5), 8) AS hex;
+CREATE INDEX SPGIST_KNN_IDX ON h3_test_spgist_knn USING spgist(hex);
+
+SET enable_seqscan = off;
+SELECT array_agg(d) FROM (
+    SELECT hex <-> :knn AS d FROM h3_test_spgist_knn
+    ORDER BY hex <-> :knn LIMIT 100
+) q \gset index_
+
+RESET enable_seqscan;
+SET enable_indexscan = off;
+SET enable_bitmapscan = off;
+
+SELECT array_agg(d) = :'index_array_agg' FROM (
+    SELECT hex <-> :knn AS d FROM h3_test_spgist_knn
+    ORDER BY hex <-> :knn LIMIT 100
+) q;
+
+RESET enable_indexscan;
+RESET enable_bitmapscan;
+
+--
+-- TEST mixed resolutions around a pentagon
+--
+CREATE TABLE h3_test_spgist_mixed (hex h3index);
+CREATE INDEX SPGIST_MIXED_IDX ON h3_test_spgist_mixed USING spgist(hex);
+INSERT INTO h3_test_spgist_mixed (hex)
+    SELECT h3_cell_to_children(h3_cell_to_parent(:pentagon, 1), resolution)
+    FROM generate_series(1, 5) resolution;
+INSERT INTO h3_test_spgist_mixed (hex) SELECT h3_cell_to_children(:hexagon, 5);
+
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+SELECT COUNT(*) = 1 FROM h3_test_spgist_mixed WHERE hex = :pentagon;
+SELECT COUNT(*) = 3 FROM h3_test_spgist_mixed WHERE hex @> :pentagon;
+SELECT COUNT(*) = 47 FROM h3_test_spgist_mixed WHERE hex <@ :pentagon;
+SELECT COUNT(*) = 50 FROM h3_test_spgist_mixed WHERE hex && :pentagon;
+SELECT COUNT(*) = 7 FROM h3_test_spgist_mixed WHERE hex <@ (
+    SELECT cell FROM h3_cell_to_children(:pentagon, 4) cell
+    WHERE NOT h3_is_pentagon(cell) LIMIT 1
+);
+SELECT COUNT(*) = 105 FROM h3_test_spgist_mixed WHERE hex <@ :hexagon;
+SELECT COUNT(*) = 0 FROM h3_test_spgist_mixed WHERE hex && '8a2a1072b59ffff';
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+
+-- distances are ordered across base cells, resolutions and pentagons
+SET enable_seqscan = off;
+SET enable_bitmapscan = off;
+SELECT array_agg(d) FROM (
+    SELECT hex <-> :hexagon AS d FROM h3_test_spgist_mixed ORDER BY hex <-> :hexagon
+) q \gset hexagon_
+SELECT array_agg(d) FROM (
+    SELECT hex <-> :knn AS d FROM h3_test_spgist_mixed ORDER BY hex <-> :knn
+) q \gset knn_
+RESET enable_seqscan;
+RESET enable_bitmapscan;
+SET enable_indexscan = off;
+SET enable_bitmapscan = off;
+SELECT array_agg(d) = :'hexagon_array_agg' FROM (
+    SELECT hex <-> :hexagon AS d FROM h3_test_spgist_mixed ORDER BY hex <-> :hexagon
+) q;
+SELECT array_agg(d) = :'knn_array_agg' FROM (
+    SELECT hex <-> :knn AS d FROM h3_test_spgist_mixed ORDER BY hex <-> :knn
+) q;
+RESET enable_indexscan;
+RESET enable_bitmapscan;
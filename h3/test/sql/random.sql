@@ -0,0 +1,72 @@
+\pset tuples_only on
+
+CREATE FUNCTION h3_test_random_fails(query text) RETURNS boolean AS $$
+BEGIN
+    EXECUTE query;
+    RETURN false;
+EXCEPTION WHEN invalid_parameter_value THEN
+    RETURN true;
+END;
+$$ LANGUAGE plpgsql;
+
+--
+-- TEST h3_random_cells
+--
+
+-- the same seed gives the same cells, another seed other cells
+SELECT array_agg(c) = (SELECT array_agg(c) FROM h3_random_cells(9, 1000, 'uniform', 1) c)
+FROM h3_random_cells(9, 1000, 'uniform', 1) c;
+SELECT array_agg(c) <> (SELECT array_agg(c) FROM h3_random_cells(9, 1000, 'uniform', 2) c)
+FROM h3_random_cells(9, 1000, 'uniform', 1) c;
+
+-- n valid cells at the resolution, of every distribution
+SELECT bool_and(count = 1000 AND valid) FROM (
+    SELECT d, count(*), bool_and(h3_is_valid_cell(c) AND h3_get_resolution(c) = 7) valid
+    FROM unnest(ARRAY['uniform', 'clusters', 'roads', 'pentagons', 'antimeridian']) d,
+        h3_random_cells(7, 1000, d, 42) c
+    GROUP BY d
+) q;
+SELECT count(*) = 0 FROM h3_random_cells(7, 0);
+
+-- uniform cells cover both hemispheres evenly
+SELECT count(*) FILTER (WHERE h3_cell_to_lat_lng(c)[1] > 0) BETWEEN 4500 AND 5500
+FROM h3_random_cells(5, 10000) c;
+
+-- clusters gather in few parents
+SELECT count(DISTINCT h3_cell_to_parent(c, 2)) < 100 FROM h3_random_cells(9, 10000, 'clusters') c;
+
+-- roads are a cell apart, mostly neighbours
+SELECT count(*) FILTER (WHERE h3_grid_distance(a, b) <= 2) > 900 FROM (
+    SELECT c a, lead(c) OVER (ORDER BY i) b
+    FROM h3_random_cells(9, 1000, 'roads') WITH ORDINALITY r(c, i)
+) q WHERE b IS NOT NULL;
+
+-- pentagons and the antimeridian, a few cells away
+SELECT bool_and(EXISTS (
+    SELECT FROM h3_get_pentagons(9) p
+    WHERE h3_great_circle_distance(h3_cell_to_lat_lng(p), h3_cell_to_lat_lng(c)) < 5
+)) FROM h3_random_cells(9, 100, 'pentagons') c;
+SELECT bool_and(abs(h3_cell_to_lat_lng(c)[0]) > 179) FROM h3_random_cells(9, 1000, 'antimeridian') c;
+
+-- invalid arguments
+SELECT h3_test_random_fails($$ SELECT h3_random_cells(9, 10, 'gaussian') $$);
+SELECT h3_test_random_fails($$ SELECT h3_random_cells(9, -1) $$);
+
+--
+-- TEST h3_random_polygons
+--
+
+-- the same seed gives the same polygons
+SELECT array_agg(p::text) = (SELECT array_agg(p::text) FROM h3_random_polygons(10, 100, 'clusters', 1) p)
+FROM h3_random_polygons(10, 100, 'clusters', 1) p;
+
+-- n polygons of the vertices asked for
+SELECT count(*) = 100 AND bool_and(npoints(p) = 12) FROM h3_random_polygons(10, 100, 'uniform', 0, 12) p;
+
+-- fill with cells
+SELECT bool_and(EXISTS (SELECT FROM h3_polygon_to_cells(p, null, 7)))
+FROM h3_random_polygons(10, 10, 'pentagons') p;
+
+-- polygons can not follow roads
+SELECT h3_test_random_fails($$ SELECT h3_random_polygons(10, 10, 'roads') $$);
+SELECT h3_test_random_fails($$ SELECT h3_random_polygons(10, 10, 'uniform', 0, 2) $$);
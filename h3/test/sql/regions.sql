@@ -74,3 +74,34 @@ SELECT array_agg(result) is null FROM (
     ) qq
     EXCEPT SELECT h3_grid_disk(h3_cell_to_center_child(:res0index), 2) result
 ) q;
+
+--
+-- TEST h3_polygon_to_cells in bands of latitude
+--
+
+\set polygon 'polygon \'((-1,-1),(-1,1),(0,0.5),(1,1),(1,-1))\''
+\set holes 'ARRAY[polygon \'((-0.5,-0.5),(-0.5,0),(0.5,0),(0.5,-0.5))\']'
+CREATE TABLE h3_test_polyfill AS SELECT
+    ARRAY(SELECT h3_polygon_to_cells(:polygon, :holes, 6)) center,
+    ARRAY(SELECT h3_polygon_to_cells_experimental(:polygon, :holes, 6, 'overlapping')) overlapping;
+SET h3.polygon_to_cells_chunk_size = 500;
+
+-- same cells as filling at once, each only once
+SELECT array_agg(result) is null FROM (
+    (SELECT h3_polygon_to_cells(:polygon, :holes, 6) result
+        EXCEPT ALL SELECT unnest(center) FROM h3_test_polyfill)
+    UNION ALL
+    (SELECT unnest(center) FROM h3_test_polyfill
+        EXCEPT ALL SELECT h3_polygon_to_cells(:polygon, :holes, 6))
+) q;
+
+SELECT array_agg(result) is null FROM (
+    (SELECT h3_polygon_to_cells_experimental(:polygon, :holes, 6, 'overlapping') result
+        EXCEPT ALL SELECT unnest(overlapping) FROM h3_test_polyfill)
+    UNION ALL
+    (SELECT unnest(overlapping) FROM h3_test_polyfill
+        EXCEPT ALL SELECT h3_polygon_to_cells_experimental(:polygon, :holes, 6, 'overlapping'))
+) q;
+
+RESET h3.polygon_to_cells_chunk_size;
+DROP TABLE h3_test_polyfill;
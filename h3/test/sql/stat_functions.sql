@@ -0,0 +1,47 @@
+\pset tuples_only on
+\set hexagon '\'831c02fffffffff\'::h3index'
+
+SELECT count(*) = 1 FROM (SELECT h3_stat_functions_reset()) q;
+
+--
+-- TEST h3_stat_functions
+--
+
+-- a row for each group of functions
+SELECT array_agg(function ORDER BY function) = '{children,disk,dissolve,polyfill,wkb}'
+FROM h3_stat_functions;
+
+-- nothing is tracked unless asked
+SELECT count(*) = 49 FROM h3_cell_to_children(:hexagon, 5);
+SELECT calls = 0 FROM h3_stat_functions WHERE function = 'children';
+
+SET h3.track_functions = on;
+
+-- sets count one call each, and every row returned
+SELECT count(*) = 49 FROM h3_cell_to_children(:hexagon, 5);
+SELECT calls = 1 AND rows = 49 AND max_time <= total_time
+    AND (peak_memory > 0 OR current_setting('server_version_num')::int < 130000)
+FROM h3_stat_functions WHERE function = 'children';
+
+SELECT count(*) > 0 FROM h3_grid_disk(:hexagon) c, h3_cell_to_children(c, 4);
+SELECT calls = 1 AND rows = 7 FROM h3_stat_functions WHERE function = 'disk';
+SELECT calls = 8 FROM h3_stat_functions WHERE function = 'children';
+
+SELECT count(*) > 0 FROM h3_polygon_to_cells(polygon '((0,0),(0,1),(1,1),(1,0))', null, 5);
+SELECT calls = 1 AND rows > 0 FROM h3_stat_functions WHERE function = 'polyfill';
+
+SELECT count(*) = 1 FROM h3_cells_to_multi_polygon(ARRAY[:hexagon]);
+SELECT calls = 1 AND rows = 1 FROM h3_stat_functions WHERE function = 'dissolve';
+
+-- sets returned in part count their rows
+SELECT rows AS children_rows FROM h3_stat_functions WHERE function = 'children' \gset
+SELECT count(*) = 10 FROM (SELECT h3_cell_to_children(:hexagon, 5) LIMIT 10) q;
+SELECT calls = 9 AND rows = :children_rows + 10 FROM h3_stat_functions WHERE function = 'children';
+
+RESET h3.track_functions;
+
+--
+-- TEST h3_stat_functions_reset
+--
+SELECT count(*) = 1 FROM (SELECT h3_stat_functions_reset()) q;
+SELECT bool_and(calls = 0 AND rows = 0 AND total_time = 0) FROM h3_stat_functions;
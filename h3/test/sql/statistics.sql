@@ -0,0 +1,73 @@
+\pset tuples_only on
+\set cell '\'8a2a1072b59ffff\'::h3index'
+\set parent 'h3_cell_to_parent(:cell, 7)'
+
+CREATE TABLE h3_test_statistics (hex h3index);
+INSERT INTO h3_test_statistics (hex)
+    SELECT h3_cell_to_children(:parent, 10)
+    UNION ALL SELECT h3_cell_to_parent(:cell, res) FROM generate_series(0, 9) res;
+ANALYZE h3_test_statistics;
+
+CREATE FUNCTION h3_test_estimate(query text) RETURNS float AS $$
+DECLARE
+    plan json;
+BEGIN
+    EXECUTE 'EXPLAIN (FORMAT JSON) ' || query INTO plan;
+    RETURN (plan->0->'Plan'->>'Plan Rows')::float;
+END;
+$$ LANGUAGE plpgsql;
+
+--
+-- TEST typanalyze
+--
+SELECT 13101 IN (stakind1, stakind2, stakind3, stakind4, stakind5)
+    AND 13102 IN (stakind1, stakind2, stakind3, stakind4, stakind5)
+FROM pg_statistic WHERE starelid = 'h3_test_statistics'::regclass;
+
+--
+-- TEST restriction selectivity
+--
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_test_statistics WHERE hex <@ $$ || quote_literal(:parent)
+) BETWEEN 300 AND 360;
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_test_statistics WHERE hex @> $$ || quote_literal(:cell)
+) BETWEEN 1 AND 30;
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_test_statistics WHERE h3_are_neighbor_cells(hex, $$ || quote_literal(:cell) || $$)
+) < 10;
+-- descendants of a cell follow it in hierarchy order, unlike in the histogram
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_test_statistics WHERE hex ~<~ $$ || quote_literal(h3_child_pos_to_cell(6, :parent, 8))
+) BETWEEN 250 AND 353;
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_test_statistics WHERE hex ~>=~ $$ || quote_literal(h3_child_pos_to_cell(6, :parent, 8))
+) < 100;
+
+--
+-- TEST join selectivity
+--
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_test_statistics a, h3_test_statistics b WHERE a.hex @> b.hex
+$$) BETWEEN 200 AND 5000;
+
+--
+-- TEST set returning function rows
+--
+SELECT h3_test_estimate('SELECT * FROM h3_grid_disk(' || quote_literal(:cell) || ', 3)') = 37;
+SELECT h3_test_estimate('SELECT * FROM h3_grid_disk(' || quote_literal(:cell) || ')') = 7;
+SELECT h3_test_estimate('SELECT * FROM h3_grid_ring_unsafe(' || quote_literal(:cell) || ', 3)') = 18;
+SELECT h3_test_estimate('SELECT * FROM h3_cell_to_children(' || quote_literal(:parent) || ', 10)') = 343;
+SELECT h3_test_estimate('SELECT * FROM h3_uncompact_cells(ARRAY[' || quote_literal(:parent) || '::h3index, ' || quote_literal(:cell) || '], 11)') = 2408;
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_polygon_to_cells(polygon '((0,0),(0,1),(1,1),(1,0))', null, 7)
+$$) BETWEEN 2000 AND 3000;
+SELECT h3_test_estimate('SELECT * FROM h3_random_cells(9, 12345)') = 12345;
+SELECT h3_test_estimate('SELECT * FROM h3_random_polygons(10, 123)') = 123;
+
+-- children of a column, from its resolution statistics
+CREATE TABLE h3_test_children AS SELECT h3_cell_to_children(:parent, 10) hex;
+ANALYZE h3_test_children;
+SELECT h3_test_estimate($$
+    SELECT * FROM h3_test_children, h3_cell_to_children(hex, 12)
+$$) BETWEEN 16000 AND 17500;
@@ -42,6 +42,13 @@ FROM (
     SELECT index, distance FROM h3_grid_disk_distances(:pentagon, 2)
 ) q;
 
+-- rings are streamed one at a time, also around pentagons
+SELECT COUNT(index) filter (WHERE distance = 4) = 20
+AND COUNT(DISTINCT index) = 51
+FROM h3_grid_disk_distances(:pentagon, 4);
+
+SELECT COUNT(*) = 10 FROM (SELECT h3_grid_disk(:hexagon, 1000) LIMIT 10) q;
+
 --
 -- TEST h3_grid_path_cells
 --
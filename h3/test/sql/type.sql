@@ -39,3 +39,30 @@ SELECT array_agg(hex) is null FROM (
     SELECT hex FROM h3_test_binary_send
     EXCEPT SELECT hex FROM h3_test_binary_recv
 ) q;
+
+--
+-- TEST text io
+--
+
+-- output is lowercase without leading zeros, input takes either case
+SELECT :hexagon::text = :string;
+SELECT upper(:string)::h3index = :hexagon;
+SELECT '000000000000000f'::h3index::text = 'f';
+
+-- and keeps accepting the lenient syntax of stringToH3
+SELECT ' 801dfffffffffff'::h3index = :hexagon;
+
+-- arrays share the same functions
+SELECT ARRAY[:hexagon, :pentagon]::text::h3index[] = ARRAY[:hexagon, :pentagon];
+
+CREATE TEMPORARY TABLE h3_test_text_out (hex h3index PRIMARY KEY);
+CREATE TEMPORARY TABLE h3_test_text_in (hex h3index PRIMARY KEY);
+INSERT INTO h3_test_text_out (hex) SELECT h3_cell_to_children(h3_get_res_0_cells(), 2);
+\copy h3_test_text_out TO 'h3_test_text.txt'
+\copy h3_test_text_in FROM 'h3_test_text.txt'
+
+-- make sure re-imported data matches original data
+SELECT array_agg(hex) is null FROM (
+    SELECT hex FROM h3_test_text_out
+    EXCEPT SELECT hex FROM h3_test_text_in
+) q;
@@ -0,0 +1,22 @@
+\pset tuples_only on
+--
+-- Converting cells to geometries
+--
+CALL h3_bench_run('boundary/cell_to_geometry',
+    'SELECT count(h3_cell_to_geometry(cell)) FROM h3_bench_points');
+CALL h3_bench_run('boundary/cell_to_boundary_geometry',
+    'SELECT count(h3_cell_to_boundary_geometry(cell)) FROM h3_bench_points');
+CALL h3_bench_run('boundary/cell_to_boundary_geography',
+    'SELECT count(h3_cell_to_boundary_geography(cell)) FROM h3_bench_points');
+
+SELECT count(DISTINCT rows) = 1 FROM h3_bench_results WHERE scenario LIKE 'boundary/%';
+
+--
+-- Boundaries of a whole batch of cells, one by one and in one call
+--
+CALL h3_bench_run('boundaries/cell_to_boundary_geometry',
+    'SELECT count(*) FROM (SELECT ST_Dump(h3_cell_to_boundary_geometry(cell)) FROM h3_bench_points) q');
+CALL h3_bench_run('boundaries/cells_to_boundaries_geometry',
+    'SELECT ST_NumGeometries(h3_cells_to_boundaries_geometry(array(SELECT cell FROM h3_bench_points)))');
+
+SELECT count(DISTINCT rows) = 1 FROM h3_bench_results WHERE scenario LIKE 'boundaries/%';
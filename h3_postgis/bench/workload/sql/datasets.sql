@@ -0,0 +1,45 @@
+\ir ../../../../h3/bench/workload/sql/datasets.sql
+SELECT ceil(5 * sqrt(scale)) AS coverage_size FROM h3_bench_settings \gset
+\set raster_size 100
+\set pixel_size 0.001
+
+--
+-- Polygons as geometries
+--
+CREATE TABLE h3_bench_geometries AS
+    SELECT id, ST_SetSRID(polygon::geometry, 4326) AS geom FROM h3_bench_polygons;
+
+--
+-- Raster coverage of tiles with pixels of about 100 m, and a few distinct
+-- values
+--
+CREATE TABLE h3_bench_rasters AS
+    WITH
+        vals AS (
+            SELECT array_agg(line ORDER BY y) AS vals
+            FROM (
+                SELECT y, array_agg((x * y) % 7 + 1 ORDER BY x) AS line
+                FROM
+                    generate_series(1, :raster_size) AS x,
+                    generate_series(1, :raster_size) AS y
+                GROUP BY y
+            ) t),
+        rasts AS (
+            SELECT
+                ST_AddBand(
+                    ST_MakeEmptyCoverage(
+                        :raster_size, :raster_size,
+                        :raster_size * :coverage_size, :raster_size * :coverage_size,
+                        -0.25, 51.75,
+                        :pixel_size, -(:pixel_size),
+                        0, 0,
+                        4326),
+                    ARRAY[ROW(1, '8BUI', 1, 0)]::addbandarg[]
+                ) AS rast)
+    SELECT ST_SetValues(r.rast, 1, 1, 1, v.vals) AS rast
+    FROM rasts r, vals v;
+
+VACUUM ANALYZE h3_bench_geometries;
+VACUUM ANALYZE h3_bench_rasters;
+
+SELECT count(*) = :coverage_size * :coverage_size FROM h3_bench_rasters;
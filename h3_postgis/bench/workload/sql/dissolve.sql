@@ -0,0 +1,18 @@
+\pset tuples_only on
+--
+-- Dissolving cells into multi polygons
+--
+CALL h3_bench_run('dissolve/points by resolution 3 parent',
+    'SELECT count(*) FROM (
+        SELECT h3_cells_to_multi_polygon_geometry(cell)
+        FROM h3_bench_points
+        GROUP BY h3_cell_to_parent(cell, 3)
+    ) q');
+CALL h3_bench_run('dissolve/polyfilled polygons',
+    'SELECT count(*) FROM (
+        SELECT h3_cells_to_multi_polygon_geometry(cell)
+        FROM h3_bench_geometries, h3_polygon_to_cells(geom, 9) cell
+        GROUP BY id
+    ) q');
+
+SELECT count(*) = 2 FROM (SELECT DISTINCT scenario FROM h3_bench_results WHERE scenario LIKE 'dissolve/%') q;
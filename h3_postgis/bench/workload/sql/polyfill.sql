@@ -0,0 +1,12 @@
+\pset tuples_only on
+--
+-- Filling polygons with cells
+--
+CALL h3_bench_run('polyfill/polygon_to_cells geometry',
+    'SELECT count(*) FROM h3_bench_geometries, h3_polygon_to_cells(geom, 9)');
+CALL h3_bench_run('polyfill/polygon_to_cells geography',
+    'SELECT count(*) FROM h3_bench_geometries, h3_polygon_to_cells(geom::geography, 9)');
+CALL h3_bench_run('polyfill/polygon_to_cells_experimental geometry overlapping',
+    'SELECT count(*) FROM h3_bench_geometries, h3_polygon_to_cells_experimental(geom, 9, ''overlapping'')');
+
+SELECT count(*) = 3 FROM (SELECT DISTINCT scenario FROM h3_bench_results WHERE scenario LIKE 'polyfill/%') q;
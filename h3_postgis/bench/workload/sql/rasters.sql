@@ -0,0 +1,15 @@
+\pset tuples_only on
+--
+-- Summarizing rasters by cell, with cells larger than, close to and smaller
+-- than the pixels
+--
+CALL h3_bench_run('raster/summary resolution 6',
+    'SELECT count(*) FROM h3_bench_rasters, h3_raster_summary(rast, 6)');
+CALL h3_bench_run('raster/summary resolution 8',
+    'SELECT count(*) FROM h3_bench_rasters, h3_raster_summary(rast, 8)');
+CALL h3_bench_run('raster/summary resolution 11',
+    'SELECT count(*) FROM h3_bench_rasters, h3_raster_summary(rast, 11)');
+CALL h3_bench_run('raster/class_summary resolution 8',
+    'SELECT count(*) FROM h3_bench_rasters, h3_raster_class_summary(rast, 8)');
+
+SELECT count(*) = 4 FROM (SELECT DISTINCT scenario FROM h3_bench_results WHERE scenario LIKE 'raster/%') q;
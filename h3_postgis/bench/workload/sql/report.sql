@@ -0,0 +1,2 @@
+\set suite h3_postgis
+\ir ../../../../h3/bench/workload/sql/report.sql
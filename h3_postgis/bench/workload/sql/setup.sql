@@ -0,0 +1 @@
+\ir ../../../../h3/bench/workload/sql/setup.sql
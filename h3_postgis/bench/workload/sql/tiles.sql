@@ -0,0 +1,36 @@
+\pset tuples_only on
+--
+-- Vector tiles of the points around each city, at zoom 12
+--
+CREATE TABLE h3_bench_tile_cells AS
+    SELECT t.id AS tile, t.z, t.x, t.y, p.cell
+    FROM (
+        SELECT
+            id,
+            12 AS z,
+            floor((lng + 180) / 360 * 4096)::integer AS x,
+            floor((1 - ln(tan(radians(lat)) + 1 / cos(radians(lat))) / pi()) / 2 * 4096)::integer AS y
+        FROM h3_bench_cities
+    ) t
+    JOIN h3_bench_points p
+        ON p.id % (SELECT count(*) FROM h3_bench_cities) + 1 = t.id AND p.id % 5 <> 0;
+
+CALL h3_bench_run('tiles/ST_AsMVT of cell boundaries',
+    'SELECT count(*) FROM (
+        SELECT ST_AsMVT(q, ''h3'')
+        FROM (
+            SELECT tile, ST_AsMVTGeom(
+                ST_Transform(h3_cell_to_boundary_geometry(cell), 3857),
+                ST_TileEnvelope(z, x, y)) AS geom
+            FROM h3_bench_tile_cells
+        ) q
+        GROUP BY tile
+    ) r');
+CALL h3_bench_run('tiles/h3_cells_to_mvt',
+    'SELECT count(*) FROM (
+        SELECT h3_cells_to_mvt(cell, z, x, y)
+        FROM h3_bench_tile_cells
+        GROUP BY tile, z, x, y
+    ) q');
+
+SELECT count(DISTINCT rows) = 1 FROM h3_bench_results WHERE scenario LIKE 'tiles/%';
@@ -40,6 +40,18 @@ COMMENT ON FUNCTION
     h3_latlng_to_cell(geometry, resolution integer)
 IS 'Indexes the location at the specified resolution.';
 
+--@ internal
+CREATE OR REPLACE FUNCTION h3_point_wkb_to_cells(bytea, resolution integer) RETURNS h3index[]
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ availability: unreleased
+--@ refid: h3_latlng_to_cells_geometry
+CREATE OR REPLACE FUNCTION h3_latlng_to_cells(geometry, resolution integer) RETURNS h3index[]
+    AS $$ SELECT h3_point_wkb_to_cells(ST_AsBinary($1), $2); $$ IMMUTABLE STRICT PARALLEL SAFE LANGUAGE SQL;
+COMMENT ON FUNCTION
+    h3_latlng_to_cells(geometry, resolution integer)
+IS 'Indexes each point of a point or multipoint geometry at the specified resolution, in a single call.';
+
 --@ availability: 4.0.0
 --@ refid: h3_cell_to_geometry
 CREATE OR REPLACE FUNCTION h3_cell_to_geometry(h3index) RETURNS geometry
@@ -59,7 +71,7 @@ IS 'Finds the centroid of the index.';
 --@ availability: 4.0.0
 --@ refid: h3_cell_to_boundary_geometry
 CREATE OR REPLACE FUNCTION h3_cell_to_boundary_geometry(h3index) RETURNS geometry
-  AS $$ SELECT h3_cell_to_boundary_wkb($1)::geometry $$ IMMUTABLE STRICT PARALLEL SAFE LANGUAGE SQL;
+  AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 COMMENT ON FUNCTION
     h3_cell_to_boundary_geometry(h3index)
 IS 'Finds the boundary of the index.
@@ -69,13 +81,23 @@ Splits polygons when crossing 180th meridian.';
 --@ availability: 4.0.0
 --@ refid: h3_cell_to_boundary_geography
 CREATE OR REPLACE FUNCTION h3_cell_to_boundary_geography(h3index) RETURNS geography
-  AS $$ SELECT h3_cell_to_boundary_wkb($1)::geography $$ IMMUTABLE STRICT PARALLEL SAFE LANGUAGE SQL;
+  AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
 COMMENT ON FUNCTION
     h3_cell_to_boundary_geography(h3index)
 IS 'Finds the boundary of the index.
 
 Splits polygons when crossing 180th meridian.';
 
+--@ availability: unreleased
+--@ refid: h3_cells_to_boundaries_geometry
+CREATE OR REPLACE FUNCTION h3_cells_to_boundaries_geometry(h3index[]) RETURNS geometry
+  AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_cells_to_boundaries_geometry(h3index[])
+IS 'Finds the boundaries of the indexes as one geometry collection, a polygon per cell in array order, ignoring nulls. Neighbouring polygons share edges, so they are not collected as a multi polygon.
+
+Splits polygons when crossing 180th meridian, giving two polygons for such cells.';
+
 --@ availability: 4.2.3
 --@ refid: h3_get_resolution_from_tile_zoom
 CREATE OR REPLACE FUNCTION h3_get_resolution_from_tile_zoom(
@@ -107,3 +129,58 @@ $$ LANGUAGE plpgsql IMMUTABLE STRICT PARALLEL SAFE;
 COMMENT ON FUNCTION
     h3_get_resolution_from_tile_zoom(integer, integer, integer, integer, integer)
 IS 'Returns the optimal H3 resolution for a specified XYZ tile zoom level, based on hexagon size in pixels and resolution limits';
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_transfn(internal, h3index, z integer, x integer, y integer) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_transfn(internal, h3index, value double precision, z integer, x integer, y integer) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_transfn(internal, h3index, value double precision, z integer, x integer, y integer, extent integer, buffer integer, name text) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_finalfn(internal) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ availability: unreleased
+--@ refid: h3_cells_to_mvt
+CREATE AGGREGATE h3_cells_to_mvt(h3index, z integer, x integer, y integer) (
+    sfunc = h3_cells_to_mvt_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_mvt_finalfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_mvt(h3index, integer, integer, integer)
+IS 'Encodes the boundaries of the cells in tile z/x/y as a Mapbox Vector Tile, ignoring nulls.
+
+The tile has one layer `h3` of extent 4096, with the cell index as the id of each feature. Boundaries are projected to Web Mercator and clipped to the tile with a buffer of 256. Cells outside are left out, and no cells give an empty tile.';
+
+--@ availability: unreleased
+--@ refid: h3_cells_to_mvt_value
+CREATE AGGREGATE h3_cells_to_mvt(h3index, value double precision, z integer, x integer, y integer) (
+    sfunc = h3_cells_to_mvt_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_mvt_finalfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_mvt(h3index, double precision, integer, integer, integer)
+IS 'Encodes the cells in tile z/x/y as a Mapbox Vector Tile, with a `value` property unless the value is null.';
+
+--@ availability: unreleased
+--@ refid: h3_cells_to_mvt_layer
+CREATE AGGREGATE h3_cells_to_mvt(h3index, value double precision, z integer, x integer, y integer, extent integer, buffer integer, name text) (
+    sfunc = h3_cells_to_mvt_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_mvt_finalfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_mvt(h3index, double precision, integer, integer, integer, integer, integer, text)
+IS 'Encodes the cells in tile z/x/y as a Mapbox Vector Tile, in a layer of the given name, extent and buffer in pixels.';
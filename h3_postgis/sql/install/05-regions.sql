@@ -16,27 +16,18 @@
 
 --| # PostGIS Region Functions
 
+--@ internal
+CREATE OR REPLACE FUNCTION h3_polygon_wkb_to_cells(bytea, resolution integer) RETURNS SETOF h3index
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION h3_polygon_wkb_to_cells_experimental(bytea, resolution integer, containment_mode text) RETURNS SETOF h3index
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 --@ availability: 4.0.0
 --@ refid: h3_polygon_to_cells_geometry
 CREATE OR REPLACE FUNCTION h3_polygon_to_cells(multi geometry, resolution integer) RETURNS SETOF h3index
-    AS $$ SELECT h3_polygon_to_cells(exterior, holes, resolution) FROM (
-        SELECT 
-            -- extract exterior ring of each polygon
-            ST_MakePolygon(ST_ExteriorRing(poly))::polygon exterior,
-            -- extract holes of each polygon
-            (SELECT array_agg(hole)
-                FROM (
-                    SELECT ST_MakePolygon(ST_InteriorRingN(
-                        poly,
-                        generate_series(1, ST_NumInteriorRings(poly))
-                    ))::polygon AS hole
-                ) q_hole
-            ) holes
-        -- extract single polygons from multipolygon
-        FROM (
-            select (st_dump(multi)).geom as poly
-        ) q_poly GROUP BY poly
-    ) h3_polygon_to_cells; $$ LANGUAGE SQL IMMUTABLE PARALLEL SAFE CALLED ON NULL INPUT; -- NOT STRICT
+AS $$ SELECT h3_polygon_wkb_to_cells(ST_AsBinary($1), $2) $$ LANGUAGE SQL IMMUTABLE PARALLEL SAFE CALLED ON NULL INPUT; -- NOT STRICT
 
 --@ availability: 4.0.0
 --@ refid: h3_polygon_to_cells_geography
@@ -55,45 +46,74 @@ CREATE OR REPLACE FUNCTION
     h3_cells_to_multi_polygon_geography(h3index[]) RETURNS geography
 AS $$ SELECT h3_cells_to_multi_polygon_wkb($1)::geography $$ IMMUTABLE STRICT PARALLEL SAFE LANGUAGE SQL;
 
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_transfn(internal, h3index) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_combinefn(internal, internal) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_serialfn(internal) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_deserialfn(bytea, internal) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_geometry_agg_finalfn(internal) RETURNS geometry
+AS 'h3_postgis', 'h3_cells_to_multi_polygon_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+--@ internal
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_geography_agg_finalfn(internal) RETURNS geography
+AS 'h3_postgis', 'h3_cells_to_multi_polygon_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
 --@ availability: 4.1.0
 --@ refid: h3_cells_to_multi_polygon_geometry_agg
 CREATE AGGREGATE h3_cells_to_multi_polygon_geometry(h3index) (
-    sfunc = array_append,
-    stype = h3index[],
-    finalfunc = h3_cells_to_multi_polygon_geometry,
+    sfunc = h3_cells_to_multi_polygon_agg_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_multi_polygon_geometry_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_cells_to_multi_polygon_agg_combinefn,
+    serialfunc = h3_cells_to_multi_polygon_agg_serialfn,
+    deserialfunc = h3_cells_to_multi_polygon_agg_deserialfn,
     parallel = safe
 );
+COMMENT ON AGGREGATE h3_cells_to_multi_polygon_geometry(h3index)
+IS 'Outlines the distinct cells, ignoring nulls.
+
+Parallel workers deduplicate their share of the cells before the leader outlines them.';
 
 --@ availability: 4.1.0
 --@ refid: h3_cells_to_multi_polygon_geography_agg
 CREATE AGGREGATE h3_cells_to_multi_polygon_geography(h3index) (
-    sfunc = array_append,
-    stype = h3index[],
-    finalfunc = h3_cells_to_multi_polygon_geography,
+    sfunc = h3_cells_to_multi_polygon_agg_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_multi_polygon_geography_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_cells_to_multi_polygon_agg_combinefn,
+    serialfunc = h3_cells_to_multi_polygon_agg_serialfn,
+    deserialfunc = h3_cells_to_multi_polygon_agg_deserialfn,
     parallel = safe
 );
+COMMENT ON AGGREGATE h3_cells_to_multi_polygon_geography(h3index)
+IS 'Outlines the distinct cells, ignoring nulls.
+
+Parallel workers deduplicate their share of the cells before the leader outlines them.';
 
 --@ availability: 4.2.0
 --@ refid: h3_polygon_to_cells_geometry_experimental
 CREATE OR REPLACE FUNCTION h3_polygon_to_cells_experimental(multi geometry, resolution integer, containment_mode text DEFAULT 'center') RETURNS SETOF h3index
-    AS $$ SELECT h3_polygon_to_cells_experimental(exterior, holes, resolution, containment_mode) FROM (
-        SELECT 
-            -- extract exterior ring of each polygon
-            ST_MakePolygon(ST_ExteriorRing(poly))::polygon exterior,
-            -- extract holes of each polygon
-            (SELECT array_agg(hole)
-                FROM (
-                    SELECT ST_MakePolygon(ST_InteriorRingN(
-                        poly,
-                        generate_series(1, ST_NumInteriorRings(poly))
-                    ))::polygon AS hole
-                ) q_hole
-            ) holes
-        -- extract single polygons from multipolygon
-        FROM (
-            select (st_dump(multi)).geom as poly
-        ) q_poly GROUP BY poly
-    ) h3_polygon_to_cells; $$ LANGUAGE SQL IMMUTABLE PARALLEL SAFE CALLED ON NULL INPUT; -- NOT STRICT
+AS $$ SELECT h3_polygon_wkb_to_cells_experimental(ST_AsBinary($1), $2, $3) $$ LANGUAGE SQL IMMUTABLE PARALLEL SAFE CALLED ON NULL INPUT; -- NOT STRICT
 
 --@ availability: 4.2.0
 --@ refid: h3_polygon_to_cells_geography_experimental
@@ -16,3 +16,130 @@
 
 -- complain if script is sourced in psql, rather than via CREATE EXTENSION
 \echo Use "ALTER EXTENSION h3_postgis UPDATE TO 'unreleased'" to load this file. \quit
+
+CREATE OR REPLACE FUNCTION h3_point_wkb_to_cells(bytea, resolution integer) RETURNS h3index[]
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3_latlng_to_cells(geometry, resolution integer) RETURNS h3index[]
+    AS $$ SELECT h3_point_wkb_to_cells(ST_AsBinary($1), $2); $$ IMMUTABLE STRICT PARALLEL SAFE LANGUAGE SQL;
+COMMENT ON FUNCTION
+    h3_latlng_to_cells(geometry, resolution integer)
+IS 'Indexes each point of a point or multipoint geometry at the specified resolution, in a single call.';
+
+-- Native multi polygon aggregates
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_transfn(internal, h3index) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_combinefn(internal, internal) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_serialfn(internal) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_agg_deserialfn(bytea, internal) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_geometry_agg_finalfn(internal) RETURNS geometry
+AS 'h3_postgis', 'h3_cells_to_multi_polygon_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_multi_polygon_geography_agg_finalfn(internal) RETURNS geography
+AS 'h3_postgis', 'h3_cells_to_multi_polygon_agg_finalfn' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE AGGREGATE h3_cells_to_multi_polygon_geometry(h3index) (
+    sfunc = h3_cells_to_multi_polygon_agg_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_multi_polygon_geometry_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_cells_to_multi_polygon_agg_combinefn,
+    serialfunc = h3_cells_to_multi_polygon_agg_serialfn,
+    deserialfunc = h3_cells_to_multi_polygon_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_multi_polygon_geometry(h3index)
+IS 'Outlines the distinct cells, ignoring nulls.
+
+Parallel workers deduplicate their share of the cells before the leader outlines them.';
+CREATE OR REPLACE AGGREGATE h3_cells_to_multi_polygon_geography(h3index) (
+    sfunc = h3_cells_to_multi_polygon_agg_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_multi_polygon_geography_agg_finalfn,
+    finalfunc_modify = read_write,
+    combinefunc = h3_cells_to_multi_polygon_agg_combinefn,
+    serialfunc = h3_cells_to_multi_polygon_agg_serialfn,
+    deserialfunc = h3_cells_to_multi_polygon_agg_deserialfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_multi_polygon_geography(h3index)
+IS 'Outlines the distinct cells, ignoring nulls.
+
+Parallel workers deduplicate their share of the cells before the leader outlines them.';
+
+-- Native geometry polyfill
+CREATE OR REPLACE FUNCTION h3_polygon_wkb_to_cells(bytea, resolution integer) RETURNS SETOF h3index
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3_polygon_wkb_to_cells_experimental(bytea, resolution integer, containment_mode text) RETURNS SETOF h3index
+AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3_polygon_to_cells(multi geometry, resolution integer) RETURNS SETOF h3index
+AS $$ SELECT h3_polygon_wkb_to_cells(ST_AsBinary($1), $2) $$ LANGUAGE SQL IMMUTABLE PARALLEL SAFE CALLED ON NULL INPUT; -- NOT STRICT
+CREATE OR REPLACE FUNCTION h3_polygon_to_cells_experimental(multi geometry, resolution integer, containment_mode text DEFAULT 'center') RETURNS SETOF h3index
+AS $$ SELECT h3_polygon_wkb_to_cells_experimental(ST_AsBinary($1), $2, $3) $$ LANGUAGE SQL IMMUTABLE PARALLEL SAFE CALLED ON NULL INPUT; -- NOT STRICT
+
+-- Native boundary geometries
+CREATE OR REPLACE FUNCTION h3_cell_to_boundary_geometry(h3index) RETURNS geometry
+  AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+CREATE OR REPLACE FUNCTION h3_cell_to_boundary_geography(h3index) RETURNS geography
+  AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+-- Batched boundary geometries
+CREATE OR REPLACE FUNCTION h3_cells_to_boundaries_geometry(h3index[]) RETURNS geometry
+  AS 'h3_postgis' LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+COMMENT ON FUNCTION
+    h3_cells_to_boundaries_geometry(h3index[])
+IS 'Finds the boundaries of the indexes as one geometry collection, a polygon per cell in array order, ignoring nulls. Neighbouring polygons share edges, so they are not collected as a multi polygon.
+
+Splits polygons when crossing 180th meridian, giving two polygons for such cells.';
+
+-- Vector tiles
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_transfn(internal, h3index, z integer, x integer, y integer) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_transfn(internal, h3index, value double precision, z integer, x integer, y integer) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_transfn(internal, h3index, value double precision, z integer, x integer, y integer, extent integer, buffer integer, name text) RETURNS internal
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION
+    h3_cells_to_mvt_finalfn(internal) RETURNS bytea
+AS 'h3_postgis' LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE AGGREGATE h3_cells_to_mvt(h3index, z integer, x integer, y integer) (
+    sfunc = h3_cells_to_mvt_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_mvt_finalfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_mvt(h3index, integer, integer, integer)
+IS 'Encodes the boundaries of the cells in tile z/x/y as a Mapbox Vector Tile, ignoring nulls.
+
+The tile has one layer `h3` of extent 4096, with the cell index as the id of each feature. Boundaries are projected to Web Mercator and clipped to the tile with a buffer of 256. Cells outside are left out, and no cells give an empty tile.';
+
+CREATE AGGREGATE h3_cells_to_mvt(h3index, value double precision, z integer, x integer, y integer) (
+    sfunc = h3_cells_to_mvt_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_mvt_finalfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_mvt(h3index, double precision, integer, integer, integer)
+IS 'Encodes the cells in tile z/x/y as a Mapbox Vector Tile, with a `value` property unless the value is null.';
+
+CREATE AGGREGATE h3_cells_to_mvt(h3index, value double precision, z integer, x integer, y integer, extent integer, buffer integer, name text) (
+    sfunc = h3_cells_to_mvt_transfn,
+    stype = internal,
+    finalfunc = h3_cells_to_mvt_finalfn,
+    parallel = safe
+);
+COMMENT ON AGGREGATE h3_cells_to_mvt(h3index, double precision, integer, integer, integer, integer, integer, text)
+IS 'Encodes the cells in tile z/x/y as a Mapbox Vector Tile, in a layer of the given name, extent and buffer in pixels.';
@@ -0,0 +1,395 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <math.h>
+#include <string.h>
+
+#include "error.h"
+#include "gserialized.h"
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
+#define GSERIALIZED_INT_SIZE 4
+#define GSERIALIZED_FLOAT_SIZE 4
+#define GSERIALIZED_DOUBLE_SIZE 8
+
+/* varlena header, srid and flags */
+#define GSERIALIZED_HEADER_SIZE (VARHDRSZ + 4)
+
+#define GSERIALIZED_FLAG_BBOX 0x04
+#define GSERIALIZED_FLAG_GEODETIC 0x08
+
+#define GSERIALIZED_POLYGON_TYPE 3
+#define GSERIALIZED_MULTIPOLYGON_TYPE 6
+#define GSERIALIZED_COLLECTION_TYPE 7
+
+#define GSERIALIZED_SRID_DEFAULT 4326
+
+static bool
+			boundary_is_closed(const CellBoundary * boundary);
+
+static size_t
+			gserialized_boundary_size(const CellBoundary * boundary);
+
+static uint8 *
+			gserialized_write_boundary(uint8 *data, const CellBoundary * boundary);
+
+static uint8 *
+			gserialized_write_header(struct varlena *gserialized, size_t size, uint8 flags);
+
+static size_t
+			gserialized_flat_polygon_size(const FlatGeoPolygon * geo, int polygon);
+
+static uint8 *
+			gserialized_write_flat_polygon(uint8 *data, const FlatGeoPolygon * geo, int polygon);
+
+static uint8 *
+			gserialized_write_flat_box(uint8 *data, const FlatGeoPolygon * geo);
+
+static uint8 *
+			gserialized_write_box(uint8 *data, const CellBoundary * boundaries, int num,
+								  const Bbox3 * geodetic);
+
+static float
+			float_down(double value);
+
+static float
+			float_up(double value);
+
+static uint8 *
+			gserialized_write(uint8 *data, const void *value, size_t size);
+
+struct varlena *
+boundary_array_to_gserialized(const CellBoundary * boundaries, int num,
+							  const Bbox3 * geodetic)
+{
+	struct varlena *gserialized;
+	uint8	   *data;
+	uint8		flags = 0;
+	bool		empty = true;
+	size_t		size = GSERIALIZED_HEADER_SIZE;
+
+	for (int i = 0; i < num; i++)
+	{
+		empty &= (boundaries[i].numVerts < 1);
+		size += gserialized_boundary_size(&boundaries[i]);
+	}
+
+	if (num != 1)
+	{
+		/* type + # of polygons */
+		size += GSERIALIZED_INT_SIZE * 2;
+	}
+
+	if (geodetic)
+		flags |= GSERIALIZED_FLAG_GEODETIC;
+
+	/* empty geometries have no box */
+	if (!empty)
+	{
+		flags |= GSERIALIZED_FLAG_BBOX;
+		size += GSERIALIZED_FLOAT_SIZE * (geodetic ? 6 : 4);
+	}
+
+	gserialized = palloc0(size);
+	data = gserialized_write_header(gserialized, size, flags);
+
+	if (!empty)
+		data = gserialized_write_box(data, boundaries, num, geodetic);
+
+	if (num == 1)
+		data = gserialized_write_boundary(data, &boundaries[0]);
+	else
+	{
+		uint32		type = GSERIALIZED_MULTIPOLYGON_TYPE;
+		uint32		numPolygons = num;
+
+		data = gserialized_write(data, &type, GSERIALIZED_INT_SIZE);
+		data = gserialized_write(data, &numPolygons, GSERIALIZED_INT_SIZE);
+		for (int i = 0; i < num; i++)
+			data = gserialized_write_boundary(data, &boundaries[i]);
+	}
+
+	ASSERT(
+		   (uint8 *) gserialized + size == data,
+		   ERRCODE_EXTERNAL_ROUTINE_EXCEPTION,
+		   "# of written bytes (%d) must match allocation size (%d)",
+		   (int) (data - (uint8 *) gserialized), (int) size);
+	return gserialized;
+}
+
+struct varlena *
+flat_geo_to_gserialized(const FlatGeoPolygon * geo)
+{
+	struct varlena *gserialized;
+	uint8	   *data;
+	uint8		flags = 0;
+	bool		empty = (geo->numPoints == 0);
+	uint32		type = GSERIALIZED_COLLECTION_TYPE;
+	uint32		numPolygons = geo->numPolygons;
+	/* header, type + # of polygons */
+	size_t		size = GSERIALIZED_HEADER_SIZE + GSERIALIZED_INT_SIZE * 2;
+
+	for (int i = 0; i < geo->numPolygons; i++)
+		size += gserialized_flat_polygon_size(geo, i);
+
+	if (!empty)
+	{
+		flags |= GSERIALIZED_FLAG_BBOX;
+		size += GSERIALIZED_FLOAT_SIZE * 4;
+	}
+
+	gserialized = palloc0(size);
+	data = gserialized_write_header(gserialized, size, flags);
+
+	if (!empty)
+		data = gserialized_write_flat_box(data, geo);
+
+	data = gserialized_write(data, &type, GSERIALIZED_INT_SIZE);
+	data = gserialized_write(data, &numPolygons, GSERIALIZED_INT_SIZE);
+	for (int i = 0; i < geo->numPolygons; i++)
+		data = gserialized_write_flat_polygon(data, geo, i);
+
+	ASSERT(
+		   (uint8 *) gserialized + size == data,
+		   ERRCODE_EXTERNAL_ROUTINE_EXCEPTION,
+		   "# of written bytes (%d) must match allocation size (%d)",
+		   (int) (data - (uint8 *) gserialized), (int) size);
+	return gserialized;
+}
+
+/* Sets the size, and writes SRID and flags */
+uint8 *
+gserialized_write_header(struct varlena *gserialized, size_t size, uint8 flags)
+{
+	uint8	   *data = (uint8 *) VARDATA(gserialized);
+
+	SET_VARSIZE(gserialized, size);
+
+	/* SRID, 21 bits in 3 bytes */
+	data[0] = (GSERIALIZED_SRID_DEFAULT & 0x001F0000) >> 16;
+	data[1] = (GSERIALIZED_SRID_DEFAULT & 0x0000FF00) >> 8;
+	data[2] = (GSERIALIZED_SRID_DEFAULT & 0x000000FF);
+	data[3] = flags;
+	return data + 4;
+}
+
+size_t
+gserialized_flat_polygon_size(const FlatGeoPolygon * geo, int polygon)
+{
+	int			firstRing = FLAT_POLYGON_FIRST_RING(geo, polygon);
+	int			numRings = FLAT_POLYGON_SIZE(geo, polygon);
+	int			numPoints = geo->ringOffsets[firstRing + numRings]
+		- geo->ringOffsets[firstRing];
+
+	/* type + # of rings, # of points of each ring, padding to doubles */
+	size_t		size = GSERIALIZED_INT_SIZE * (2 + numRings + numRings % 2);
+
+	/* point data, rings closed */
+	return size + (numPoints + numRings) * GSERIALIZED_DOUBLE_SIZE * 2;
+}
+
+uint8 *
+gserialized_write_flat_polygon(uint8 *data, const FlatGeoPolygon * geo, int polygon)
+{
+	uint32		type = GSERIALIZED_POLYGON_TYPE;
+	int			firstRing = FLAT_POLYGON_FIRST_RING(geo, polygon);
+	uint32		numRings = FLAT_POLYGON_SIZE(geo, polygon);
+
+	data = gserialized_write(data, &type, GSERIALIZED_INT_SIZE);
+	data = gserialized_write(data, &numRings, GSERIALIZED_INT_SIZE);
+	for (int r = firstRing; r < firstRing + numRings; r++)
+	{
+		uint32		numPoints = FLAT_RING_SIZE(geo, r) + 1;
+
+		data = gserialized_write(data, &numPoints, GSERIALIZED_INT_SIZE);
+	}
+	/* odd # of rings, pad to doubles (already zeroed) */
+	if (numRings % 2)
+		data += GSERIALIZED_INT_SIZE;
+
+	for (int r = firstRing; r < firstRing + numRings; r++)
+	{
+		const FlatPoint *points = FLAT_RING_POINTS(geo, r);
+		int			num = FLAT_RING_SIZE(geo, r);
+
+		/* points are stored in the order of serialized coordinates */
+		data = gserialized_write(data, points, num * sizeof(FlatPoint));
+		data = gserialized_write(data, &points[0], sizeof(FlatPoint));
+	}
+	return data;
+}
+
+/* Planar box rounded outwards to floats */
+uint8 *
+gserialized_write_flat_box(uint8 *data, const FlatGeoPolygon * geo)
+{
+	double		xmin = INFINITY;
+	double		xmax = -INFINITY;
+	double		ymin = INFINITY;
+	double		ymax = -INFINITY;
+	float		box[4];
+
+	for (int i = 0; i < geo->numPoints; i++)
+	{
+		xmin = Min(xmin, geo->points[i].x);
+		xmax = Max(xmax, geo->points[i].x);
+		ymin = Min(ymin, geo->points[i].y);
+		ymax = Max(ymax, geo->points[i].y);
+	}
+
+	box[0] = float_down(xmin);
+	box[1] = float_up(xmax);
+	box[2] = float_down(ymin);
+	box[3] = float_up(ymax);
+	return gserialized_write(data, box, sizeof(box));
+}
+
+bool
+boundary_is_closed(const CellBoundary * boundary)
+{
+	const LatLng *verts = boundary->verts;
+	int			numVerts = boundary->numVerts;
+
+	return verts[0].lng == verts[numVerts - 1].lng
+		&& verts[0].lat == verts[numVerts - 1].lat;
+}
+
+size_t
+gserialized_boundary_size(const CellBoundary * boundary)
+{
+	/* type + # of rings */
+	size_t		size = GSERIALIZED_INT_SIZE * 2;
+
+	if (boundary->numVerts > 0)
+	{
+		int			numVerts = boundary->numVerts;
+
+		if (!boundary_is_closed(boundary))
+			numVerts++;
+		/* # of points, padding to doubles, point data */
+		size += GSERIALIZED_INT_SIZE * 2 + numVerts * GSERIALIZED_DOUBLE_SIZE * 2;
+	}
+	return size;
+}
+
+uint8 *
+gserialized_write_boundary(uint8 *data, const CellBoundary * boundary)
+{
+	uint32		type = GSERIALIZED_POLYGON_TYPE;
+	uint32		numRings = (boundary->numVerts > 0) ? 1 : 0;
+	uint32		numPoints;
+	bool		closed;
+
+	data = gserialized_write(data, &type, GSERIALIZED_INT_SIZE);
+	data = gserialized_write(data, &numRings, GSERIALIZED_INT_SIZE);
+	if (numRings == 0)
+		return data;
+
+	closed = boundary_is_closed(boundary);
+	numPoints = boundary->numVerts + (closed ? 0 : 1);
+	data = gserialized_write(data, &numPoints, GSERIALIZED_INT_SIZE);
+	/* odd # of rings, pad to doubles (already zeroed) */
+	data += GSERIALIZED_INT_SIZE;
+
+	for (int i = 0; i < numPoints; i++)
+	{
+		const LatLng *vert = &boundary->verts[i % boundary->numVerts];
+
+		data = gserialized_write(data, &vert->lng, GSERIALIZED_DOUBLE_SIZE);
+		data = gserialized_write(data, &vert->lat, GSERIALIZED_DOUBLE_SIZE);
+	}
+	return data;
+}
+
+/* Box rounded outwards to floats: x, y (and z) ranges */
+uint8 *
+gserialized_write_box(uint8 *data, const CellBoundary * boundaries, int num,
+					  const Bbox3 * geodetic)
+{
+	float		box[6];
+	int			size = 4;
+
+	if (geodetic)
+	{
+		box[0] = float_down(geodetic->xmin);
+		box[1] = float_up(geodetic->xmax);
+		box[2] = float_down(geodetic->ymin);
+		box[3] = float_up(geodetic->ymax);
+		box[4] = float_down(geodetic->zmin);
+		box[5] = float_up(geodetic->zmax);
+		size = 6;
+	}
+	else
+	{
+		double		xmin = INFINITY;
+		double		xmax = -INFINITY;
+		double		ymin = INFINITY;
+		double		ymax = -INFINITY;
+
+		for (int i = 0; i < num; i++)
+		{
+			for (int v = 0; v < boundaries[i].numVerts; v++)
+			{
+				const LatLng *vert = &boundaries[i].verts[v];
+
+				xmin = Min(xmin, vert->lng);
+				xmax = Max(xmax, vert->lng);
+				ymin = Min(ymin, vert->lat);
+				ymax = Max(ymax, vert->lat);
+			}
+		}
+
+		box[0] = float_down(xmin);
+		box[1] = float_up(xmax);
+		box[2] = float_down(ymin);
+		box[3] = float_up(ymax);
+	}
+
+	return gserialized_write(data, box, size * GSERIALIZED_FLOAT_SIZE);
+}
+
+/* Largest float not above value */
+float
+float_down(double value)
+{
+	float		result = value;
+
+	if ((double) result <= value)
+		return result;
+	return nextafterf(result, -INFINITY);
+}
+
+/* Smallest float not below value */
+float
+float_up(double value)
+{
+	float		result = value;
+
+	if ((double) result >= value)
+		return result;
+	return nextafterf(result, INFINITY);
+}
+
+uint8 *
+gserialized_write(uint8 *data, const void *value, size_t size)
+{
+	memcpy(data, value, size);
+	return data + size;
+}
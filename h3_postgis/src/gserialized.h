@@ -0,0 +1,45 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PGH3_GSERIALIZED_H
+#define PGH3_GSERIALIZED_H
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include "wkb_bbox3.h"
+#include "wkb_flat_geo.h"
+
+/*
+ * Serializes boundaries in degrees the way PostGIS stores geometries (format
+ * version 1, read by PostGIS 2 and 3), with SRID 4326 and a bounding box.
+ * One boundary becomes a polygon, more a multi polygon.
+ *
+ * Geometries get the planar box of the coordinates. Geographies are marked
+ * geodetic when given the box of their geocentric coordinates.
+ */
+struct varlena *boundary_array_to_gserialized(const CellBoundary * boundaries, int num,
+											  const Bbox3 * geodetic);
+
+/*
+ * Serializes polygons in degrees as a geometry collection, the same way.
+ * Neighbouring polygons share edges, so they would not make a valid multi
+ * polygon.
+ */
+struct varlena *flat_geo_to_gserialized(const FlatGeoPolygon * geo);
+
+#endif
@@ -0,0 +1,531 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <postgres.h>
+#include <h3api.h>
+
+#include <math.h>
+#include <string.h>
+#include <utils/memutils.h> // MaxAllocSize
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
+#include "error.h"
+#include "mvt.h"
+#include "wkb_flat_geo.h"
+#include "wkb_indexing.h"
+
+/* latitude where Web Mercator ends making the world square, 85.05113 degrees */
+#define MERCATOR_MAX_LAT 1.4844222297453324
+
+/* clipping by each side of the box at most doubles the vertices */
+#define MVT_MAX_VERTS (16 * MAX_CELL_BNDRY_VERTS)
+
+/* bytes of a varint of 64 bits, a command and its two parameters */
+#define MVT_MAX_VARINT_SIZE 10
+#define MVT_MAX_COMMAND_SIZE (3 * MVT_MAX_VARINT_SIZE)
+
+#define MVT_VERSION 2
+#define MVT_VALUE_KEY "value"
+
+/* protobuf wire types */
+#define PB_VARINT 0
+#define PB_FIXED64 1
+#define PB_LENGTH 2
+#define PB_KEY(field, type) (((field) << 3) | (type))
+
+/* fields of the tile, layers, features and values */
+#define MVT_TILE_LAYERS 3
+#define MVT_LAYER_NAME 1
+#define MVT_LAYER_FEATURES 2
+#define MVT_LAYER_KEYS 3
+#define MVT_LAYER_VALUES 4
+#define MVT_LAYER_EXTENT 5
+#define MVT_LAYER_VERSION 15
+#define MVT_FEATURE_ID 1
+#define MVT_FEATURE_TAGS 2
+#define MVT_FEATURE_TYPE 3
+#define MVT_FEATURE_GEOMETRY 4
+#define MVT_VALUE_DOUBLE 3
+
+#define MVT_POLYGON 3
+
+/* geometry commands */
+#define MVT_MOVE_TO 1
+#define MVT_LINE_TO 2
+#define MVT_CLOSE_PATH 7
+#define MVT_COMMAND(id, count) (((uint32) (count) << 3) | (id))
+#define MVT_ZIGZAG(n) (((uint32) (n) << 1) ^ (uint32) ((n) >> 31))
+
+/* Projects radians to pixels of the tile */
+static void
+			mvt_project(const MvtTile * tile, const LatLng * coord, FlatPoint * pixel);
+
+/* Clips a ring to the tile and its buffer in place, returning its size */
+static int
+			mvt_clip_ring(const MvtTile * tile, FlatPoint * ring, int num);
+
+/* Clips a ring to one side of a box, keeping sign * coordinate <= sign * bound */
+static int
+			clip_ring_side(const FlatPoint * ring, int num, bool vertical, int sign,
+						   double bound, FlatPoint * out);
+
+/*
+ * Rounds a clipped ring to integer pixels and encodes it, clockwise on
+ * screen as exterior rings must be. Returns false if nothing is left.
+ */
+static bool
+			mvt_add_ring(MvtTile * tile, const FlatPoint * ring, int num, int32 *cursor);
+
+static void
+			mvt_reserve_geometry(MvtTile * tile, int size);
+
+static int
+			mvt_value_cmp(const void *a, const void *b);
+
+static int
+			mvt_feature_size(const MvtFeature * feature, int valueIndex);
+
+static int
+			varint_size(uint64 value);
+
+static uint8 *
+			write_varint(uint8 *data, uint64 value);
+
+static uint8 *
+			write_double(uint8 *data, double value);
+
+void
+mvt_init(MvtTile * tile, int z, int x, int y, int extent, int buffer)
+{
+	tile->extent = extent;
+	tile->buffer = buffer;
+	tile->scale = ldexp(extent, z);
+	tile->originX = (double) x * extent;
+	tile->originY = (double) y * extent;
+
+	tile->maxGeometrySize = 1024;
+	tile->geometrySize = 0;
+	tile->geometry = palloc(tile->maxGeometrySize);
+
+	tile->maxFeatures = 64;
+	tile->numFeatures = 0;
+	tile->features = palloc(tile->maxFeatures * sizeof(MvtFeature));
+}
+
+void
+mvt_free(MvtTile * tile)
+{
+	pfree(tile->geometry);
+	pfree(tile->features);
+}
+
+bool
+mvt_add_cell(MvtTile * tile, H3Index cell, const double *value)
+{
+	CellBoundary parts[2];
+	bool		polar;
+	int			num = cell_to_boundary_parts(cell, parts, &polar);
+	int			offset = tile->geometrySize;
+	int32		cursor[2] = {0, 0};
+	bool		added = false;
+	MvtFeature *feature;
+
+	for (int i = 0; i < num; i++)
+	{
+		FlatPoint	ring[MVT_MAX_VERTS];
+		int			size;
+
+		for (int v = 0; v < parts[i].numVerts; v++)
+			mvt_project(tile, &parts[i].verts[v], &ring[v]);
+
+		size = mvt_clip_ring(tile, ring, parts[i].numVerts);
+		if (size > 0)
+			added |= mvt_add_ring(tile, ring, size, cursor);
+	}
+
+	if (!added)
+		return false;
+
+	if (tile->numFeatures == tile->maxFeatures)
+	{
+		tile->maxFeatures *= 2;
+		tile->features = repalloc_huge(tile->features, (Size) tile->maxFeatures * sizeof(MvtFeature));
+	}
+
+	feature = &tile->features[tile->numFeatures++];
+	feature->cell = cell;
+	feature->hasValue = (value != NULL);
+	feature->value = value ? *value : 0;
+	feature->offset = offset;
+	feature->size = tile->geometrySize - offset;
+	return true;
+}
+
+bytea *
+mvt_to_bytea(const MvtTile * tile, const char *name)
+{
+	bytea	   *result;
+	uint8	   *data;
+	double	   *values;
+	int		   *valueIndexes;
+	int			numValues = 0;
+	int			nameSize = strlen(name);
+	int			keySize = strlen(MVT_VALUE_KEY);
+	int64		layerSize;
+	int64		size;
+
+	if (tile->numFeatures == 0)
+	{
+		result = palloc(VARHDRSZ);
+		SET_VARSIZE(result, VARHDRSZ);
+		return result;
+	}
+
+	/* distinct values, referenced by the tags of features */
+	values = palloc(tile->numFeatures * sizeof(double));
+	for (int i = 0; i < tile->numFeatures; i++)
+		if (tile->features[i].hasValue)
+			values[numValues++] = tile->features[i].value;
+
+	qsort(values, numValues, sizeof(double), mvt_value_cmp);
+	{
+		int			n = 0;
+
+		for (int i = 0; i < numValues; i++)
+			if (n == 0 || mvt_value_cmp(&values[n - 1], &values[i]) != 0)
+				values[n++] = values[i];
+		numValues = n;
+	}
+
+	valueIndexes = palloc(tile->numFeatures * sizeof(int));
+	for (int i = 0; i < tile->numFeatures; i++)
+	{
+		const double *found;
+
+		valueIndexes[i] = -1;
+		if (!tile->features[i].hasValue)
+			continue;
+
+		found = bsearch(&tile->features[i].value, values, numValues,
+						sizeof(double), mvt_value_cmp);
+		ASSERT(found != NULL, ERRCODE_EXTERNAL_ROUTINE_EXCEPTION,
+			   "Value of feature must be among the values of the layer");
+		valueIndexes[i] = found - values;
+	}
+
+	/* version, name, features, key and values, extent */
+	layerSize = 2 + 1 + varint_size(nameSize) + nameSize;
+	for (int i = 0; i < tile->numFeatures; i++)
+	{
+		int			featureSize = mvt_feature_size(&tile->features[i], valueIndexes[i]);
+
+		layerSize += 1 + varint_size(featureSize) + featureSize;
+	}
+	if (numValues > 0)
+		layerSize += 1 + varint_size(keySize) + keySize;
+	layerSize += numValues * (1 + 1 + 1 + sizeof(double));
+	layerSize += 1 + varint_size(tile->extent);
+
+	size = VARHDRSZ + 1 + varint_size(layerSize) + layerSize;
+	ASSERT(size <= MaxAllocSize, ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		   "Tile of %d features is too large to encode", tile->numFeatures);
+
+	result = palloc(size);
+	SET_VARSIZE(result, size);
+	data = (uint8 *) VARDATA(result);
+
+	*data++ = PB_KEY(MVT_TILE_LAYERS, PB_LENGTH);
+	data = write_varint(data, layerSize);
+
+	*data++ = PB_KEY(MVT_LAYER_VERSION, PB_VARINT);
+	*data++ = MVT_VERSION;
+
+	*data++ = PB_KEY(MVT_LAYER_NAME, PB_LENGTH);
+	data = write_varint(data, nameSize);
+	memcpy(data, name, nameSize);
+	data += nameSize;
+
+	for (int i = 0; i < tile->numFeatures; i++)
+	{
+		const MvtFeature *feature = &tile->features[i];
+
+		*data++ = PB_KEY(MVT_LAYER_FEATURES, PB_LENGTH);
+		data = write_varint(data, mvt_feature_size(feature, valueIndexes[i]));
+
+		*data++ = PB_KEY(MVT_FEATURE_ID, PB_VARINT);
+		data = write_varint(data, feature->cell);
+
+		if (valueIndexes[i] >= 0)
+		{
+			/* key 0, value index */
+			*data++ = PB_KEY(MVT_FEATURE_TAGS, PB_LENGTH);
+			data = write_varint(data, 1 + varint_size(valueIndexes[i]));
+			*data++ = 0;
+			data = write_varint(data, valueIndexes[i]);
+		}
+
+		*data++ = PB_KEY(MVT_FEATURE_TYPE, PB_VARINT);
+		*data++ = MVT_POLYGON;
+
+		*data++ = PB_KEY(MVT_FEATURE_GEOMETRY, PB_LENGTH);
+		data = write_varint(data, feature->size);
+		memcpy(data, tile->geometry + feature->offset, feature->size);
+		data += feature->size;
+	}
+
+	if (numValues > 0)
+	{
+		*data++ = PB_KEY(MVT_LAYER_KEYS, PB_LENGTH);
+		data = write_varint(data, keySize);
+		memcpy(data, MVT_VALUE_KEY, keySize);
+		data += keySize;
+	}
+
+	for (int i = 0; i < numValues; i++)
+	{
+		*data++ = PB_KEY(MVT_LAYER_VALUES, PB_LENGTH);
+		*data++ = 1 + sizeof(double);
+		*data++ = PB_KEY(MVT_VALUE_DOUBLE, PB_FIXED64);
+		data = write_double(data, values[i]);
+	}
+
+	*data++ = PB_KEY(MVT_LAYER_EXTENT, PB_VARINT);
+	data = write_varint(data, tile->extent);
+
+	ASSERT(
+		   (uint8 *) result + size == data,
+		   ERRCODE_EXTERNAL_ROUTINE_EXCEPTION,
+		   "# of written bytes (%d) must match allocation size (%d)",
+		   (int) (data - (uint8 *) result), (int) size);
+
+	pfree(values);
+	pfree(valueIndexes);
+	return result;
+}
+
+void
+mvt_project(const MvtTile * tile, const LatLng * coord, FlatPoint * pixel)
+{
+	double		lat = Max(Min(coord->lat, MERCATOR_MAX_LAT), -MERCATOR_MAX_LAT);
+
+	pixel->x = (coord->lng / (2 * M_PI) + 0.5) * tile->scale - tile->originX;
+	pixel->y = (0.5 - log(tan(M_PI_4 + lat / 2)) / (2 * M_PI)) * tile->scale - tile->originY;
+}
+
+int
+mvt_clip_ring(const MvtTile * tile, FlatPoint * ring, int num)
+{
+	double		min = -tile->buffer;
+	double		max = tile->extent + tile->buffer;
+	double		xmin = INFINITY;
+	double		xmax = -INFINITY;
+	double		ymin = INFINITY;
+	double		ymax = -INFINITY;
+	FlatPoint	clipped[MVT_MAX_VERTS];
+
+	for (int i = 0; i < num; i++)
+	{
+		xmin = Min(xmin, ring[i].x);
+		xmax = Max(xmax, ring[i].x);
+		ymin = Min(ymin, ring[i].y);
+		ymax = Max(ymax, ring[i].y);
+	}
+
+	/* most cells are either outside or inside */
+	if (xmax < min || xmin > max || ymax < min || ymin > max)
+		return 0;
+	if (xmin >= min && xmax <= max && ymin >= min && ymax <= max)
+		return num;
+
+	num = clip_ring_side(ring, num, false, -1, min, clipped);
+	num = clip_ring_side(clipped, num, false, 1, max, ring);
+	num = clip_ring_side(ring, num, true, -1, min, clipped);
+	num = clip_ring_side(clipped, num, true, 1, max, ring);
+	return num;
+}
+
+int
+clip_ring_side(const FlatPoint * ring, int num, bool vertical, int sign,
+			   double bound, FlatPoint * out)
+{
+	int			size = 0;
+
+	for (int i = 0; i < num; i++)
+	{
+		const FlatPoint *prev = &ring[(i + num - 1) % num];
+		const FlatPoint *cur = &ring[i];
+		double		prevCoord = vertical ? prev->y : prev->x;
+		double		curCoord = vertical ? cur->y : cur->x;
+		bool		prevInside = sign * prevCoord <= sign * bound;
+		bool		curInside = sign * curCoord <= sign * bound;
+
+		if (prevInside != curInside)
+		{
+			double		t = (bound - prevCoord) / (curCoord - prevCoord);
+			FlatPoint  *crossing = &out[size++];
+
+			crossing->x = vertical ? prev->x + t * (cur->x - prev->x) : bound;
+			crossing->y = vertical ? bound : prev->y + t * (cur->y - prev->y);
+		}
+		if (curInside)
+			out[size++] = *cur;
+	}
+	return size;
+}
+
+bool
+mvt_add_ring(MvtTile * tile, const FlatPoint * ring, int num, int32 *cursor)
+{
+	int32		xs[MVT_MAX_VERTS];
+	int32		ys[MVT_MAX_VERTS];
+	int			size = 0;
+	int64		area = 0;
+	uint8	   *data;
+
+	for (int i = 0; i < num; i++)
+	{
+		int32		x = (int32) lround(ring[i].x);
+		int32		y = (int32) lround(ring[i].y);
+
+		if (size > 0 && xs[size - 1] == x && ys[size - 1] == y)
+			continue;
+		xs[size] = x;
+		ys[size] = y;
+		size++;
+	}
+	while (size > 1 && xs[size - 1] == xs[0] && ys[size - 1] == ys[0])
+		size--;
+
+	if (size < 3)
+		return false;
+
+	/* twice the area, positive if clockwise with y down */
+	for (int i = 0; i < size; i++)
+	{
+		int			next = (i + 1) % size;
+
+		area += (int64) xs[i] * ys[next] - (int64) xs[next] * ys[i];
+	}
+	if (area == 0)
+		return false;
+
+	mvt_reserve_geometry(tile, (size + 1) * MVT_MAX_COMMAND_SIZE);
+	data = tile->geometry + tile->geometrySize;
+
+	for (int i = 0; i < size; i++)
+	{
+		int			v = (area > 0) ? i : size - 1 - i;
+
+		if (i == 0)
+			data = write_varint(data, MVT_COMMAND(MVT_MOVE_TO, 1));
+		else if (i == 1)
+			data = write_varint(data, MVT_COMMAND(MVT_LINE_TO, size - 1));
+
+		data = write_varint(data, MVT_ZIGZAG(xs[v] - cursor[0]));
+		data = write_varint(data, MVT_ZIGZAG(ys[v] - cursor[1]));
+		cursor[0] = xs[v];
+		cursor[1] = ys[v];
+	}
+	data = write_varint(data, MVT_COMMAND(MVT_CLOSE_PATH, 1));
+
+	tile->geometrySize = data - tile->geometry;
+	return true;
+}
+
+/* Makes room for size more bytes, at least doubling */
+void
+mvt_reserve_geometry(MvtTile * tile, int size)
+{
+	if (tile->geometrySize + size <= tile->maxGeometrySize)
+		return;
+
+	ASSERT((int64) tile->geometrySize + size <= MaxAllocSize,
+		   ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		   "Tile of %d features is too large to encode", tile->numFeatures);
+
+	tile->maxGeometrySize = Min(Max((int64) tile->maxGeometrySize * 2,
+									tile->geometrySize + size), MaxAllocSize);
+	tile->geometry = repalloc(tile->geometry, tile->maxGeometrySize);
+}
+
+/* Orders values, NaN last */
+int
+mvt_value_cmp(const void *a, const void *b)
+{
+	double		x = *(const double *) a;
+	double		y = *(const double *) b;
+
+	if (isnan(x) || isnan(y))
+		return isnan(x) - isnan(y);
+	return (x > y) - (x < y);
+}
+
+/* Id, tags, type and geometry */
+int
+mvt_feature_size(const MvtFeature * feature, int valueIndex)
+{
+	int			size = 1 + varint_size(feature->cell) + 2
+		+ 1 + varint_size(feature->size) + feature->size;
+
+	if (valueIndex >= 0)
+	{
+		int			tagsSize = 1 + varint_size(valueIndex);
+
+		size += 1 + varint_size(tagsSize) + tagsSize;
+	}
+	return size;
+}
+
+int
+varint_size(uint64 value)
+{
+	int			size = 1;
+
+	while (value >= 0x80)
+	{
+		value >>= 7;
+		size++;
+	}
+	return size;
+}
+
+uint8 *
+write_varint(uint8 *data, uint64 value)
+{
+	while (value >= 0x80)
+	{
+		*data++ = (uint8) (value | 0x80);
+		value >>= 7;
+	}
+	*data++ = (uint8) value;
+	return data;
+}
+
+/* Little endian, whatever the byte order of the machine */
+uint8 *
+write_double(uint8 *data, double value)
+{
+	uint64		bits;
+
+	memcpy(&bits, &value, sizeof(double));
+	for (int i = 0; i < sizeof(double); i++)
+		*data++ = (uint8) (bits >> (8 * i));
+	return data;
+}
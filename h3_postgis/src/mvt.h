@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PGH3_MVT_H
+#define PGH3_MVT_H
+
+#include <postgres.h>
+#include <h3api.h>
+
+/* largest extent and buffer, keeping pixels and their deltas in 32 bits */
+#define MVT_MAX_EXTENT (1 << 24)
+
+/* Feature of a tile, its geometry a run of the shared geometry buffer */
+typedef struct
+{
+	H3Index		cell;			/* the feature id */
+	double		value;
+	bool		hasValue;
+	int			offset;
+	int			size;
+}	MvtFeature;
+
+/*
+ * Layer of a Mapbox Vector Tile (version 2), built one cell at a time.
+ * Boundaries are projected from radians straight to Web Mercator pixels of
+ * the tile, clipped to the tile and its buffer, and encoded as polygon
+ * commands. Cells outside are left out.
+ */
+typedef struct
+{
+	int			extent;
+	int			buffer;
+	double		scale;			/* pixels across the world */
+	double		originX;		/* pixels left of the tile */
+	double		originY;		/* pixels above the tile */
+	uint8	   *geometry;		/* packed commands of every feature */
+	int			geometrySize;
+	int			maxGeometrySize;
+	MvtFeature *features;
+	int			numFeatures;
+	int			maxFeatures;
+}	MvtTile;
+
+void
+			mvt_init(MvtTile * tile, int z, int x, int y, int extent, int buffer);
+
+/* Adds the cell as a feature, with a value if given. False if outside */
+bool
+			mvt_add_cell(MvtTile * tile, H3Index cell, const double *value);
+
+/* Encodes the layer of the given name, empty if there are no features */
+bytea *
+			mvt_to_bytea(const MvtTile * tile, const char *name);
+
+void
+			mvt_free(MvtTile * tile);
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <postgres.h>
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
+#include <h3api.h>
+
+#include <fmgr.h>			// PG_FUNCTION_ARGS
+#include <utils/builtins.h> // text_to_cstring
+
+#include "error.h"
+#include "mvt.h"
+#include "stat.h"
+#include "type.h"
+
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_mvt_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_mvt_finalfn);
+
+/* deepest zoom, numbering tiles in 32 bits */
+#define MVT_MAX_ZOOM 30
+
+#define MVT_DEFAULT_EXTENT 4096
+#define MVT_DEFAULT_BUFFER 256
+#define MVT_DEFAULT_NAME "h3"
+
+/*
+ * Transition state of the tile aggregate. The tile is taken from the first
+ * row, and every other row must give the same.
+ */
+typedef struct
+{
+	int			z;
+	int			x;
+	int			y;
+	int			extent;
+	int			buffer;
+	char	   *name;
+	MvtTile		tile;
+}	H3MvtState;
+
+/*
+ * Arguments follow the cell: the value if there are more than four, then
+ * z/x/y, then extent, buffer and layer name if there are eight.
+ */
+static Datum
+h3_cells_to_mvt_transfn_internal(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	H3MvtState *state = PG_ARGISNULL(0) ? NULL : (H3MvtState *) PG_GETARG_POINTER(0);
+	bool		hasValue = PG_NARGS() > 5;
+	int			tileArg = hasValue ? 3 : 2;
+	int			z,
+				x,
+				y;
+	int			extent = MVT_DEFAULT_EXTENT;
+	int			buffer = MVT_DEFAULT_BUFFER;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "h3_cells_to_mvt_transfn called in non-aggregate context");
+
+	for (int i = tileArg; i < PG_NARGS(); i++)
+		ASSERT(!PG_ARGISNULL(i), ERRCODE_NULL_VALUE_NOT_ALLOWED,
+			   "Tile, extent, buffer and layer name must not be null.");
+
+	z = PG_GETARG_INT32(tileArg);
+	x = PG_GETARG_INT32(tileArg + 1);
+	y = PG_GETARG_INT32(tileArg + 2);
+	if (PG_NARGS() > 6)
+	{
+		extent = PG_GETARG_INT32(tileArg + 3);
+		buffer = PG_GETARG_INT32(tileArg + 4);
+	}
+
+	if (state == NULL)
+	{
+		MemoryContext oldcontext;
+
+		ASSERT(z >= 0 && z <= MVT_MAX_ZOOM, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Zoom must be between 0 and %d.", MVT_MAX_ZOOM);
+		ASSERT(x >= 0 && x < (1 << z) && y >= 0 && y < (1 << z),
+			   ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Tile %d/%d/%d does not exist.", z, x, y);
+		ASSERT(extent > 0 && extent <= MVT_MAX_EXTENT, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Extent must be between 1 and %d.", MVT_MAX_EXTENT);
+		ASSERT(buffer >= 0 && buffer <= MVT_MAX_EXTENT, ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Buffer must be between 0 and %d.", MVT_MAX_EXTENT);
+
+		oldcontext = MemoryContextSwitchTo(aggcontext);
+		state = palloc(sizeof(H3MvtState));
+		state->z = z;
+		state->x = x;
+		state->y = y;
+		state->extent = extent;
+		state->buffer = buffer;
+		state->name = (PG_NARGS() > 6)
+			? text_to_cstring(PG_GETARG_TEXT_PP(tileArg + 5))
+			: pstrdup(MVT_DEFAULT_NAME);
+		mvt_init(&state->tile, z, x, y, extent, buffer);
+		MemoryContextSwitchTo(oldcontext);
+	}
+	else
+	{
+		ASSERT(z == state->z && x == state->x && y == state->y
+			   && extent == state->extent && buffer == state->buffer,
+			   ERRCODE_INVALID_PARAMETER_VALUE,
+			   "Tile must be the same for all rows.");
+		if (PG_NARGS() > 6)
+		{
+			text	   *name = PG_GETARG_TEXT_PP(tileArg + 5);
+			size_t		len = VARSIZE_ANY_EXHDR(name);
+
+			ASSERT(len == strlen(state->name)
+				   && memcmp(VARDATA_ANY(name), state->name, len) == 0,
+				   ERRCODE_INVALID_PARAMETER_VALUE,
+				   "Layer name must be the same for all rows.");
+		}
+	}
+
+	if (!PG_ARGISNULL(1))
+	{
+		double		value;
+		const double *valuePtr = NULL;
+
+		if (hasValue && !PG_ARGISNULL(2))
+		{
+			value = PG_GETARG_FLOAT8(2);
+			valuePtr = &value;
+		}
+		mvt_add_cell(&state->tile, PG_GETARG_H3INDEX(1), valuePtr);
+	}
+
+	PG_RETURN_POINTER(state);
+}
+
+Datum
+h3_cells_to_mvt_transfn(PG_FUNCTION_ARGS)
+{
+	return stat_time(H3_STAT_WKB, h3_cells_to_mvt_transfn_internal, fcinfo);
+}
+
+/* Encodes the tile, empty if no cell was in it */
+static Datum
+h3_cells_to_mvt_finalfn_internal(PG_FUNCTION_ARGS)
+{
+	H3MvtState *state = PG_ARGISNULL(0) ? NULL : (H3MvtState *) PG_GETARG_POINTER(0);
+
+	if (state == NULL)
+	{
+		bytea	   *empty = palloc(VARHDRSZ);
+
+		SET_VARSIZE(empty, VARHDRSZ);
+		PG_RETURN_BYTEA_P(empty);
+	}
+
+	PG_RETURN_BYTEA_P(mvt_to_bytea(&state->tile, state->name));
+}
+
+Datum
+h3_cells_to_mvt_finalfn(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_WKB, h3_cells_to_mvt_finalfn_internal, fcinfo);
+}
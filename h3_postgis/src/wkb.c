@@ -14,12 +14,17 @@
  * limitations under the License.
  */
 
+#include <postgres.h>
+
+#include <math.h>		  // isnan
+#include <miscadmin.h> // check_stack_depth
 #include <stddef.h>
 #include <string.h>
 
 #include "error.h"
 #include "wkb.h"
-#include "wkb_linked_geo.h"
+#include "wkb_flat_geo.h"
+#include "wkb_split.h"
 
 #define WKB_BYTE_SIZE 1
 #define WKB_INT_SIZE 4
@@ -28,10 +33,18 @@
 #define WKB_NDR 1
 #define WKB_XDR 0
 
+#define WKB_POINT_TYPE 1
+#define WKB_LINESTRING_TYPE 2
 #define WKB_POLYGON_TYPE 3
+#define WKB_MULTIPOINT_TYPE 4
+#define WKB_MULTILINESTRING_TYPE 5
 #define WKB_MULTIPOLYGON_TYPE 6
+#define WKB_COLLECTION_TYPE 7
 
+#define WKB_Z_FLAG 0x80000000
+#define WKB_M_FLAG 0x40000000
 #define WKB_SRID_FLAG 0x20000000
+#define WKB_FLAGS (WKB_Z_FLAG | WKB_M_FLAG | WKB_SRID_FLAG)
 
 #define WKB_SRID_DEFAULT 4326
 
@@ -42,6 +55,22 @@
 		"# of written bytes (%d) must match allocation size (%d)", \
 		(int)(data - (uint8 *)wkb), VARSIZE(wkb))
 
+/* Position in WKB being read */
+typedef struct
+{
+	const uint8 *data;
+	const uint8 *end;
+	bool		swap;			/* byte order differs from native */
+}	WkbReader;
+
+/* Polygons read so far */
+typedef struct
+{
+	GeoPolygon *polygons;
+	int			num;
+	int			size;
+}	WkbPolygons;
+
 static bool
 			boundary_is_empty(const CellBoundary * boundary);
 
@@ -55,10 +84,7 @@ static size_t
 			boundary_data_size(const CellBoundary * boundary);
 
 static size_t
-			linked_geo_polygon_data_size(const LinkedGeoPolygon * multiPolygon);
-
-static size_t
-			linked_geo_loop_data_size(const LinkedGeoLoop * loop);
+			flat_geo_polygon_data_size(const FlatGeoPolygon * geo);
 
 static uint8 *
 			wkb_write_boundary_array_data(uint8 *data, const CellBoundary * boundaries, int num);
@@ -67,13 +93,13 @@ static uint8 *
 			wkb_write_boundary_data(uint8 *data, const CellBoundary * boundary);
 
 static uint8 *
-			wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPolygon);
+			wkb_write_flat_geo_polygon_data(uint8 *data, const FlatGeoPolygon * geo);
 
 static uint8 *
 			wkb_write_lat_lng_array(uint8 *data, const LatLng * coord, int num);
 
 static uint8 *
-			wkb_write_linked_geo_loop_data(uint8 *data, const LinkedGeoLoop * loop);
+			wkb_write_flat_ring_data(uint8 *data, const FlatPoint * points, int num);
 
 static uint8 *
 			wkb_write_lat_lng(uint8 *data, const LatLng * coord);
@@ -81,6 +107,9 @@ static uint8 *
 static uint8 *
 			wkb_write_endian(uint8 *data);
 
+static uint8
+			wkb_native_order(void);
+
 static uint8 *
 			wkb_write_int(uint8 *data, uint32 value);
 
@@ -122,22 +151,305 @@ boundary_to_wkb(const CellBoundary * boundary)
 }
 
 bytea *
-linked_geo_polygon_to_wkb(const LinkedGeoPolygon * multiPolygon)
+cells_to_multi_polygon_wkb(const H3Index * cells, int numCells)
+{
+	LinkedGeoPolygon *linkedPolygon;
+	FlatGeoPolygon polygon;
+	bytea	   *wkb;
+
+	/* produce hexagons into allocated memory, then pack them */
+	linkedPolygon = palloc(sizeof(LinkedGeoPolygon));
+	h3_assert(cellsToLinkedMultiPolygon(cells, numCells, linkedPolygon));
+	flat_geo_from_linked(linkedPolygon, &polygon);
+	destroyLinkedMultiPolygon(linkedPolygon);
+	pfree(linkedPolygon);
+
+	if (is_flat_geo_crossed_by_180(&polygon))
+	{
+		/* Split by 180th meridian */
+		FlatGeoPolygon split;
+
+		split_flat_geo_by_180(&polygon, &split);
+		flat_geo_free(&polygon);
+		polygon = split;
+	}
+
+	flat_geo_to_degs(&polygon);
+	wkb = flat_geo_polygon_to_wkb(&polygon);
+	flat_geo_free(&polygon);
+
+	return wkb;
+}
+
+bytea *
+flat_geo_polygon_to_wkb(const FlatGeoPolygon * geo)
 {
 	bytea	   *wkb;
 	uint8	   *data;
-	size_t		size = linked_geo_polygon_data_size(multiPolygon);
+	size_t		size = flat_geo_polygon_data_size(geo);
 
 	wkb = palloc(VARHDRSZ + size);
 	SET_VARSIZE(wkb, VARHDRSZ + size);
 
 	data = (uint8 *) VARDATA(wkb);
-	data = wkb_write_linked_geo_polygon_data(data, multiPolygon);
+	data = wkb_write_flat_geo_polygon_data(data, geo);
 
 	ASSERT_WKB_DATA_WRITTEN(wkb, data);
 	return wkb;
 }
 
+static void
+wkb_read(WkbReader * reader, void *value, size_t size)
+{
+	ASSERT(reader->end - reader->data >= size, ERRCODE_INVALID_BINARY_REPRESENTATION,
+		   "WKB ends unexpectedly");
+
+	if (reader->swap)
+	{
+		for (size_t i = 0; i < size; i++)
+			((uint8 *) value)[i] = reader->data[size - 1 - i];
+	}
+	else
+		memcpy(value, reader->data, size);
+
+	reader->data += size;
+}
+
+static uint32
+wkb_read_int(WkbReader * reader)
+{
+	uint32		value;
+
+	wkb_read(reader, &value, sizeof(value));
+	return value;
+}
+
+/* Reads a ring, leaving out the closing point, with coordinates in radians */
+static void
+wkb_read_loop(WkbReader * reader, int dimensions, GeoLoop * loop)
+{
+	uint32		numPoints = wkb_read_int(reader);
+
+	ASSERT((reader->end - reader->data) / (dimensions * WKB_DOUBLE_SIZE) >= numPoints,
+		   ERRCODE_INVALID_BINARY_REPRESENTATION, "WKB ends unexpectedly");
+
+	loop->numVerts = numPoints;
+	loop->verts = palloc(Max(numPoints, 1) * sizeof(LatLng));
+
+	for (int i = 0; i < numPoints; i++)
+	{
+		double		x;
+		double		y;
+
+		wkb_read(reader, &x, sizeof(x));
+		wkb_read(reader, &y, sizeof(y));
+		/* skip z and m */
+		reader->data += (dimensions - 2) * WKB_DOUBLE_SIZE;
+
+		loop->verts[i].lng = degsToRads(x);
+		loop->verts[i].lat = degsToRads(y);
+	}
+
+	if (numPoints > 1
+		&& loop->verts[0].lat == loop->verts[numPoints - 1].lat
+		&& loop->verts[0].lng == loop->verts[numPoints - 1].lng)
+		loop->numVerts--;
+}
+
+static void
+			wkb_read_geometry(WkbReader * reader, WkbPolygons * out, bool member);
+
+/*
+ * Skips a point or line geometry (or a collection of them), returning false
+ * for any other type.
+ */
+static bool
+wkb_skip_geometry(WkbReader * reader, WkbPolygons * out, uint32 type, int dimensions)
+{
+	uint32		num;
+
+	switch (type)
+	{
+		case WKB_POINT_TYPE:
+			num = 1;
+			break;
+		case WKB_LINESTRING_TYPE:
+			num = wkb_read_int(reader);
+			break;
+		case WKB_MULTIPOINT_TYPE:
+		case WKB_MULTILINESTRING_TYPE:
+			num = wkb_read_int(reader);
+			for (uint32 i = 0; i < num; i++)
+				wkb_read_geometry(reader, out, true);
+			return true;
+		default:
+			return false;
+	}
+
+	ASSERT((reader->end - reader->data) / (dimensions * WKB_DOUBLE_SIZE) >= num,
+		   ERRCODE_INVALID_BINARY_REPRESENTATION, "WKB ends unexpectedly");
+	reader->data += num * dimensions * WKB_DOUBLE_SIZE;
+	return true;
+}
+
+/* Reads the byte order and type of a geometry, returning its base type */
+static uint32
+wkb_read_header(WkbReader * reader, int *dimensions)
+{
+	uint8		order;
+	uint32		type;
+
+	wkb_read(reader, &order, sizeof(order));
+	ASSERT(order == WKB_NDR || order == WKB_XDR, ERRCODE_INVALID_BINARY_REPRESENTATION,
+		   "Invalid WKB byte order %d", order);
+	reader->swap = (order != wkb_native_order());
+
+	type = wkb_read_int(reader);
+
+	/* extended WKB flags */
+	*dimensions = 2;
+	*dimensions += (type & WKB_Z_FLAG) ? 1 : 0;
+	*dimensions += (type & WKB_M_FLAG) ? 1 : 0;
+	if (type & WKB_SRID_FLAG)
+		wkb_read_int(reader);
+	type &= ~WKB_FLAGS;
+
+	/* ISO WKB dimensions: 1000 for z, 2000 for m, 3000 for both */
+	*dimensions += (type / 1000 == 3) ? 2 : (type / 1000 > 0);
+	return type % 1000;
+}
+
+/* Reads polygons of a geometry, or of a member of a collection */
+static void
+wkb_read_geometry(WkbReader * reader, WkbPolygons * out, bool member)
+{
+	int			dimensions;
+	uint32		type;
+
+	/* collections may nest arbitrarily deep */
+	check_stack_depth();
+
+	type = wkb_read_header(reader, &dimensions);
+
+	switch (type)
+	{
+		case WKB_POLYGON_TYPE:
+			{
+				uint32		numRings = wkb_read_int(reader);
+				GeoPolygon *polygon;
+
+				if (numRings == 0)
+					return;
+
+				if (out->num == out->size)
+				{
+					out->size *= 2;
+					out->polygons = repalloc(out->polygons, out->size * sizeof(GeoPolygon));
+				}
+				polygon = &out->polygons[out->num++];
+
+				wkb_read_loop(reader, dimensions, &polygon->geoloop);
+				polygon->numHoles = numRings - 1;
+				polygon->holes = palloc(Max(polygon->numHoles, 1) * sizeof(GeoLoop));
+				for (int i = 0; i < polygon->numHoles; i++)
+					wkb_read_loop(reader, dimensions, &polygon->holes[i]);
+				break;
+			}
+
+		case WKB_MULTIPOLYGON_TYPE:
+		case WKB_COLLECTION_TYPE:
+			{
+				uint32		num = wkb_read_int(reader);
+
+				/* each member has its own byte order */
+				for (uint32 i = 0; i < num; i++)
+					wkb_read_geometry(reader, out, true);
+				break;
+			}
+
+		default:
+			/* points and lines of collections cover no cells */
+			if (member && wkb_skip_geometry(reader, out, type, dimensions))
+				break;
+			ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE,
+				   "Only polygons, multipolygons and collections of them can be filled (got WKB type %d)", type);
+	}
+}
+
+GeoPolygon *
+wkb_to_polygons(const bytea *wkb, int *num)
+{
+	WkbReader	reader = {
+		.data = (const uint8 *) VARDATA_ANY(wkb),
+		.end = (const uint8 *) VARDATA_ANY(wkb) + VARSIZE_ANY_EXHDR(wkb),
+		.swap = false
+	};
+	WkbPolygons polygons = {
+		.polygons = palloc(sizeof(GeoPolygon)),
+		.num = 0,
+		.size = 1
+	};
+
+	wkb_read_geometry(&reader, &polygons, false);
+
+	*num = polygons.num;
+	return polygons.polygons;
+}
+
+LatLng *
+wkb_to_latlngs(const bytea *wkb, int *num)
+{
+	WkbReader	reader = {
+		.data = (const uint8 *) VARDATA_ANY(wkb),
+		.end = (const uint8 *) VARDATA_ANY(wkb) + VARSIZE_ANY_EXHDR(wkb),
+		.swap = false
+	};
+	int			dimensions;
+	uint32		type = wkb_read_header(&reader, &dimensions);
+	bool		multi = (type == WKB_MULTIPOINT_TYPE);
+	uint32		numPoints = 1;
+	LatLng	   *latlngs;
+
+	ASSERT(type == WKB_POINT_TYPE || multi, ERRCODE_INVALID_PARAMETER_VALUE,
+		   "Only points and multipoints can be indexed (got WKB type %d)", type);
+
+	if (multi)
+	{
+		numPoints = wkb_read_int(&reader);
+		/* each point takes at least its header and two coordinates */
+		ASSERT((reader.end - reader.data) / (WKB_BYTE_SIZE + WKB_INT_SIZE + 2 * WKB_DOUBLE_SIZE) >= numPoints,
+			   ERRCODE_INVALID_BINARY_REPRESENTATION, "WKB ends unexpectedly");
+	}
+
+	latlngs = palloc(Max(numPoints, 1) * sizeof(LatLng));
+	*num = 0;
+
+	for (uint32 i = 0; i < numPoints; i++)
+	{
+		double		x;
+		double		y;
+
+		if (multi)
+			ASSERT(wkb_read_header(&reader, &dimensions) == WKB_POINT_TYPE,
+				   ERRCODE_INVALID_BINARY_REPRESENTATION, "Multipoint members must be points");
+
+		wkb_read(&reader, &x, sizeof(x));
+		wkb_read(&reader, &y, sizeof(y));
+		/* skip z and m */
+		reader.data += (dimensions - 2) * WKB_DOUBLE_SIZE;
+
+		/* empty points have no coordinates */
+		if (isnan(x) && isnan(y))
+			continue;
+
+		latlngs[*num].lng = x;
+		latlngs[*num].lat = y;
+		(*num)++;
+	}
+
+	return latlngs;
+}
+
 bool
 boundary_is_empty(const CellBoundary * boundary)
 {
@@ -190,49 +502,31 @@ boundary_data_size(const CellBoundary * boundary)
 	return size;
 }
 
+/* Sized from the offset tables, without visiting points */
 size_t
-linked_geo_polygon_data_size(const LinkedGeoPolygon * multiPolygon)
+flat_geo_polygon_data_size(const FlatGeoPolygon * geo)
 {
 	size_t		size = 0;
-	int			isMulti = (multiPolygon->next != NULL);
+	int			isMulti = (geo->numPolygons > 1);
 
 	/* byte order + type + srid */
 	size = WKB_BYTE_SIZE + WKB_INT_SIZE * 2;
 
 	if (isMulti)
 	{
-		/* # of polygons */
+		/* # of polygons, then byte order + type + srid of each */
 		size += WKB_INT_SIZE;
+		size += (size_t) geo->numPolygons * (WKB_BYTE_SIZE + WKB_INT_SIZE * 2);
 	}
 
-	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
-	{
-		if (isMulti)
-		{
-			/* byte order + type + srid  */
-			size += WKB_BYTE_SIZE + WKB_INT_SIZE * 2;
-		}
-
-		/* # of rings */
-		size += WKB_INT_SIZE;
-
-		FOREACH_LINKED_LOOP(polygon, loop)
-		{
-			size += linked_geo_loop_data_size(loop);
-		}
-	}
-
-	return size;
-}
+	/* # of rings */
+	size += (size_t) geo->numPolygons * WKB_INT_SIZE;
 
-size_t
-linked_geo_loop_data_size(const LinkedGeoLoop * loop)
-{
-	/* ring size */
-	size_t		size = WKB_INT_SIZE;
+	/* ring sizes */
+	size += (size_t) geo->numRings * WKB_INT_SIZE;
 
-	/* point data (including closing point) */
-	size += WKB_DOUBLE_SIZE * (count_linked_lat_lng(loop) + 1) * 2;
+	/* point data (including closing points) */
+	size += (size_t) (geo->numPoints + geo->numRings) * WKB_DOUBLE_SIZE * 2;
 
 	return size;
 }
@@ -280,9 +574,9 @@ wkb_write_boundary_data(uint8 *data, const CellBoundary * boundary)
 }
 
 uint8 *
-wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPolygon)
+wkb_write_flat_geo_polygon_data(uint8 *data, const FlatGeoPolygon * geo)
 {
-	int			isMulti = (multiPolygon->next != NULL);
+	int			isMulti = (geo->numPolygons > 1);
 	int			type = isMulti ? WKB_MULTIPOLYGON_TYPE : WKB_POLYGON_TYPE;
 
 	/* byte order */
@@ -295,11 +589,14 @@ wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPol
 	if (isMulti)
 	{
 		/* # of polygons */
-		data = wkb_write_int(data, count_linked_polygons(multiPolygon));
+		data = wkb_write_int(data, geo->numPolygons);
 	}
 
-	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	for (int i = 0; i < geo->numPolygons; i++)
 	{
+		int			firstRing = FLAT_POLYGON_FIRST_RING(geo, i);
+		int			numRings = FLAT_POLYGON_SIZE(geo, i);
+
 		if (isMulti)
 		{
 			/* byte order */
@@ -311,12 +608,13 @@ wkb_write_linked_geo_polygon_data(uint8 *data, const LinkedGeoPolygon * multiPol
 		}
 
 		/* # of rings */
-		data = wkb_write_int(data, count_linked_geo_loops(polygon));
+		data = wkb_write_int(data, numRings);
 
 		/* rings */
-		FOREACH_LINKED_LOOP(polygon, loop)
+		for (int ring = firstRing; ring < firstRing + numRings; ring++)
 		{
-			data = wkb_write_linked_geo_loop_data(data, loop);
+			data = wkb_write_flat_ring_data(data, FLAT_RING_POINTS(geo, ring),
+											FLAT_RING_SIZE(geo, ring));
 		}
 	}
 
@@ -332,18 +630,15 @@ wkb_write_lat_lng_array(uint8 *data, const LatLng * coords, int num)
 }
 
 uint8 *
-wkb_write_linked_geo_loop_data(uint8 *data, const LinkedGeoLoop * loop)
+wkb_write_flat_ring_data(uint8 *data, const FlatPoint * points, int num)
 {
 	/* # of points (including closing point) */
-	data = wkb_write_int(data, count_linked_lat_lng(loop) + 1);
+	data = wkb_write_int(data, num + 1);
 
-	/* point data */
-	FOREACH_LINKED_LAT_LNG(loop, latlng)
-	{
-		data = wkb_write_lat_lng(data, &latlng->vertex);
-	}
+	/* point data, already in WKB order */
+	data = wkb_write(data, points, num * sizeof(FlatPoint));
 	/* closing point data */
-	data = wkb_write_lat_lng(data, &loop->first->vertex);
+	data = wkb_write(data, &points[0], sizeof(FlatPoint));
 
 	return data;
 }
@@ -360,9 +655,7 @@ uint8 *
 wkb_write_endian(uint8 *data)
 {
 	/* Always use native order */
-	uint32		order = 0x00000001;
-
-	data[0] = ((uint8 *) &order)[0] ? WKB_NDR : WKB_XDR;
+	data[0] = wkb_native_order();
 	return data + 1;
 }
 
@@ -378,3 +671,11 @@ wkb_write(uint8 *data, const void *value, size_t size)
 	memcpy(data, value, size);
 	return data + size;
 }
+
+uint8
+wkb_native_order(void)
+{
+	uint32		order = 0x00000001;
+
+	return ((uint8 *) &order)[0] ? WKB_NDR : WKB_XDR;
+}
@@ -26,6 +26,8 @@
 #include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
 #endif
 
+#include "wkb_flat_geo.h"
+
 bytea *
 			boundary_array_to_wkb(const CellBoundary * boundaries, size_t num);
 
@@ -33,6 +35,16 @@ bytea *
 			boundary_to_wkb(const CellBoundary * boundary);
 
 bytea *
-			linked_geo_polygon_to_wkb(const LinkedGeoPolygon * multiPolygon);
+			flat_geo_polygon_to_wkb(const FlatGeoPolygon * geo);
+
+/* Outlines cells as a multi polygon, split by the 180th meridian */
+bytea *
+			cells_to_multi_polygon_wkb(const H3Index * cells, int numCells);
+
+/* Polygons of WKB or EWKB, in radians, looking into multipolygons and collections */
+GeoPolygon *wkb_to_polygons(const bytea *wkb, int *num);
+
+/* Non-empty points of WKB or EWKB, in degrees, looking into multipoints */
+LatLng	   *wkb_to_latlngs(const bytea *wkb, int *num);
 
 #endif
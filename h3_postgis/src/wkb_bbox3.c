@@ -18,7 +18,6 @@
 #include <string.h>
 
 #include "wkb_bbox3.h"
-#include "wkb_linked_geo.h"
 
 typedef struct
 {
@@ -61,21 +60,24 @@ bbox3_merge(const Bbox3 * other, Bbox3 * bbox)
 }
 
 void
-bbox3_from_linked_loop(const LinkedGeoLoop * loop, Bbox3 * bbox)
+bbox3_from_flat_ring(const FlatPoint * ring, int numPoints, Bbox3 * bbox)
 {
 	Vect3		vect,
 				nextVect;
+	LatLng		coord;
 
-	vect3_from_lat_lng(&loop->first->vertex, &vect);
+	flat_point_to_lat_lng(&ring[0], &coord);
+	vect3_from_lat_lng(&coord, &vect);
 	bbox3_from_vect3(&vect, bbox);
-	if (!loop->first->next)
+	if (numPoints < 2)
 		return;
 
-	FOREACH_LINKED_LAT_LNG_PAIR(loop, cur, next)
+	for (int i = 0; i < numPoints; i++)
 	{
 		Bbox3		segmentBbox;
 
-		vect3_from_lat_lng(&next->vertex, &nextVect);
+		flat_point_to_lat_lng(&ring[(i + 1) % numPoints], &coord);
+		vect3_from_lat_lng(&coord, &nextVect);
 
 		if (!vect3_eq(&vect, &nextVect))
 		{
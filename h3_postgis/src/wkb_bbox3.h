@@ -19,6 +19,7 @@
 
 #include <h3api.h>
 
+#include "wkb_flat_geo.h"
 #include "wkb_vect3.h"
 
 typedef struct
@@ -38,7 +39,7 @@ void
 			bbox3_merge(const Bbox3 * other, Bbox3 * bbox);
 
 void
-			bbox3_from_linked_loop(const LinkedGeoLoop * loop, Bbox3 * bbox);
+			bbox3_from_flat_ring(const FlatPoint * ring, int numPoints, Bbox3 * bbox);
 
 int
 			bbox3_contains_vect3(const Bbox3 * bbox, const Vect3 * vect);
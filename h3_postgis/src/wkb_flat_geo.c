@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <postgres.h>
+
+#include <string.h>
+
+#include "wkb_flat_geo.h"
+#include "wkb_linked_geo.h"
+
+static void
+			flat_geo_reserve_points(FlatGeoPolygon * geo, int num);
+
+void
+flat_geo_init(FlatGeoPolygon * geo, int maxPoints, int maxRings, int maxPolygons)
+{
+	geo->maxPoints = Max(maxPoints, 1);
+	geo->maxRings = Max(maxRings, 1);
+	geo->maxPolygons = Max(maxPolygons, 1);
+
+	geo->points = palloc(geo->maxPoints * sizeof(FlatPoint));
+	geo->ringOffsets = palloc((geo->maxRings + 1) * sizeof(int));
+	geo->polygonOffsets = palloc((geo->maxPolygons + 1) * sizeof(int));
+
+	geo->numPoints = 0;
+	geo->numRings = 0;
+	geo->numPolygons = 0;
+	geo->ringOffsets[0] = 0;
+	geo->polygonOffsets[0] = 0;
+}
+
+void
+flat_geo_free(FlatGeoPolygon * geo)
+{
+	pfree(geo->points);
+	pfree(geo->ringOffsets);
+	pfree(geo->polygonOffsets);
+}
+
+void
+flat_geo_from_linked(const LinkedGeoPolygon * multiPolygon, FlatGeoPolygon * geo)
+{
+	flat_geo_init(geo, 1024, 16, 16);
+
+	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	{
+		FOREACH_LINKED_LOOP(polygon, loop)
+		{
+			FOREACH_LINKED_LAT_LNG(loop, latlng)
+			{
+				flat_geo_reserve_points(geo, 1);
+				geo->points[geo->numPoints].x = latlng->vertex.lng;
+				geo->points[geo->numPoints].y = latlng->vertex.lat;
+				geo->numPoints++;
+			}
+			flat_geo_end_ring(geo);
+		}
+		flat_geo_end_polygon(geo);
+	}
+}
+
+void
+flat_geo_add_point(FlatGeoPolygon * geo, const FlatPoint * point)
+{
+	/* Does new point exactly match the last one? */
+	if (geo->numPoints > geo->ringOffsets[geo->numRings])
+	{
+		const FlatPoint *last = &geo->points[geo->numPoints - 1];
+
+		if (last->x == point->x && last->y == point->y)
+			return;
+	}
+
+	flat_geo_reserve_points(geo, 1);
+	geo->points[geo->numPoints++] = *point;
+}
+
+void
+flat_geo_add_points(FlatGeoPolygon * geo, const FlatPoint * points, int num)
+{
+	flat_geo_reserve_points(geo, num);
+	memcpy(&geo->points[geo->numPoints], points, num * sizeof(FlatPoint));
+	geo->numPoints += num;
+}
+
+void
+flat_geo_end_ring(FlatGeoPolygon * geo)
+{
+	if (geo->numRings == geo->maxRings)
+	{
+		geo->maxRings *= 2;
+		geo->ringOffsets = repalloc(geo->ringOffsets, (geo->maxRings + 1) * sizeof(int));
+	}
+	geo->ringOffsets[++geo->numRings] = geo->numPoints;
+}
+
+void
+flat_geo_end_polygon(FlatGeoPolygon * geo)
+{
+	if (geo->numPolygons == geo->maxPolygons)
+	{
+		geo->maxPolygons *= 2;
+		geo->polygonOffsets = repalloc(geo->polygonOffsets, (geo->maxPolygons + 1) * sizeof(int));
+	}
+	geo->polygonOffsets[++geo->numPolygons] = geo->numRings;
+}
+
+void
+flat_geo_add_polygon(FlatGeoPolygon * geo, const FlatGeoPolygon * other, int polygon)
+{
+	int			firstRing = FLAT_POLYGON_FIRST_RING(other, polygon);
+	int			numRings = FLAT_POLYGON_SIZE(other, polygon);
+	int			start = other->ringOffsets[firstRing];
+	int			offset = geo->numPoints - start;
+
+	/* rings of a polygon are contiguous, so are their points */
+	flat_geo_add_points(geo, &other->points[start],
+						other->ringOffsets[firstRing + numRings] - start);
+
+	for (int i = 0; i < numRings; i++)
+	{
+		flat_geo_end_ring(geo);
+		geo->ringOffsets[geo->numRings] = other->ringOffsets[firstRing + i + 1] + offset;
+	}
+	flat_geo_end_polygon(geo);
+}
+
+void
+flat_geo_to_degs(FlatGeoPolygon * geo)
+{
+	for (int i = 0; i < geo->numPoints; i++)
+	{
+		geo->points[i].x = radsToDegs(geo->points[i].x);
+		geo->points[i].y = radsToDegs(geo->points[i].y);
+	}
+}
+
+void
+flat_point_to_lat_lng(const FlatPoint * point, LatLng * coord)
+{
+	coord->lat = point->y;
+	coord->lng = point->x;
+}
+
+/* Makes room for num more points, at least doubling */
+void
+flat_geo_reserve_points(FlatGeoPolygon * geo, int num)
+{
+	if (geo->numPoints + num <= geo->maxPoints)
+		return;
+
+	geo->maxPoints = Max(geo->maxPoints * 2, geo->numPoints + num);
+	geo->points = repalloc_huge(geo->points, (Size) geo->maxPoints * sizeof(FlatPoint));
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PGH3_WKB_FLAT_GEO_H
+#define PGH3_WKB_FLAT_GEO_H
+
+#include <h3api.h>
+
+/* Vertex in WKB order */
+typedef struct
+{
+	double		x;				/* longitude */
+	double		y;				/* latitude */
+}	FlatPoint;
+
+/*
+ * Multi polygon in contiguous arrays: the points of every ring one after
+ * another (without closing points), the offset of the first point of each
+ * ring, and of the first ring of each polygon. Offset tables end with the
+ * totals, so ring i spans points ringOffsets[i] up to ringOffsets[i + 1].
+ */
+typedef struct
+{
+	FlatPoint  *points;
+	int			numPoints;
+	int			maxPoints;
+	int		   *ringOffsets;
+	int			numRings;
+	int			maxRings;
+	int		   *polygonOffsets;
+	int			numPolygons;
+	int			maxPolygons;
+}	FlatGeoPolygon;
+
+#define FLAT_RING_POINTS(geo, ring) (&(geo)->points[(geo)->ringOffsets[ring]])
+#define FLAT_RING_SIZE(geo, ring) \
+	((geo)->ringOffsets[(ring) + 1] - (geo)->ringOffsets[ring])
+
+#define FLAT_POLYGON_FIRST_RING(geo, polygon) ((geo)->polygonOffsets[polygon])
+#define FLAT_POLYGON_SIZE(geo, polygon) \
+	((geo)->polygonOffsets[(polygon) + 1] - (geo)->polygonOffsets[polygon])
+
+void
+			flat_geo_init(FlatGeoPolygon * geo, int maxPoints, int maxRings, int maxPolygons);
+
+void
+			flat_geo_free(FlatGeoPolygon * geo);
+
+/* Copies a core multi polygon, walking its lists once */
+void
+			flat_geo_from_linked(const LinkedGeoPolygon * multiPolygon, FlatGeoPolygon * geo);
+
+/* Adds a point to the current ring, unless it repeats the last one */
+void
+			flat_geo_add_point(FlatGeoPolygon * geo, const FlatPoint * point);
+
+/* Adds a run of points to the current ring */
+void
+			flat_geo_add_points(FlatGeoPolygon * geo, const FlatPoint * points, int num);
+
+void
+			flat_geo_end_ring(FlatGeoPolygon * geo);
+
+void
+			flat_geo_end_polygon(FlatGeoPolygon * geo);
+
+/* Copies a whole polygon of another multi polygon */
+void
+			flat_geo_add_polygon(FlatGeoPolygon * geo, const FlatGeoPolygon * other, int polygon);
+
+/* Converts coordinates from radians to degrees in place */
+void
+			flat_geo_to_degs(FlatGeoPolygon * geo);
+
+void
+			flat_point_to_lat_lng(const FlatPoint * point, LatLng * coord);
+
+#endif
@@ -19,10 +19,17 @@
 
 #include <fmgr.h>  // PG_FUNCTION_ARGS
 #include <math.h>
+#include <utils/array.h> // using arrays
+#include <utils/builtins.h>	 // parse_bool
+#include <utils/guc.h>		 // GetConfigOption
+#include <utils/lsyscache.h> // get_typlenbyvalalign
 
 #include "constants.h"
 #include "error.h"
+#include "gserialized.h"
+#include "stat.h"
 #include "type.h"
+#include "wkb_indexing.h"
 #include "wkb_split.h"
 #include "wkb_vect3.h"
 #include "wkb.h"
@@ -38,6 +45,10 @@
 		message)
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_boundary_wkb);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_boundary_geometry);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cell_to_boundary_geography);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_boundaries_geometry);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_point_wkb_to_cells);
 
 /* Converts CellBoundary coordinates to degrees in place */
 static void
@@ -60,49 +71,276 @@ static void
 static void
 			boundary_split_180_polar(const CellBoundary * boundary, CellBoundary * res);
 
-/* Finds the boundary of the index, converts to EWKB, splits the boundary by 180 meridian */
-Datum
-h3_cell_to_boundary_wkb(PG_FUNCTION_ARGS)
-{
-	H3Index		cell = PG_GETARG_H3INDEX(0);
+/* Appends the boundary of the cell in degrees, split by 180 meridian */
+static void
+			flat_geo_add_cell_boundary(FlatGeoPolygon * geo, H3Index cell);
 
-	bytea	   *wkb;
+/* Box of the great circle arcs between vertices of a boundary in radians */
+static void
+			bbox3_from_boundary(const CellBoundary * boundary, Bbox3 * bbox);
+
+int
+cell_to_boundary_parts(H3Index cell, CellBoundary * parts, bool *polar)
+{
 	CellBoundary boundary;
 	int			crossNum;
 
 	h3_assert(cellToBoundary(cell, &boundary));
 
 	crossNum = boundary_crosses_180_num(&boundary);
+	*polar = (crossNum == 1);
 	if (crossNum == 0)
 	{
 		/* Cell is not crossed by antimeridian */
-		boundary_to_degs(&boundary);
-		wkb = boundary_to_wkb(&boundary);
+		parts[0] = boundary;
+		return 1;
 	}
 	else if (crossNum == 1)
 	{
 		/* Cell boundary is crossed by antimeridian once */
-		CellBoundary split;
-
-		boundary_split_180_polar(&boundary, &split);
-		boundary_to_degs(&split);
-		wkb = boundary_to_wkb(&split);
+		boundary_split_180_polar(&boundary, &parts[0]);
+		return 1;
 	}
 	else
 	{
 		/* Crossed by antimeridian */
-		CellBoundary parts[2];
-
 		boundary_split_180(&boundary, &parts[0], &parts[1]);
-
-		boundary_to_degs(&parts[0]);
-		boundary_to_degs(&parts[1]);
-		wkb = boundary_array_to_wkb(parts, 2);
+		return 2;
 	}
+}
+
+/* Finds the boundary of the index, converts to EWKB, splits the boundary by 180 meridian */
+static Datum
+h3_cell_to_boundary_wkb_internal(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+
+	bytea	   *wkb;
+	CellBoundary parts[2];
+	bool		polar;
+	int			num = cell_to_boundary_parts(cell, parts, &polar);
+
+	for (int i = 0; i < num; i++)
+		boundary_to_degs(&parts[i]);
+
+	if (num == 1)
+		wkb = boundary_to_wkb(&parts[0]);
+	else
+		wkb = boundary_array_to_wkb(parts, num);
 
 	PG_RETURN_BYTEA_P(wkb);
 }
 
+Datum
+h3_cell_to_boundary_wkb(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_WKB, h3_cell_to_boundary_wkb_internal, fcinfo);
+}
+
+/* Finds the boundary of the index as a geometry, split by 180 meridian */
+static Datum
+h3_cell_to_boundary_geometry_internal(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+	CellBoundary parts[2];
+	bool		polar;
+	int			num = cell_to_boundary_parts(cell, parts, &polar);
+
+	for (int i = 0; i < num; i++)
+		boundary_to_degs(&parts[i]);
+
+	PG_RETURN_POINTER(boundary_array_to_gserialized(parts, num, NULL));
+}
+
+Datum
+h3_cell_to_boundary_geometry(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_WKB, h3_cell_to_boundary_geometry_internal, fcinfo);
+}
+
+/*
+ * Finds the boundary of the index as a geography, split by 180 meridian.
+ * The box covers the great circle arcs between vertices, and the pole of
+ * polar cells.
+ */
+static Datum
+h3_cell_to_boundary_geography_internal(PG_FUNCTION_ARGS)
+{
+	H3Index		cell = PG_GETARG_H3INDEX(0);
+	CellBoundary parts[2];
+	bool		polar;
+	int			num = cell_to_boundary_parts(cell, parts, &polar);
+	Bbox3		bbox;
+
+	bbox3_from_boundary(&parts[0], &bbox);
+	for (int i = 1; i < num; i++)
+	{
+		Bbox3		partBbox;
+
+		bbox3_from_boundary(&parts[i], &partBbox);
+		bbox3_merge(&partBbox, &bbox);
+	}
+
+	if (polar)
+	{
+		LatLng		pole = {.lat = (parts[0].verts[0].lat > 0) ? M_PI_2 : -M_PI_2,.lng = 0};
+		Bbox3		poleBbox;
+		Vect3		vect;
+
+		vect3_from_lat_lng(&pole, &vect);
+		bbox3_from_vect3(&vect, &poleBbox);
+		bbox3_merge(&poleBbox, &bbox);
+	}
+
+	for (int i = 0; i < num; i++)
+		boundary_to_degs(&parts[i]);
+
+	PG_RETURN_POINTER(boundary_array_to_gserialized(parts, num, &bbox));
+}
+
+Datum
+h3_cell_to_boundary_geography(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_WKB, h3_cell_to_boundary_geography_internal, fcinfo);
+}
+
+/*
+ * Finds the boundaries of the indexes as a single geometry collection, one
+ * polygon per cell in the order of the array, two for cells split by 180
+ * meridian. Neighbours share edges, which a multi polygon may not. Each
+ * boundary is found in the same buffer and appended to one array of
+ * points, which is serialized once.
+ */
+static Datum
+h3_cells_to_boundaries_geometry_internal(PG_FUNCTION_ARGS)
+{
+	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
+	int			numCells = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+	ArrayIterator iterator;
+	Datum		value;
+	bool		isnull;
+	FlatGeoPolygon geo;
+	struct varlena *gserialized;
+
+	/* hexagons have 6 vertices, more are reserved as needed */
+	flat_geo_init(&geo, numCells * 6, numCells, numCells);
+
+	iterator = array_create_iterator(array, 0, NULL);
+	while (array_iterate(iterator, &value, &isnull))
+	{
+		if (!isnull)
+			flat_geo_add_cell_boundary(&geo, DatumGetH3Index(value));
+	}
+	array_free_iterator(iterator);
+
+	gserialized = flat_geo_to_gserialized(&geo);
+	flat_geo_free(&geo);
+	PG_RETURN_POINTER(gserialized);
+}
+
+Datum
+h3_cells_to_boundaries_geometry(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_WKB, h3_cells_to_boundaries_geometry_internal, fcinfo);
+}
+
+/*
+ * Indexes the points of WKB at the specified resolution, reading their
+ * coordinates directly rather than dumping them in SQL. Locations are
+ * checked like h3_latlng_to_cell does when h3.strict is set.
+ */
+Datum
+h3_point_wkb_to_cells(PG_FUNCTION_ARGS)
+{
+	bytea	   *wkb = PG_GETARG_BYTEA_PP(0);
+	int			resolution = PG_GETARG_INT32(1);
+	Oid			elmtype = get_element_type(get_fn_expr_rettype(fcinfo->flinfo));
+	const char *strict = GetConfigOption("h3.strict", true, false);
+	bool		checked = false;
+	int16		elmlen;
+	bool		elmbyval;
+	char		elmalign;
+	int			num;
+	LatLng	   *locations = wkb_to_latlngs(wkb, &num);
+	Datum	   *cells = palloc(Max(num, 1) * sizeof(Datum));
+	H3Index		cell;
+
+	if (strict != NULL && parse_bool(strict, &checked) && checked)
+	{
+		for (int i = 0; i < num; i++)
+		{
+			ASSERT(
+				   locations[i].lng >= -180 && locations[i].lng <= 180,
+				   ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE,
+				   "Longitude must be between -180 and 180 degrees inclusive, but got %f.",
+				   locations[i].lng
+				);
+			ASSERT(
+				   locations[i].lat >= -90 && locations[i].lat <= 90,
+				   ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE,
+				   "Latitude must be between -90 and 90 degrees inclusive, but got %f.",
+				   locations[i].lat
+				);
+		}
+	}
+
+	for (int i = 0; i < num; i++)
+	{
+		locations[i].lng = degsToRads(locations[i].lng);
+		locations[i].lat = degsToRads(locations[i].lat);
+	}
+
+	for (int i = 0; i < num; i++)
+	{
+		h3_assert(latLngToCell(&locations[i], resolution, &cell));
+		cells[i] = H3IndexGetDatum(cell);
+	}
+
+	get_typlenbyvalalign(elmtype, &elmlen, &elmbyval, &elmalign);
+	PG_RETURN_ARRAYTYPE_P(construct_array(cells, num, elmtype, elmlen, elmbyval, elmalign));
+}
+
+void
+flat_geo_add_cell_boundary(FlatGeoPolygon * geo, H3Index cell)
+{
+	CellBoundary parts[2];
+	bool		polar;
+	int			num = cell_to_boundary_parts(cell, parts, &polar);
+
+	for (int i = 0; i < num; i++)
+	{
+		for (int v = 0; v < parts[i].numVerts; v++)
+		{
+			FlatPoint	point = {
+				.x = radsToDegs(parts[i].verts[v].lng),
+				.y = radsToDegs(parts[i].verts[v].lat)
+			};
+
+			flat_geo_add_point(geo, &point);
+		}
+		flat_geo_end_ring(geo);
+		flat_geo_end_polygon(geo);
+	}
+}
+
+void
+bbox3_from_boundary(const CellBoundary * boundary, Bbox3 * bbox)
+{
+	const int	numVerts = boundary->numVerts;
+
+	bbox3_from_segment_lat_lng(&boundary->verts[0],
+							   &boundary->verts[1 % numVerts], bbox);
+	for (int v = 1; v < numVerts; v++)
+	{
+		Bbox3		segmentBbox;
+
+		bbox3_from_segment_lat_lng(&boundary->verts[v],
+								   &boundary->verts[(v + 1) % numVerts],
+								   &segmentBbox);
+		bbox3_merge(&segmentBbox, bbox);
+	}
+}
+
 void
 boundary_to_degs(CellBoundary * boundary)
 {
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PGH3_WKB_INDEXING_H
+#define PGH3_WKB_INDEXING_H
+
+#include <h3api.h>
+
+#include <stdbool.h>
+
+/*
+ * Finds the boundary of the cell in radians, split by the 180 meridian into
+ * as many parts as returned. Sets polar if the cell contains a pole.
+ */
+int
+			cell_to_boundary_parts(H3Index cell, CellBoundary * parts, bool *polar);
+
+#endif
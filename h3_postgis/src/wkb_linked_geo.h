@@ -48,31 +48,4 @@
 		 cur != NULL;													\
 		 cur = cur->next, next = next->next ? next->next : loop->first)
 
-int
-			count_linked_polygons(const LinkedGeoPolygon * multiPolygon);
-
-int
-			count_linked_geo_loops(const LinkedGeoPolygon * polygon);
-
-int
-			count_linked_lat_lng(const LinkedGeoLoop * loop);
-
-LinkedGeoPolygon *
-			copy_linked_geo_polygon(const LinkedGeoPolygon * polygon);
-
-LinkedGeoLoop *
-			copy_linked_geo_loop(const LinkedGeoLoop * loop);
-
-LinkedLatLng *
-			copy_linked_lat_lng(const LinkedLatLng * latlng);
-
-void
-			add_linked_geo_loop(LinkedGeoPolygon * polygon, LinkedGeoLoop * loop);
-
-void
-			add_linked_lat_lng(LinkedGeoLoop * loop, LinkedLatLng * latlng);
-
-void
-			free_linked_geo_polygon(LinkedGeoPolygon * multiPolygon);
-
 #endif
@@ -15,35 +15,59 @@
  */
 
 #include <postgres.h>
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
 #include <h3api.h>
 
-#include <fmgr.h>		 // PG_FUNCTION_ARGS
-#include <utils/array.h> // using arrays
+#include <fmgr.h>				 // PG_FUNCTION_ARGS
+#include <funcapi.h>			 // SRF_IS_FIRSTCALL
+#include <catalog/pg_type.h>	 // BYTEAOID
+#include <parser/parse_coerce.h> // find_coercion_pathway
+#include <utils/array.h>		 // using arrays
+#include <utils/builtins.h>		 // text_to_cstring
+#include <utils/guc.h>			 // GetConfigOption
 
+#include "cell_buffer.h"
 #include "error.h"
+#include "iterator.h"
+#include "stat.h"
 #include "type.h"
-#include "wkb_linked_geo.h"
-#include "wkb_split.h"
 #include "wkb.h"
 
 PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_wkb);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_agg_transfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_agg_combinefn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_agg_serialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_agg_deserialfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_cells_to_multi_polygon_agg_finalfn);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_wkb_to_cells);
+PGDLLEXPORT PG_FUNCTION_INFO_V1(h3_polygon_wkb_to_cells_experimental);
 
-/* Converts LinkedGeoPolygon vertex coordinates to degrees in place */
-static void
-			linked_geo_polygon_to_degs(LinkedGeoPolygon * multiPolygon);
+/* Fill of the polygons of a geometry, one polygon after another */
+typedef struct
+{
+	GeoPolygon *polygons;
+	int			numPolygons;
+	int			polygon;		/* polygon being filled */
+	int			resolution;
+	uint32_t	flags;
+	bool		experimental;
+	int64		chunkSize;
+	H3PolygonIterator iterator;
+}	H3PolygonWkbState;
 
-Datum
-h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
+static Datum
+h3_cells_to_multi_polygon_wkb_internal(PG_FUNCTION_ARGS)
 {
 	ArrayType  *array = PG_GETARG_ARRAYTYPE_P(0);
-	LinkedGeoPolygon *linkedPolygon;
-	H3Error		error;
 	int			numHexes;
 	ArrayIterator iterator;
 	Datum		value;
 	bool		isnull;
 	H3Index    *h3set;
-	bytea	   *wkb;
 
 	numHexes = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
 	h3set = palloc(numHexes * sizeof(H3Index));
@@ -57,45 +81,277 @@ h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
 		h3set[numHexes++] = DatumGetH3Index(value);
 	}
 
-	/* produce hexagons into allocated memory */
-	linkedPolygon = palloc(sizeof(LinkedGeoPolygon));
-	h3_assert(cellsToLinkedMultiPolygon(h3set, numHexes, linkedPolygon));
+	PG_RETURN_BYTEA_P(cells_to_multi_polygon_wkb(h3set, numHexes));
+}
 
-	if (is_linked_polygon_crossed_by_180(linkedPolygon))
+Datum
+h3_cells_to_multi_polygon_wkb(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_DISSOLVE, h3_cells_to_multi_polygon_wkb_internal, fcinfo);
+}
+
+static int
+cell_set_cmp(const void *a, const void *b)
+{
+	H3Index		x = *(const H3Index *) a;
+	H3Index		y = *(const H3Index *) b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Sorts and removes duplicate cells, reducing the transition state of the
+ * multi polygon aggregates
+ */
+static int64
+cell_set_dedupe(H3Index * cells, int64 count)
+{
+	int64		n = 0;
+
+	qsort(cells, count, sizeof(H3Index), cell_set_cmp);
+	for (int64 i = 0; i < count; i++)
+		if (n == 0 || cells[n - 1] != cells[i])
+			cells[n++] = cells[i];
+	return n;
+}
+
+static Datum
+h3_cells_to_multi_polygon_agg_transfn_internal(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	H3CellBuffer *state = PG_ARGISNULL(0) ? NULL : (H3CellBuffer *) PG_GETARG_POINTER(0);
+	H3Index		cell;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "h3_cells_to_multi_polygon_agg_transfn called in non-aggregate context");
+
+	if (PG_ARGISNULL(1))
 	{
-		/* Split by 180th meridian */
-		LinkedGeoPolygon *splitPolygon = split_linked_polygon_by_180(linkedPolygon);
+		if (state == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state);
+	}
 
-		linked_geo_polygon_to_degs(splitPolygon);
-		wkb = linked_geo_polygon_to_wkb(splitPolygon);
-		free_linked_geo_polygon(splitPolygon);
+	cell = PG_GETARG_H3INDEX(1);
+	if (state == NULL)
+		state = cell_buffer_create(aggcontext, 0, cell_set_dedupe);
+
+	cell_buffer_append(state, &cell, 1);
+
+	PG_RETURN_POINTER(state);
+}
+
+Datum
+h3_cells_to_multi_polygon_agg_transfn(PG_FUNCTION_ARGS)
+{
+	return stat_time(H3_STAT_DISSOLVE, h3_cells_to_multi_polygon_agg_transfn_internal, fcinfo);
+}
+
+/* Appends the cells of the second state to the first */
+static Datum
+h3_cells_to_multi_polygon_agg_combinefn_internal(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	H3CellBuffer *state1 = PG_ARGISNULL(0) ? NULL : (H3CellBuffer *) PG_GETARG_POINTER(0);
+	H3CellBuffer *state2 = PG_ARGISNULL(1) ? NULL : (H3CellBuffer *) PG_GETARG_POINTER(1);
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "h3_cells_to_multi_polygon_agg_combinefn called in non-aggregate context");
+
+	if (state2 == NULL)
+	{
+		if (state1 == NULL)
+			PG_RETURN_NULL();
+		PG_RETURN_POINTER(state1);
 	}
-	else
+
+	if (state1 == NULL)
+		state1 = cell_buffer_create(aggcontext, state2->count, cell_set_dedupe);
+
+	cell_buffer_append(state1, state2->cells, state2->count);
+
+	PG_RETURN_POINTER(state1);
+}
+
+Datum
+h3_cells_to_multi_polygon_agg_combinefn(PG_FUNCTION_ARGS)
+{
+	return stat_time(H3_STAT_DISSOLVE, h3_cells_to_multi_polygon_agg_combinefn_internal, fcinfo);
+}
+
+/* Serializes the deduplicated cells, so workers only send distinct cells */
+Datum
+h3_cells_to_multi_polygon_agg_serialfn(PG_FUNCTION_ARGS)
+{
+	H3CellBuffer *state = (H3CellBuffer *) PG_GETARG_POINTER(0);
+
+	PG_RETURN_BYTEA_P(cell_buffer_serialize(state));
+}
+
+Datum
+h3_cells_to_multi_polygon_agg_deserialfn(PG_FUNCTION_ARGS)
+{
+	bytea	   *bytes = PG_GETARG_BYTEA_PP(0);
+
+	PG_RETURN_POINTER(cell_buffer_deserialize(bytes, cell_set_dedupe));
+}
+
+/*
+ * Outlines the distinct cells, returning geometry or geography depending on
+ * how the function was declared. The WKB is converted by the cast from
+ * bytea, looked up once per call site.
+ */
+static Datum
+h3_cells_to_multi_polygon_agg_finalfn_internal(PG_FUNCTION_ARGS)
+{
+	H3CellBuffer *state = (H3CellBuffer *) PG_GETARG_POINTER(0);
+	Oid		   *castfunc = fcinfo->flinfo->fn_extra;
+	bytea	   *wkb;
+
+	if (castfunc == NULL)
 	{
-		linked_geo_polygon_to_degs(linkedPolygon);
-		wkb = linked_geo_polygon_to_wkb(linkedPolygon);
+		Oid			rettype = get_fn_expr_rettype(fcinfo->flinfo);
+
+		castfunc = MemoryContextAlloc(fcinfo->flinfo->fn_mcxt, sizeof(Oid));
+		ASSERT(
+			   find_coercion_pathway(rettype, BYTEAOID, COERCION_EXPLICIT, castfunc) == COERCION_PATH_FUNC,
+			   ERRCODE_UNDEFINED_FUNCTION,
+			   "No cast from bytea to the aggregate result type."
+			);
+		fcinfo->flinfo->fn_extra = castfunc;
 	}
 
-	destroyLinkedMultiPolygon(linkedPolygon);
-	pfree(linkedPolygon);
+	/*
+	 * Deduplicating in place does not change the set, but does modify the
+	 * state, hence finalfunc_modify = read_write.
+	 */
+	cell_buffer_reduce(state);
+	ASSERT(
+		   state->count <= INT_MAX,
+		   ERRCODE_PROGRAM_LIMIT_EXCEEDED,
+		   "Cannot outline more than %d distinct cells.",
+		   INT_MAX
+		);
 
-	PG_RETURN_BYTEA_P(wkb);
+	wkb = cells_to_multi_polygon_wkb(state->cells, (int) state->count);
+	PG_RETURN_DATUM(OidFunctionCall1(*castfunc, PointerGetDatum(wkb)));
 }
 
-void
-linked_geo_polygon_to_degs(LinkedGeoPolygon * multiPolygon)
+Datum
+h3_cells_to_multi_polygon_agg_finalfn(PG_FUNCTION_ARGS)
 {
-	FOREACH_LINKED_POLYGON_NOCONST(multiPolygon, polygon)
+	return stat_call(H3_STAT_DISSOLVE, h3_cells_to_multi_polygon_agg_finalfn_internal, fcinfo);
+}
+
+/*
+ * h3.polygon_to_cells_chunk_size of the h3 extension, which owns the
+ * setting. Falls back to its default if h3 has not defined it yet.
+ */
+static int64
+polygon_to_cells_chunk_size(void)
+{
+	const char *value = GetConfigOption("h3.polygon_to_cells_chunk_size", true, false);
+	int			chunkSize;
+
+	if (value == NULL || !parse_int(value, &chunkSize, 0, NULL))
+		return POLYGON_TO_CELLS_CHUNK_SIZE;
+	return chunkSize;
+}
+
+static void
+polygon_wkb_init(FunctionCallInfo fcinfo, uint32_t flags, bool experimental)
+{
+	FuncCallContext *funcctx = SRF_FIRSTCALL_INIT();
+	MemoryContext oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+	bytea	   *wkb = PG_GETARG_BYTEA_PP(0);
+	H3PolygonWkbState *state = palloc(sizeof(H3PolygonWkbState));
+
+	state->polygons = wkb_to_polygons(wkb, &state->numPolygons);
+	state->polygon = -1;
+	state->resolution = PG_GETARG_INT32(1);
+	state->flags = flags;
+	state->experimental = experimental;
+	state->chunkSize = polygon_to_cells_chunk_size();
+
+	funcctx->user_fctx = state;
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * Returns the next cell of the polygons in user fctx, starting on the next
+ * polygon once one is filled.
+ */
+static Datum
+polygon_wkb_next(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx = SRF_PERCALL_SETUP();
+	H3PolygonWkbState *state = funcctx->user_fctx;
+	H3Index		cell;
+
+	while (state->polygon < state->numPolygons)
+	{
+		MemoryContext oldcontext;
+
+		if (state->polygon >= 0 && iterator_polygon_next(&state->iterator, &cell))
+			SRF_RETURN_NEXT(funcctx, H3IndexGetDatum(cell));
+
+		if (++state->polygon == state->numPolygons)
+			break;
+
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+		iterator_polygon_init(&state->iterator, &state->polygons[state->polygon],
+							  state->resolution, state->flags,
+							  state->experimental, state->chunkSize);
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
+static Datum
+h3_polygon_wkb_to_cells_internal(PG_FUNCTION_ARGS)
+{
+	if (SRF_IS_FIRSTCALL())
+		polygon_wkb_init(fcinfo, 0, false);
+
+	return polygon_wkb_next(fcinfo);
+}
+
+/* Fills the polygons of WKB, without first dumping them in SQL */
+Datum
+h3_polygon_wkb_to_cells(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_POLYFILL, h3_polygon_wkb_to_cells_internal, fcinfo);
+}
+
+static Datum
+h3_polygon_wkb_to_cells_experimental_internal(PG_FUNCTION_ARGS)
+{
+	if (SRF_IS_FIRSTCALL())
 	{
-		FOREACH_LINKED_LOOP_NOCONST(polygon, loop)
-		{
-			FOREACH_LINKED_LAT_LNG_NOCONST(loop, latlng)
-			{
-				LatLng	   *vertex = &latlng->vertex;
-
-				vertex->lat = radsToDegs(vertex->lat);
-				vertex->lng = radsToDegs(vertex->lng);
-			}
-		}
+		char	   *containment_mode = text_to_cstring(PG_GETARG_TEXT_PP(2));
+		uint32_t	flags = 0;
+
+		if (strcmp(containment_mode, "center") == 0)
+			flags = 0;
+		else if (strcmp(containment_mode, "full") == 0)
+			flags = 1;
+		else if (strcmp(containment_mode, "overlapping") == 0)
+			flags = 2;
+		else if (strcmp(containment_mode, "overlapping_bbox") == 0)
+			flags = 3;
+		else
+			ASSERT(0, ERRCODE_INVALID_PARAMETER_VALUE, "Containment Mode must be center, full, overlapping, or overlapping_bbox.");
+
+		polygon_wkb_init(fcinfo, flags, true);
 	}
+
+	return polygon_wkb_next(fcinfo);
+}
+
+/* Fills the polygons of WKB using polygonToCellsExperimental */
+Datum
+h3_polygon_wkb_to_cells_experimental(PG_FUNCTION_ARGS)
+{
+	return stat_call(H3_STAT_POLYFILL, h3_polygon_wkb_to_cells_experimental_internal, fcinfo);
 }
@@ -23,7 +23,7 @@
 #include "constants.h"
 #include "wkb_split.h"
 #include "wkb_bbox3.h"
-#include "wkb_linked_geo.h"
+#include "wkb_flat_geo.h"
 
 /*
 
@@ -121,7 +121,7 @@ typedef struct
 
 typedef struct
 {
-	const LatLng *latlngPtr;
+	const FlatPoint *point;		/* NULL once added to a polygon */
 	int			intersectIdx;
 	short		sign;			/* longitude sign is set explicitly in case
 								 * longitude of the vertex itself is zero */
@@ -130,6 +130,9 @@ typedef struct
 
 typedef struct
 {
+	/* Multi polygon being split */
+	const FlatGeoPolygon *geo;
+
 	/* Vertices */
 	int			vertexNum;
 	SplitVertex *vertices;
@@ -140,37 +143,37 @@ typedef struct
 	SplitIntersect *intersects;
 	SplitIntersect **sortedIntersects;
 
-	/* Non-split holes */
+	/* Non-split holes, as rings of geo (-1 once assigned) */
 	int			holeNum;
-	const LinkedGeoLoop **holes;
+	int		   *holes;
 }	Split;
 
 static bool
-			is_polygon_crossed(const LinkedGeoPolygon * polygon);
+			is_polygon_crossed(const FlatGeoPolygon * geo, int polygon);
 
-static LinkedGeoPolygon *
-			split_polygon(const LinkedGeoPolygon * polygon);
+static void
+			split_polygon(const FlatGeoPolygon * geo, int polygon, FlatGeoPolygon * result);
 
 static bool
-			is_ring_crossed(const LinkedGeoLoop * ring);
+			is_ring_crossed(const FlatGeoPolygon * geo, int ring);
 
 static void
-			split_init(Split * split, int ringNum, int vertexNum);
+			split_init(Split * split, const FlatGeoPolygon * geo, int ringNum, int vertexNum);
 
 static void
 			split_cleanup(Split * split);
 
 static void
-			split_process_ring(Split * split, const LinkedGeoLoop * ring);
+			split_process_ring(Split * split, int ring);
 
 static void
 			split_prepare(Split * split);
 
-static LinkedGeoPolygon *
-			split_create_multi_polygon(Split * split);
+static void
+			split_create_multi_polygon(Split * split, FlatGeoPolygon * result);
 
 static int
-			split_add_vertex(Split * split, const LatLng * latlng);
+			split_add_vertex(Split * split, const FlatPoint * point);
 
 static void
 			split_add_intersect_after(Split * split, int vertexIdx, SplitIntersectDir dir, bool isPrime, double lat);
@@ -182,7 +185,7 @@ static void
 			split_link_vertices(Split * split, int idx1, int idx2);
 
 static void
-			split_add_hole(Split * split, const LinkedGeoLoop * hole);
+			split_add_hole(Split * split, int ring);
 
 static
 void		split_sort_intersects(Split * split);
@@ -193,23 +196,20 @@ static int
 static int
 			split_find_next_vertex(Split * split, int *start);
 
-static LinkedGeoPolygon *
-			split_create_polygon_vertex(Split * split, int vertexIdx);
+static void
+			split_create_polygon_vertex(Split * split, int vertexIdx, FlatGeoPolygon * result);
 
 static void
-			split_polygon_assign_holes(Split * split, short sign, LinkedGeoPolygon * polygon);
+			split_polygon_assign_holes(Split * split, short sign, FlatGeoPolygon * result);
 
 static const SplitIntersect *
 			split_get_intersect_after(Split * split, int vertexIdx);
 
 static void
-			split_intersect_get_lat_lng(const SplitIntersect * intersect, short sign, LatLng * latlng);
-
-static int
-			count_polygon_vertices(const LinkedGeoPolygon * polygon, int *ringNum);
+			split_intersect_get_point(const SplitIntersect * intersect, short sign, FlatPoint * point);
 
 static short
-			lat_lng_ring_pos(const LinkedGeoLoop * ring, short sign, const Bbox3 * bbox, const LatLng * latlng);
+			point_ring_pos(const FlatPoint * ring, int numPoints, short sign, const Bbox3 * bbox, const FlatPoint * point);
 
 static short
 			segment_intersect(const Vect3 * v1, const Vect3 * v2, const Vect3 * u1, const Vect3 * u2);
@@ -218,47 +218,34 @@ static short
 			point_segment_pos(const Vect3 * v1, const Vect3 * v2, const Vect3 * p);
 
 static void
-			add_lat_lng(LinkedGeoLoop * loop, const LatLng * latlng);
+			vect3_from_point(const FlatPoint * point, Vect3 * vect);
 
 bool
-is_linked_polygon_crossed_by_180(const LinkedGeoPolygon * multiPolygon)
+is_flat_geo_crossed_by_180(const FlatGeoPolygon * geo)
 {
-	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	for (int i = 0; i < geo->numPolygons; i++)
 	{
-		if (is_polygon_crossed(polygon))
+		if (is_polygon_crossed(geo, i))
 			return true;
 	}
 	return false;
 }
 
-LinkedGeoPolygon *
-split_linked_polygon_by_180(const LinkedGeoPolygon * multiPolygon)
+void
+split_flat_geo_by_180(const FlatGeoPolygon * geo, FlatGeoPolygon * result)
 {
-	LinkedGeoPolygon *result = NULL;
-	LinkedGeoPolygon *last = NULL;
+	/* room for a few split points per ring */
+	flat_geo_init(result, geo->numPoints + 4 * geo->numRings, geo->numRings,
+				  geo->numPolygons * 2);
 
-	FOREACH_LINKED_POLYGON(multiPolygon, polygon)
+	for (int i = 0; i < geo->numPolygons; i++)
 	{
 		/* Split or copy next polygon */
-		LinkedGeoPolygon *nextResult = is_polygon_crossed(polygon)
-		? split_polygon(polygon)
-		: copy_linked_geo_polygon(polygon);
-
-		/* Add to result */
-		if (!result)
-		{
-			result = nextResult;
-			last = nextResult;
-		}
+		if (is_polygon_crossed(geo, i))
+			split_polygon(geo, i, result);
 		else
-		{
-			last->next = nextResult;
-		}
-		while (last->next)
-			last = last->next;
+			flat_geo_add_polygon(result, geo, i);
 	}
-
-	return result;
 }
 
 double
@@ -289,29 +276,28 @@ split_180_lat(const LatLng * coord1, const LatLng * coord2)
 }
 
 bool
-is_polygon_crossed(const LinkedGeoPolygon * polygon)
+is_polygon_crossed(const FlatGeoPolygon * geo, int polygon)
 {
-	return polygon->first
-		? is_ring_crossed(polygon->first)
+	return FLAT_POLYGON_SIZE(geo, polygon) > 0
+		? is_ring_crossed(geo, FLAT_POLYGON_FIRST_RING(geo, polygon))
 		: false;
 }
 
-LinkedGeoPolygon *
-split_polygon(const LinkedGeoPolygon * polygon)
+void
+split_polygon(const FlatGeoPolygon * geo, int polygon, FlatGeoPolygon * result)
 {
-	int			ringNum,
-				vertexNum;
+	int			firstRing = FLAT_POLYGON_FIRST_RING(geo, polygon);
+	int			ringNum = FLAT_POLYGON_SIZE(geo, polygon);
+	int			vertexNum = geo->ringOffsets[firstRing + ringNum] - geo->ringOffsets[firstRing];
 	Split		split;
-	LinkedGeoPolygon *result;
 
 	/* Init data */
-	vertexNum = count_polygon_vertices(polygon, &ringNum);
-	split_init(&split, ringNum, vertexNum);
+	split_init(&split, geo, ringNum, vertexNum);
 
 	/* Process rings */
-	FOREACH_LINKED_LOOP(polygon, ring)
+	for (int ring = firstRing; ring < firstRing + ringNum; ring++)
 	{
-		if (ring == polygon->first || is_ring_crossed(ring))
+		if (ring == firstRing || is_ring_crossed(geo, ring))
 			split_process_ring(&split, ring);
 		else
 			split_add_hole(&split, ring);
@@ -321,24 +307,25 @@ split_polygon(const LinkedGeoPolygon * polygon)
 	split_prepare(&split);
 
 	/* Build result */
-	result = split_create_multi_polygon(&split);
+	split_create_multi_polygon(&split, result);
 
 	/* Cleanup */
 	split_cleanup(&split);
-
-	return result;
 }
 
 bool
-is_ring_crossed(const LinkedGeoLoop * ring)
+is_ring_crossed(const FlatGeoPolygon * geo, int ring)
 {
-	if (!ring->first || !ring->first->next)
+	const FlatPoint *points = FLAT_RING_POINTS(geo, ring);
+	int			numPoints = FLAT_RING_SIZE(geo, ring);
+
+	if (numPoints < 2)
 		return false;
 
-	FOREACH_LINKED_LAT_LNG_PAIR(ring, cur, next)
+	for (int i = 0; i < numPoints; i++)
 	{
-		double		lng = cur->vertex.lng;
-		double		nextLng = next->vertex.lng;
+		double		lng = points[i].x;
+		double		nextLng = points[(i + 1) % numPoints].x;
 
 		if (SIGN(lng) != SIGN(nextLng)
 			&& fabs(lng - nextLng) > M_PI)
@@ -351,20 +338,21 @@ is_ring_crossed(const LinkedGeoLoop * ring)
 
 
 void
-split_init(Split * split, int ringNum, int vertexNum)
+split_init(Split * split, const FlatGeoPolygon * geo, int ringNum, int vertexNum)
 {
 	*split = (Split)
 	{
 		0
 	};
 
+	split->geo = geo;
 	split->vertices = palloc0(vertexNum * sizeof(SplitVertex));
 
 	split->maxIntersectNum = INTERSECT_ARRAY_SIZE_INIT;
 	split->intersects = palloc0(split->maxIntersectNum * sizeof(SplitIntersect));
 
 	if (ringNum > 1)
-		split->holes = palloc0((ringNum - 1) * sizeof(LinkedGeoLoop *));
+		split->holes = palloc0((ringNum - 1) * sizeof(int));
 }
 
 void
@@ -386,27 +374,31 @@ split_cleanup(Split * split)
 }
 
 void
-split_process_ring(Split * split, const LinkedGeoLoop * ring)
+split_process_ring(Split * split, int ring)
 {
+	const FlatPoint *points = FLAT_RING_POINTS(split->geo, ring);
+	int			numPoints = FLAT_RING_SIZE(split->geo, ring);
 	short		sign = 0;
 	int			vertexIdx = -1;
 	int			firstVertexIdx = -1;
 
-	SPLIT_ASSERT(ring->first && ring->first->next, "polygon ring must have at least 2 vertices");
+	SPLIT_ASSERT(numPoints >= 2, "polygon ring must have at least 2 vertices");
 
-	FOREACH_LINKED_LAT_LNG_PAIR(ring, cur, next)
+	for (int i = 0; i < numPoints; i++)
 	{
+		const FlatPoint *cur = &points[i];
+		const FlatPoint *next = &points[(i + 1) % numPoints];
 		double		lng,
 					nextLng;
 		short		nextSign;
 
 		/* Add vertex */
-		vertexIdx = split_add_vertex(split, &cur->vertex);
+		vertexIdx = split_add_vertex(split, cur);
 		if (firstVertexIdx < 0)
 			firstVertexIdx = vertexIdx;
 
-		lng = cur->vertex.lng;
-		nextLng = next->vertex.lng;
+		lng = cur->x;
+		nextLng = next->x;
 		nextSign = SIGN(nextLng);
 
 		if (sign == 0)
@@ -431,7 +423,13 @@ split_process_ring(Split * split, const LinkedGeoLoop * ring)
 			/* Add intersection after current vertex */
 			SplitIntersectDir dir = (sign < 0) ? SplitIntersectDir_WE : SplitIntersectDir_EW;
 			int			isPrime = (fabs(lng - nextLng) < M_PI);
-			double		lat = split_180_lat(&cur->vertex, &next->vertex);
+			LatLng		curLatLng,
+						nextLatLng;
+			double		lat;
+
+			flat_point_to_lat_lng(cur, &curLatLng);
+			flat_point_to_lat_lng(next, &nextLatLng);
+			lat = split_180_lat(&curLatLng, &nextLatLng);
 
 			split_add_intersect_after(split, vertexIdx, dir, isPrime, lat);
 
@@ -449,44 +447,31 @@ split_prepare(Split * split)
 	split_sort_intersects(split);
 }
 
-LinkedGeoPolygon *
-split_create_multi_polygon(Split * split)
+void
+split_create_multi_polygon(Split * split, FlatGeoPolygon * result)
 {
-	LinkedGeoPolygon *multiPolygon = NULL;
-	LinkedGeoPolygon *lastPolygon = NULL;
 	int			vertexIdxStart = 0;
 
 	while (true)
 	{
-		LinkedGeoPolygon *polygon;
-
 		/* Get next unused vertex */
 		int			vertexIdx = split_find_next_vertex(split, &vertexIdxStart);
 
 		if (vertexIdx < 0)
 			break;				/* done */
 
-		/* Create next polygon */
-		polygon = split_create_polygon_vertex(split, vertexIdx);
-
-		/* Add to result */
-		if (!multiPolygon)
-			multiPolygon = polygon;
-		else
-			lastPolygon->next = polygon;
-		lastPolygon = polygon;
+		/* Add next polygon */
+		split_create_polygon_vertex(split, vertexIdx, result);
 	}
-
-	return multiPolygon;
 }
 
 int
-split_add_vertex(Split * split, const LatLng * latlng)
+split_add_vertex(Split * split, const FlatPoint * point)
 {
 	int			idx = split->vertexNum++;
 	SplitVertex *vertex = &split->vertices[idx];
 
-	vertex->latlngPtr = latlng;
+	vertex->point = point;
 	vertex->intersectIdx = -1;
 	vertex->sign = 0;
 	vertex->link = -1;
@@ -541,9 +526,9 @@ split_link_vertices(Split * split, int idx1, int idx2)
 }
 
 void
-split_add_hole(Split * split, const LinkedGeoLoop * hole)
+split_add_hole(Split * split, int ring)
 {
-	split->holes[split->holeNum++] = hole;
+	split->holes[split->holeNum++] = ring;
 }
 
 void
@@ -609,7 +594,7 @@ split_find_next_vertex(Split * split, int *start)
 {
 	for (int i = *start; i < split->vertexNum; ++i)
 	{
-		if (split->vertices[i].latlngPtr)
+		if (split->vertices[i].point)
 		{
 			*start = i + 1;
 			return i;
@@ -618,11 +603,9 @@ split_find_next_vertex(Split * split, int *start)
 	return -1;
 }
 
-LinkedGeoPolygon *
-split_create_polygon_vertex(Split * split, int vertexIdx)
+void
+split_create_polygon_vertex(Split * split, int vertexIdx, FlatGeoPolygon * result)
 {
-	LinkedGeoPolygon *polygon;
-	LinkedGeoLoop *loop;
 	int			idx,
 				nextIdx,
 				intersectIdx;
@@ -631,20 +614,15 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 	short		sign,
 				step;
 
-	polygon = palloc0(sizeof(LinkedGeoPolygon));
-
-	loop = palloc0(sizeof(LinkedGeoLoop));
-	add_linked_geo_loop(polygon, loop);
-
 	idx = vertexIdx;
 	vertex = &split->vertices[idx];
 	sign = vertex->sign;
 	step = 1;					/* vertex array traversal direction */
-	while (vertex->latlngPtr)
+	while (vertex->point)
 	{
 		/* Add vertex */
-		add_lat_lng(loop, vertex->latlngPtr);
-		vertex->latlngPtr = NULL;
+		flat_geo_add_point(result, vertex->point);
+		vertex->point = NULL;
 
 		/*
 		 * Get indices of the other segment endpoint and potential
@@ -668,12 +646,12 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 		intersect = split_get_intersect_after(split, intersectIdx);
 		if (intersect)
 		{
-			LatLng		latlng;
+			FlatPoint	point;
 			int			intersectSortOrder;
 
 			/* Add intersection vertex */
-			split_intersect_get_lat_lng(intersect, sign, &latlng);
-			add_lat_lng(loop, &latlng);
+			split_intersect_get_point(intersect, sign, &point);
+			flat_geo_add_point(result, &point);
 
 			/* Find next intersection */
 			intersectSortOrder = (intersect->sortOrder % 2 == 0)
@@ -683,8 +661,8 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 			intersectIdx = intersect->vertexIdx;
 
 			/* Add next intersection vertex */
-			split_intersect_get_lat_lng(intersect, sign, &latlng);
-			add_lat_lng(loop, &latlng);
+			split_intersect_get_point(intersect, sign, &point);
+			flat_geo_add_point(result, &point);
 
 			/*
 			 * Does intersecting segment end in the same hemisphere where the
@@ -711,48 +689,54 @@ split_create_polygon_vertex(Split * split, int vertexIdx)
 		idx = nextIdx;
 		vertex = &split->vertices[idx];
 	}
+	flat_geo_end_ring(result);
 
 	/* Assign holes */
-	split_polygon_assign_holes(split, sign, polygon);
+	split_polygon_assign_holes(split, sign, result);
 
-	return polygon;
+	flat_geo_end_polygon(result);
 }
 
 void
-split_polygon_assign_holes(Split * split, short sign, LinkedGeoPolygon * polygon)
+split_polygon_assign_holes(Split * split, short sign, FlatGeoPolygon * result)
 {
-	const LinkedGeoLoop *outerLoop;
+	int			outerRing = result->numRings - 1;
 	Bbox3		bbox;
 
-	outerLoop = polygon->first;
-	bbox3_from_linked_loop(outerLoop, &bbox);
+	bbox3_from_flat_ring(FLAT_RING_POINTS(result, outerRing),
+						 FLAT_RING_SIZE(result, outerRing), &bbox);
 
 	for (int i = 0; i < split->holeNum; ++i)
 	{
-		const LinkedGeoLoop *hole;
+		const FlatPoint *hole;
+		int			holeSize;
 		short		pos = 0;
 
-		hole = split->holes[i];
-		if (!hole)
+		if (split->holes[i] < 0)
 			continue;
 
+		hole = FLAT_RING_POINTS(split->geo, split->holes[i]);
+		holeSize = FLAT_RING_SIZE(split->geo, split->holes[i]);
+
 		/* Check if hole vertices are inside the outher shell of the polygon */
-		FOREACH_LINKED_LAT_LNG(hole, cur)
+		for (int j = 0; j < holeSize; j++)
 		{
-			pos = lat_lng_ring_pos(outerLoop, sign, &bbox, &cur->vertex);
+			/* adding holes may move the points of the shell */
+			pos = point_ring_pos(FLAT_RING_POINTS(result, outerRing),
+								 FLAT_RING_SIZE(result, outerRing),
+								 sign, &bbox, &hole[j]);
 			if (pos != 0)
 				break;			/* vertex is either inside or outside */
 		}
 
 		if (pos != -1)
 		{
-			/* Add hole loop copy to polygon */
-			LinkedGeoLoop *hole_copy = copy_linked_geo_loop(hole);
-
-			add_linked_geo_loop(polygon, hole_copy);
+			/* Add hole to polygon */
+			flat_geo_add_points(result, hole, holeSize);
+			flat_geo_end_ring(result);
 
 			/* Remove hole from the list */
-			split->holes[i] = NULL;
+			split->holes[i] = -1;
 		}
 	}
 }
@@ -771,71 +755,54 @@ split_get_intersect_after(Split * split, int vertexIdx)
 }
 
 void
-split_intersect_get_lat_lng(const SplitIntersect * intersect, short sign, LatLng * latlng)
+split_intersect_get_point(const SplitIntersect * intersect, short sign, FlatPoint * point)
 {
-	latlng->lat = intersect->lat;
+	point->y = intersect->lat;
 	if (intersect->isPrime)
-		latlng->lng = 0.0;
+		point->x = 0.0;
 	else
-		latlng->lng = (sign > 0) ? M_PI : -M_PI;
-}
-
-int
-count_polygon_vertices(const LinkedGeoPolygon * polygon, int *ringNum)
-{
-	int			num = 0;
-
-	if (ringNum)
-		*ringNum = 0;
-
-	FOREACH_LINKED_LOOP(polygon, ring)
-	{
-		if (ringNum)
-			++(*ringNum);
-		num += count_linked_lat_lng(ring);
-	}
-	return num;
+		point->x = (sign > 0) ? M_PI : -M_PI;
 }
 
 short
-lat_lng_ring_pos(const LinkedGeoLoop * ring, short sign, const Bbox3 * bbox, const LatLng * latlng)
+point_ring_pos(const FlatPoint * ring, int numPoints, short sign, const Bbox3 * bbox, const FlatPoint * point)
 {
-	short		signLatlng;
+	short		signPoint;
 	Vect3		vect,
 				outVect;
-	LatLng		out;
+	FlatPoint	out;
 	int			intersectNum = 0;
 	Vect3		curVect,
 				nextVect;
 
 	/* Check longitude sign */
-	signLatlng = SIGN(latlng->lng);
-	if (signLatlng != 0 && signLatlng != sign)
+	signPoint = SIGN(point->x);
+	if (signPoint != 0 && signPoint != sign)
 		return -1;
 
-	vect3_from_lat_lng(latlng, &vect);
+	vect3_from_point(point, &vect);
 
 	/* Check bbox */
 	if (!bbox3_contains_vect3(bbox, &vect))
 		return -1;
 
 	/* Create a point that's guaranteed to be outside the polygon */
-	out.lng = (latlng->lng == 0) ? -sign * 1e-10 : -latlng->lng;
-	out.lat = latlng->lat;
-	vect3_from_lat_lng(&out, &outVect);
+	out.x = (point->x == 0) ? -sign * 1e-10 : -point->x;
+	out.y = point->y;
+	vect3_from_point(&out, &outVect);
 
 
 	/* Check if ring is a single vertex exactly matching the point */
-	if (!ring->first->next)
+	if (numPoints < 2)
 		return true;
 
 	/*
-	 * Count a number of intersections between the ring and (latlng, out)
+	 * Count a number of intersections between the ring and (point, out)
 	 * segment
 	 */
 	intersectNum = 0;
-	vect3_from_lat_lng(&ring->first->vertex, &curVect);
-	FOREACH_LINKED_LAT_LNG_PAIR(ring, cur, next)
+	vect3_from_point(&ring[0], &curVect);
+	for (int i = 0; i < numPoints; i++)
 	{
 		short		intersect;
 
@@ -844,7 +811,7 @@ lat_lng_ring_pos(const LinkedGeoLoop * ring, short sign, const Bbox3 * bbox, con
 			return 0;
 
 		/* Next vertex */
-		vect3_from_lat_lng(&next->vertex, &nextVect);
+		vect3_from_point(&ring[(i + 1) % numPoints], &nextVect);
 
 		if (!vect3_eq(&curVect, &nextVect))
 		{
@@ -986,21 +953,10 @@ point_segment_pos(const Vect3 * v1, const Vect3 * v2, const Vect3 * p)
 }
 
 void
-add_lat_lng(LinkedGeoLoop * loop, const LatLng * latlng)
+vect3_from_point(const FlatPoint * point, Vect3 * vect)
 {
-	LinkedLatLng *linked;
-
-	if (loop->last)
-	{
-		/* Does new vertex exactly match the last one? */
-		const LatLng *last = &loop->last->vertex;
-
-		if (last->lat == latlng->lat && last->lng == latlng->lng)
-			return;
-	}
+	LatLng		coord;
 
-	linked = palloc0(sizeof(LinkedLatLng));
-	linked->vertex.lat = latlng->lat;
-	linked->vertex.lng = latlng->lng;
-	add_linked_lat_lng(loop, linked);
+	flat_point_to_lat_lng(point, &coord);
+	vect3_from_lat_lng(&coord, vect);
 }
@@ -22,12 +22,13 @@
 #include <stdbool.h>
 
 #include "error.h"
+#include "wkb_flat_geo.h"
 
 bool
-			is_linked_polygon_crossed_by_180(const LinkedGeoPolygon * multiPolygon);
+			is_flat_geo_crossed_by_180(const FlatGeoPolygon * geo);
 
-LinkedGeoPolygon *
-			split_linked_polygon_by_180(const LinkedGeoPolygon * multiPolygon);
+void
+			split_flat_geo_by_180(const FlatGeoPolygon * geo, FlatGeoPolygon * result);
 
 double
 			split_180_lat(const LatLng * coord1, const LatLng * coord2);
@@ -27,6 +27,25 @@ SELECT h3_latlng_to_cell(:meter, :resolution) <> '8a63a9a99047fff';
 -- check back/forth conversion return same hex
 SELECT h3_latlng_to_cell(h3_cell_to_geometry(:hexagon), :resolution) = '8a63a9a99047fff';
 
+-- batch indexing of multipoints matches indexing one by one
+SELECT h3_latlng_to_cells(ST_Collect(:degree, h3_cell_to_geometry(:edgecross)), :resolution)
+    = ARRAY[:hexagon::h3index, h3_cell_to_center_child(:edgecross, :resolution)];
+SELECT h3_latlng_to_cells(:degree, :resolution) = ARRAY[:hexagon::h3index];
+SELECT h3_latlng_to_cells('MULTIPOINT EMPTY'::geometry, :resolution) = '{}';
+
+-- only points and multipoints can be indexed
+CREATE FUNCTION h3_test_postgis_latlngs_line() RETURNS boolean LANGUAGE PLPGSQL
+    AS $$
+        BEGIN
+            PERFORM h3_latlng_to_cells('LINESTRING(0 0, 1 1)'::geometry, 5);
+            RETURN false;
+        EXCEPTION WHEN invalid_parameter_value THEN
+            RETURN true;
+        END;
+    $$;
+SELECT h3_test_postgis_latlngs_line();
+DROP FUNCTION h3_test_postgis_latlngs_line;
+
 -- check num points in boundary
 SELECT ST_NPoints(h3_cell_to_boundary_geometry(:hexagon)) = 7;
 
@@ -93,6 +112,38 @@ FROM (
 ) AS q2
 WHERE ABS(ABS(ST_X(p)) - 180) < :epsilon;
 
+-- boundaries serialized in C match their EWKB, bounding boxes included
+SELECT every(ST_AsEWKB(h3_cell_to_boundary_geometry(c)) = ST_AsEWKB(h3_cell_to_boundary_wkb(c)::geometry)
+         AND Box2D(h3_cell_to_boundary_geometry(c))::text = Box2D(h3_cell_to_boundary_wkb(c)::geometry)::text
+         AND ST_SRID(h3_cell_to_boundary_geometry(c)) = 4326)
+FROM (SELECT h3_get_res_0_cells() AS c UNION ALL SELECT :hexagon UNION ALL SELECT :polar) q;
+
+SELECT every(ST_AsEWKB(h3_cell_to_boundary_geography(c)::geometry)
+             = ST_AsEWKB(h3_cell_to_boundary_wkb(c)::geography::geometry)
+         AND h3_cell_to_boundary_geography(c) && h3_cell_to_boundary_wkb(c)::geography)
+FROM (SELECT h3_get_res_0_cells() AS c UNION ALL SELECT :hexagon UNION ALL SELECT :polar) q;
+
+-- batched boundaries are those of each cell, collected in order
+WITH cells AS (
+    SELECT c, row_number() OVER () AS n
+    FROM (SELECT h3_get_res_0_cells() AS c UNION ALL SELECT :hexagon UNION ALL SELECT :polar) q
+), parts AS (
+    SELECT n, ST_Dump(h3_cell_to_boundary_geometry(c)) AS dp FROM cells
+)
+SELECT ST_AsEWKB(h3_cells_to_boundaries_geometry(array(SELECT c FROM cells ORDER BY n)))
+     = ST_AsEWKB(ST_ForceCollection(ST_Collect((dp).geom ORDER BY n, (dp).path)))
+FROM parts;
+
+-- neighbours share edges, valid in a collection but not in a multi polygon
+SELECT (ST_IsValidDetail(g)).valid AND NOT (ST_IsValidDetail(ST_CollectionExtract(g, 3))).valid
+FROM (SELECT h3_cells_to_boundaries_geometry(array(SELECT h3_grid_disk(:hexagon, 1))) AS g) q;
+
+-- nulls are ignored, and no cells give an empty collection
+SELECT ST_NumGeometries(h3_cells_to_boundaries_geometry(ARRAY[:hexagon::h3index, NULL])) = 1;
+
+SELECT ST_IsEmpty(h3_cells_to_boundaries_geometry('{}'::h3index[]))
+   AND GeometryType(h3_cells_to_boundaries_geometry('{}'::h3index[])) = 'GEOMETRYCOLLECTION';
+
 --
 -- Test h3_cells_to_multi_polygon_wkb
 --
@@ -113,6 +164,45 @@ WITH split AS (
      dp AS (SELECT ST_Dump(multi) AS dp FROM split)
 SELECT COUNT(*) = 3 FROM dp;
 
+-- split polygons are valid, closed on both sides of the antimeridian
+SELECT ST_IsValid(h3_cells_to_multi_polygon_wkb(
+    array(SELECT h3_polygon_to_cells(:transmeridianWithHoles, 4)))::geometry);
+
+SELECT ST_IsValid(h3_cells_to_multi_polygon_wkb(
+    array(SELECT h3_polygon_to_cells(:transmeridianMulti, 3)))::geometry);
+
+-- aggregates outline distinct cells, ignoring nulls
+SELECT ST_Equals(
+    h3_cells_to_multi_polygon_geometry(c),
+    h3_cells_to_multi_polygon_geometry(array(SELECT h3_polygon_to_cells(:transmeridianMulti, 3)))
+) AND ST_Equals(
+    h3_cells_to_multi_polygon_geography(c)::geometry,
+    h3_cells_to_multi_polygon_geography(array(SELECT h3_polygon_to_cells(:transmeridianMulti, 3)))::geometry
+) FROM (
+    SELECT h3_polygon_to_cells(:transmeridianMulti, 3) c
+    UNION ALL SELECT h3_polygon_to_cells(:transmeridianMulti, 3)
+    UNION ALL SELECT NULL
+) q;
+
+-- also when workers collect cells in parallel, each cell being collected
+-- twice, so the leader must drop duplicates sent by different workers
+CREATE TABLE h3_test_multi_polygon_agg WITH (parallel_workers = 2) AS
+    SELECT h3_polygon_to_cells(:with2holes, 11) c
+    UNION ALL SELECT h3_polygon_to_cells(:with2holes, 11);
+SET parallel_setup_cost = 0;
+SET parallel_tuple_cost = 0;
+SET min_parallel_table_scan_size = 0;
+EXPLAIN (COSTS OFF) SELECT h3_cells_to_multi_polygon_geometry(c) FROM h3_test_multi_polygon_agg;
+SELECT h3_cells_to_multi_polygon_geometry(c) AS outline FROM h3_test_multi_polygon_agg \gset
+SELECT ST_Equals(
+    :'outline'::geometry,
+    h3_cells_to_multi_polygon_geometry(array(SELECT h3_polygon_to_cells(:with2holes, 11)))
+);
+RESET parallel_setup_cost;
+RESET parallel_tuple_cost;
+RESET min_parallel_table_scan_size;
+DROP TABLE h3_test_multi_polygon_agg;
+
 -- h3_polygon_to_cells_experimental
 SELECT COUNT(*) = 48 FROM (
     SELECT h3_polygon_to_cells_experimental(:with2holes, 10, 'center')
@@ -122,6 +212,58 @@ SELECT COUNT(*) = 76 FROM (
     SELECT h3_polygon_to_cells_experimental(:with2holes, 10, 'overlapping')
 ) q;
 
+-- geometry polyfill reads the polygons from WKB, matching the polygon variant
+SELECT array(SELECT h3_polygon_to_cells(:with2holes, 10) c ORDER BY c)
+     = array(SELECT h3_polygon_to_cells(
+            ST_MakePolygon(ST_ExteriorRing(:with2holes))::polygon,
+            ARRAY[ST_MakePolygon(ST_InteriorRingN(:with2holes, 1))::polygon,
+                  ST_MakePolygon(ST_InteriorRingN(:with2holes, 2))::polygon],
+            10) c ORDER BY c);
+
+-- either byte order, with SRID and z
+SELECT array(SELECT h3_polygon_wkb_to_cells(ST_AsBinary(:with2holes, 'XDR'), 10) c ORDER BY c)
+     = array(SELECT h3_polygon_wkb_to_cells(ST_AsBinary(:with2holes, 'NDR'), 10) c ORDER BY c);
+
+SELECT COUNT(*) = 48 FROM (
+    SELECT h3_polygon_to_cells(ST_Force3DZ(ST_SetSRID(:with2holes, 4326)), 10)
+) q;
+
+-- polygons of collections are filled one after another
+SELECT COUNT(*) = 96 FROM (
+    SELECT h3_polygon_to_cells(ST_ForceCollection(ST_Collect(:with2holes, :with2holes)), 10)
+) q;
+
+-- nothing to fill
+SELECT COUNT(*) = 0 FROM (
+    SELECT h3_polygon_to_cells('POLYGON EMPTY'::geometry, 10)
+    UNION ALL SELECT h3_polygon_to_cells(NULL::geometry, 10)
+) q;
+
+-- null containment mode fills nothing
+SELECT COUNT(*) = 0 FROM (
+    SELECT h3_polygon_to_cells_experimental(:with2holes, 10, NULL)
+) q;
+-- points and lines of collections are skipped
+SELECT COUNT(*) = 48 FROM (
+    SELECT h3_polygon_to_cells(ST_Collect(ARRAY[
+        'POINT(0 0)'::geometry, 'LINESTRING(0 0, 1 1)', 'MULTIPOINT(0 0, 1 1)',
+        'MULTILINESTRING((0 0, 1 1), (2 2, 3 3))', :with2holes
+    ]), 10)
+) q;
+
+-- only polygons can be filled
+CREATE FUNCTION h3_test_postgis_polyfill_line() RETURNS boolean LANGUAGE PLPGSQL
+    AS $$
+        BEGIN
+            PERFORM h3_polygon_to_cells('LINESTRING(0 0, 1 1)'::geometry, 5);
+            RETURN false;
+        EXCEPTION WHEN invalid_parameter_value THEN
+            RETURN true;
+        END;
+    $$;
+SELECT h3_test_postgis_polyfill_line();
+DROP FUNCTION h3_test_postgis_polyfill_line;
+
 --
 -- test h3_get_resolution_from_tile_zoom
 --
@@ -171,3 +313,182 @@ SELECT h3_get_resolution_from_tile_zoom(12, 8, 0, 5, 512) = 8;
 SELECT h3_get_resolution_from_tile_zoom(13, 8, 0, 5, 512) = 8;
 SELECT h3_get_resolution_from_tile_zoom(14, 8, 0, 5, 512) = 8;
 SELECT h3_get_resolution_from_tile_zoom(15, 8, 0, 5, 512) = 8;
+
+--
+-- Test h3_cells_to_mvt
+--
+
+-- no cells, or cells outside the tile, give an empty tile
+SELECT h3_cells_to_mvt(c, 14, 10725, 7614) = ''::bytea
+FROM (SELECT :hexagon::h3index AS c WHERE false) q;
+
+SELECT h3_cells_to_mvt(:hexagon::h3index, 14, 10725, 7616) = ''::bytea;
+
+-- one layer h3 of version 2 and extent 4096, with the index as id of a polygon
+WITH tile AS (SELECT h3_cells_to_mvt(:hexagon::h3index, 14, 10725, 7614) AS m)
+SELECT get_byte(m, 0) = 26
+   AND position('\x78020a026833'::bytea IN m) > 0
+   AND position('\x08ffff91c8a9d38ed308'::bytea IN m) > 0
+   AND position('\x1803'::bytea IN m) > 0
+   AND substring(m FROM length(m) - 2) = '\x288020'::bytea
+FROM tile;
+
+-- values become properties, and null cells are ignored
+WITH tile AS (
+    SELECT h3_cells_to_mvt(c, v, 14, 10725, 7614) AS m
+    FROM (VALUES (:hexagon::h3index, 1.5), (NULL, 2), (:hexagon::h3index, NULL)) q(c, v)
+)
+SELECT position('\x1a0576616c7565'::bytea IN m) > 0
+   AND position('\x22091900000000000000f83f'::bytea IN m) > 0
+   AND position('\x0000000000000040'::bytea IN m) = 0
+FROM tile;
+
+-- layers can be named, with another extent
+WITH tile AS (SELECT h3_cells_to_mvt(:hexagon::h3index, NULL, 14, 10725, 7614, 256, 0, 'cells') AS m)
+SELECT position('\x0a0563656c6c73'::bytea IN m) > 0
+   AND substring(m FROM length(m) - 2) = '\x288002'::bytea
+FROM tile;
+
+-- the layer name must be the same for all rows
+CREATE FUNCTION h3_test_mvt_layer_names() RETURNS boolean LANGUAGE PLPGSQL
+    AS $$
+        BEGIN
+            PERFORM h3_cells_to_mvt(c, NULL, 14, 10725, 7614, 4096, 256, n)
+            FROM (VALUES ('8a63a9a99047fff'::h3index, 'cells'), ('8a63a9a99047fff', 'other')) q(c, n);
+            RETURN false;
+        EXCEPTION WHEN invalid_parameter_value THEN
+            RETURN true;
+        END;
+    $$;
+SELECT h3_test_mvt_layer_names();
+DROP FUNCTION h3_test_mvt_layer_names;
+
+-- decodes the tile, giving the id of each feature and its rings in tile coordinates
+CREATE FUNCTION h3_test_mvt_varint(message bytea, INOUT pos integer, OUT value bigint)
+LANGUAGE PLPGSQL AS $$
+    DECLARE
+        shift integer := 0;
+        b integer;
+    BEGIN
+        value := 0;
+        LOOP
+            b := get_byte(message, pos);
+            pos := pos + 1;
+            value := value | ((b & 127)::bigint << shift);
+            shift := shift + 7;
+            EXIT WHEN b < 128;
+        END LOOP;
+    END;
+$$;
+
+CREATE FUNCTION h3_test_mvt_fields(message bytea)
+RETURNS TABLE (field integer, value bigint, bytes bytea)
+LANGUAGE PLPGSQL AS $$
+    DECLARE
+        pos integer := 0;
+        key bigint;
+    BEGIN
+        WHILE pos < length(message) LOOP
+            SELECT * INTO pos, key FROM h3_test_mvt_varint(message, pos);
+            field := key >> 3;
+            value := NULL;
+            bytes := NULL;
+            CASE key & 7
+                WHEN 0 THEN
+                    SELECT * INTO pos, value FROM h3_test_mvt_varint(message, pos);
+                WHEN 1 THEN
+                    bytes := substring(message FROM pos + 1 FOR 8);
+                    pos := pos + 8;
+                WHEN 2 THEN
+                    SELECT * INTO pos, value FROM h3_test_mvt_varint(message, pos);
+                    bytes := substring(message FROM pos + 1 FOR value::integer);
+                    pos := pos + value::integer;
+            END CASE;
+            RETURN NEXT;
+        END LOOP;
+    END;
+$$;
+
+CREATE FUNCTION h3_test_mvt_rings(tile bytea)
+RETURNS TABLE (id bigint, ring geometry)
+LANGUAGE PLPGSQL AS $$
+    DECLARE
+        feature bytea;
+        commands bytea;
+        pos integer;
+        command bigint;
+        param bigint;
+        x bigint;
+        y bigint;
+        points geometry[];
+    BEGIN
+        FOR feature IN
+            SELECT f.bytes
+            FROM h3_test_mvt_fields(tile) l, h3_test_mvt_fields(l.bytes) f
+            WHERE l.field = 3 AND f.field = 2
+        LOOP
+            SELECT f.value INTO id FROM h3_test_mvt_fields(feature) f WHERE f.field = 1;
+            SELECT f.bytes INTO commands FROM h3_test_mvt_fields(feature) f WHERE f.field = 4;
+            pos := 0;
+            x := 0;
+            y := 0;
+            WHILE pos < length(commands) LOOP
+                SELECT * INTO pos, command FROM h3_test_mvt_varint(commands, pos);
+                IF command & 7 = 7 THEN
+                    ring := ST_MakeLine(points || points[1]);
+                    RETURN NEXT;
+                    CONTINUE;
+                END IF;
+                IF command & 7 = 1 THEN
+                    points := '{}';
+                END IF;
+                FOR i IN 1 .. command >> 3 LOOP
+                    SELECT * INTO pos, param FROM h3_test_mvt_varint(commands, pos);
+                    x := x + ((param >> 1) # -(param & 1));
+                    SELECT * INTO pos, param FROM h3_test_mvt_varint(commands, pos);
+                    y := y + ((param >> 1) # -(param & 1));
+                    points := points || ST_MakePoint(x, y);
+                END LOOP;
+            END LOOP;
+        END LOOP;
+    END;
+$$;
+
+-- cells are clipped to the tile and its buffer, larger ones to the buffer
+-- itself, and split by the 180th meridian or cut where Web Mercator ends
+\set transmeridian '\'845ba5dffffffff\'::h3index'
+CREATE TABLE h3_test_mvt AS
+SELECT c, z, x, y, expected, h3_cells_to_mvt(c, z, x, y) AS m
+FROM (VALUES
+    (:hexagon::h3index, 14, 10725, 7614,
+     'LINESTRING(2112 917,2151 1013,2086 1113,1983 1117,1944 1020,2008 920,2112 917)'),
+    (h3_cell_to_parent(:hexagon::h3index, 0), 14, 10725, 7614,
+     'LINESTRING(-256 4352,-256 -256,4352 -256,4352 4352,-256 4352)'),
+    (:transmeridian, 7, 0, 60,
+     'LINESTRING(163 1992,0 1771,0 1710,134 1460,471 1423,653 1670,499 1954,163 1992)'),
+    (:transmeridian, 7, 127, 60,
+     'LINESTRING(4096 1771,4077 1746,4096 1710,4096 1771)'),
+    (:polar, 3, 0, 7,
+     'LINESTRING(4352 4096,0 4096,0 3530,1903 2190,4352 1987,4352 4096)')
+) q(c, z, x, y, expected)
+GROUP BY c, z, x, y, expected;
+
+-- one ring each, the expected one, with the index as id
+SELECT count(*) = 5
+   AND every(d.id = t.c::bigint AND ST_AsText(d.ring) = t.expected)
+FROM h3_test_mvt t, h3_test_mvt_rings(t.m) d;
+
+-- close to the geometry ST_AsMVTGeom finds, wound the same way
+SELECT every(ST_HausdorffDistance(ST_MakePolygon(d.ring), g.geom) < 2
+         AND ST_IsPolygonCCW(ST_MakePolygon(d.ring))
+         AND ST_IsPolygonCCW(g.geom))
+FROM h3_test_mvt t, h3_test_mvt_rings(t.m) d,
+     LATERAL (SELECT ST_SetSRID(ST_AsMVTGeom(
+         ST_Transform(ST_ClipByBox2D(h3_cell_to_boundary_geometry(t.c),
+                                     'BOX(-180 -85.0511,180 85.0511)'::box2d), 3857),
+         ST_TileEnvelope(t.z, t.x, t.y)), 0) AS geom) g;
+
+DROP TABLE h3_test_mvt;
+DROP FUNCTION h3_test_mvt_rings;
+DROP FUNCTION h3_test_mvt_fields;
+DROP FUNCTION h3_test_mvt_varint;
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <postgres.h>
+
+#if POSTGRESQL_VERSION_MAJOR >= 16
+#include "varatt.h" //VAR_SIZE and friends moved to here from postgres.h
+#endif
+
+#include <h3api.h>
+
+#include "cell_buffer.h"
+
+H3CellBuffer *
+cell_buffer_create(MemoryContext context, int64 capacity, CellBufferReduce reduce)
+{
+	H3CellBuffer *buffer = MemoryContextAlloc(context, sizeof(H3CellBuffer));
+
+	buffer->count = 0;
+	buffer->capacity = Max(capacity, CELL_BUFFER_MIN_CAPACITY);
+	buffer->cells = MemoryContextAllocHuge(context, buffer->capacity * sizeof(H3Index));
+	buffer->reduce = reduce;
+	return buffer;
+}
+
+void
+cell_buffer_reduce(H3CellBuffer * buffer)
+{
+	if (buffer->reduce != NULL)
+		buffer->count = buffer->reduce(buffer->cells, buffer->count);
+}
+
+void
+cell_buffer_append(H3CellBuffer * buffer, const H3Index * cells, int64 count)
+{
+	int64		capacity = buffer->capacity;
+
+	if (buffer->count + count > buffer->capacity)
+	{
+		cell_buffer_reduce(buffer);
+
+		while (buffer->count + count > capacity / 2)
+			capacity *= 2;
+
+		if (capacity != buffer->capacity)
+		{
+			buffer->cells = repalloc_huge(buffer->cells, capacity * sizeof(H3Index));
+			buffer->capacity = capacity;
+		}
+	}
+
+	memcpy(buffer->cells + buffer->count, cells, count * sizeof(H3Index));
+	buffer->count += count;
+}
+
+bytea *
+cell_buffer_serialize(H3CellBuffer * buffer)
+{
+	Size		size;
+	bytea	   *result;
+
+	cell_buffer_reduce(buffer);
+
+	size = buffer->count * sizeof(H3Index);
+	result = palloc(VARHDRSZ + size);
+	SET_VARSIZE(result, VARHDRSZ + size);
+	memcpy(VARDATA(result), buffer->cells, size);
+
+	return result;
+}
+
+H3CellBuffer *
+cell_buffer_deserialize(bytea * bytes, CellBufferReduce reduce)
+{
+	int64		count = VARSIZE_ANY_EXHDR(bytes) / sizeof(H3Index);
+	H3CellBuffer *buffer = cell_buffer_create(CurrentMemoryContext, count, reduce);
+
+	memcpy(buffer->cells, VARDATA_ANY(bytes), count * sizeof(H3Index));
+	buffer->count = count;
+
+	return buffer;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef H3_CELL_BUFFER_H
+#define H3_CELL_BUFFER_H
+
+#include <h3api.h>
+
+/* Reduces cells in place without changing the set, returning the new count */
+typedef int64 (*CellBufferReduce) (H3Index * cells, int64 count);
+
+/* smallest capacity of a buffer */
+#define CELL_BUFFER_MIN_CAPACITY 1024
+
+/*
+ * Growable buffer of cells, used as the transition state of aggregates. The
+ * cells are reduced (compacted, deduplicated) whenever it fills up, and it is
+ * grown only if that frees less than half of it. Without a reduce function
+ * the buffer just grows.
+ */
+typedef struct
+{
+	H3Index    *cells;
+	int64		count;
+	int64		capacity;
+	CellBufferReduce reduce;
+}	H3CellBuffer;
+
+H3CellBuffer *cell_buffer_create(MemoryContext context, int64 capacity, CellBufferReduce reduce);
+
+/* Reduces the cells of the buffer in place */
+void		cell_buffer_reduce(H3CellBuffer * buffer);
+
+/* Appends count cells, reducing or growing the buffer first if full */
+void		cell_buffer_append(H3CellBuffer * buffer, const H3Index * cells, int64 count);
+
+/* Reduced cells of the buffer, so workers only send what is needed */
+bytea	   *cell_buffer_serialize(H3CellBuffer * buffer);
+
+/* Buffer of serialized cells, in the current memory context */
+H3CellBuffer *cell_buffer_deserialize(bytea * bytes, CellBufferReduce reduce);
+
+#endif							/* H3_CELL_BUFFER_H */
@@ -5,4 +5,7 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+/* authalic earth radius used by H3 */
+#define EARTH_RADIUS_KM 6371.007180918475
+
 #endif /* H3_CONSTANTS_H */
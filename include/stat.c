@@ -0,0 +1,222 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <postgres.h>
+
+#include <access/xact.h>			// RegisterXactCallback
+#include <funcapi.h>				// FuncCallContext
+#include <nodes/execnodes.h>		// ReturnSetInfo
+#include <portability/instr_time.h> // INSTR_TIME_SET_CURRENT
+
+#include "stat.h"
+
+/* sets being returned at once, more are counted but not timed as a whole */
+#define STAT_INVOCATIONS 16
+
+typedef struct
+{
+	FmgrInfo   *flinfo;			/* NULL if free */
+	double		ms;
+}	StatInvocation;
+
+const char *stat_function_names[H3_STAT_FUNCTIONS] = {
+	"polyfill",
+	"children",
+	"disk",
+	"dissolve",
+	"wkb"
+};
+
+static void **rendezvous = NULL;
+static H3StatCounters pending[H3_STAT_FUNCTIONS];
+static bool has_pending = false;
+static bool registered = false;
+static StatInvocation invocations[STAT_INVOCATIONS];
+
+static void
+stat_xact_callback(XactEvent event, void *arg)
+{
+	switch (event)
+	{
+		case XACT_EVENT_COMMIT:
+		case XACT_EVENT_ABORT:
+		case XACT_EVENT_PARALLEL_COMMIT:
+		case XACT_EVENT_PARALLEL_ABORT:
+			stat_flush();
+			/* sets not returned to the end are forgotten */
+			memset(invocations, 0, sizeof(invocations));
+			break;
+		default:
+			break;
+	}
+}
+
+/* Shared state if tracking, NULL otherwise */
+static H3StatState *
+stat_state(void)
+{
+	H3StatState *state;
+
+	if (rendezvous == NULL)
+		rendezvous = find_rendezvous_variable(H3_STAT_RENDEZVOUS);
+
+	state = *rendezvous;
+	if (state == NULL || state->shared == NULL || !*state->enabled)
+		return NULL;
+
+	if (!registered)
+	{
+		RegisterXactCallback(stat_xact_callback, NULL);
+		registered = true;
+	}
+	return state;
+}
+
+/* Timing of a set, begun on its first call */
+static StatInvocation *
+stat_invocation(FmgrInfo *flinfo, bool first)
+{
+	StatInvocation *free = NULL;
+
+	for (int i = 0; i < STAT_INVOCATIONS; i++)
+	{
+		if (invocations[i].flinfo == flinfo)
+		{
+			if (first)
+				invocations[i].ms = 0;
+			return &invocations[i];
+		}
+		if (free == NULL && invocations[i].flinfo == NULL)
+			free = &invocations[i];
+	}
+
+	if (first && free != NULL)
+	{
+		free->flinfo = flinfo;
+		free->ms = 0;
+		return free;
+	}
+	return NULL;
+}
+
+static Datum
+stat_measure(H3StatFunction function, PGFunction body, FunctionCallInfo fcinfo, bool count)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	H3StatCounters *counters = &pending[function];
+	instr_time	start;
+	instr_time	duration;
+	bool		first;
+	double		ms;
+	Datum		result;
+
+	if (stat_state() == NULL)
+		return body(fcinfo);
+
+	/* the set is begun if the function keeps a context */
+	first = fcinfo->flinfo->fn_extra == NULL;
+
+	INSTR_TIME_SET_CURRENT(start);
+	result = body(fcinfo);
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+	ms = INSTR_TIME_GET_MILLISEC(duration);
+
+	counters->total_ms += ms;
+	has_pending = true;
+
+	if (!count)
+		return result;
+
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+	{
+		counters->calls++;
+		counters->rows++;
+		counters->max_ms = Max(counters->max_ms, ms);
+	}
+	else
+	{
+		StatInvocation *invocation = stat_invocation(fcinfo->flinfo, first);
+
+		if (first)
+			counters->calls++;
+		if (invocation != NULL)
+			invocation->ms += ms;
+
+		if (rsinfo->isDone == ExprMultipleResult)
+		{
+			counters->rows++;
+#if POSTGRESQL_VERSION_MAJOR >= 13
+			{
+				FuncCallContext *funcctx = fcinfo->flinfo->fn_extra;
+				int64		memory = MemoryContextMemAllocated(funcctx->multi_call_memory_ctx, true);
+
+				counters->peak_memory = Max(counters->peak_memory, memory);
+			}
+#endif
+		}
+		else if (invocation != NULL)
+		{
+			counters->max_ms = Max(counters->max_ms, invocation->ms);
+			invocation->flinfo = NULL;
+		}
+	}
+
+	return result;
+}
+
+Datum
+stat_call(H3StatFunction function, PGFunction body, FunctionCallInfo fcinfo)
+{
+	return stat_measure(function, body, fcinfo, true);
+}
+
+Datum
+stat_time(H3StatFunction function, PGFunction body, FunctionCallInfo fcinfo)
+{
+	return stat_measure(function, body, fcinfo, false);
+}
+
+void
+stat_flush(void)
+{
+	H3StatState *state;
+
+	if (!has_pending || rendezvous == NULL)
+		return;
+
+	state = *rendezvous;
+	if (state != NULL && state->shared != NULL)
+	{
+		H3StatShared *shared = state->shared;
+
+		SpinLockAcquire(&shared->mutex);
+		for (int i = 0; i < H3_STAT_FUNCTIONS; i++)
+		{
+			H3StatCounters *counters = &shared->counters[i];
+
+			counters->calls += pending[i].calls;
+			counters->total_ms += pending[i].total_ms;
+			counters->max_ms = Max(counters->max_ms, pending[i].max_ms);
+			counters->rows += pending[i].rows;
+			counters->peak_memory = Max(counters->peak_memory, pending[i].peak_memory);
+		}
+		SpinLockRelease(&shared->mutex);
+	}
+
+	memset(pending, 0, sizeof(pending));
+	has_pending = false;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 Zacharias Knudsen
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef H3_STAT_H
+#define H3_STAT_H
+
+#include <fmgr.h>				// PGFunction
+#include <storage/spin.h>		// slock_t
+#include <utils/timestamp.h>	// TimestampTz
+
+/*
+ * Runtime statistics of the functions below, shared by h3 and h3_postgis.
+ *
+ * Statistics are kept in shared memory, which h3 allocates when loaded by
+ * shared_preload_libraries. Each library counts locally, adding to shared
+ * memory at the end of each transaction. The state is found by the name
+ * H3_STAT_RENDEZVOUS (see find_rendezvous_variable), so h3_postgis can
+ * count without linking to h3.
+ */
+typedef enum
+{
+	H3_STAT_POLYFILL,
+	H3_STAT_CHILDREN,
+	H3_STAT_DISK,
+	H3_STAT_DISSOLVE,
+	H3_STAT_WKB,
+	H3_STAT_FUNCTIONS			/* number of functions */
+}	H3StatFunction;
+
+#define H3_STAT_RENDEZVOUS "h3_stat_functions"
+
+typedef struct
+{
+	int64		calls;
+	double		total_ms;
+	double		max_ms;			/* of a single call, all rows of a set */
+	int64		rows;
+	int64		peak_memory;	/* of multi_call_memory_ctx */
+}	H3StatCounters;
+
+typedef struct
+{
+	slock_t		mutex;
+	TimestampTz reset;
+	H3StatCounters counters[H3_STAT_FUNCTIONS];
+}	H3StatShared;
+
+typedef struct
+{
+	bool	   *enabled;		/* h3.track_functions */
+	H3StatShared *shared;		/* NULL unless preloaded */
+}	H3StatState;
+
+/* Calls body, counting it as function if tracking */
+Datum		stat_call(H3StatFunction function, PGFunction body, FunctionCallInfo fcinfo);
+
+/* Calls body, adding to the time of function but not counting it */
+Datum		stat_time(H3StatFunction function, PGFunction body, FunctionCallInfo fcinfo);
+
+/* Adds statistics counted locally to shared memory */
+void		stat_flush(void);
+
+extern const char *stat_function_names[H3_STAT_FUNCTIONS];
+
+/* Publishes the state and requests shared memory, by h3 only */
+void		_stat_init(void);
+
+#endif /* H3_STAT_H */